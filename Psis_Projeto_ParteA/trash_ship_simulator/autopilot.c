@@ -0,0 +1,150 @@
+#include "autopilot.h"
+#include <math.h>
+#include <stdio.h>
+
+#define AVOID_RANGE 6   // pixels beyond collision distance a planet starts to be avoided
+
+void autopilot_init(autopilot *pilot) {
+    pilot->count = 0;
+}
+
+// Lowest free id no player can ask for. Bots are spawned in the same order
+// on every shard, so they get the same ids everywhere.
+static ship_id free_bot_id(universe_data *universe) {
+    ship_id id = SHIP_ID_FIRST_BOT;
+    while (universe_find_ship(universe, id) != -1) {
+        id++;
+    }
+    return id;
+}
+
+int autopilot_spawn(autopilot *pilot, universe_data *universe) {
+    if (universe->num_ships >= universe->max_ships) {
+        return -1;
+    }
+    ship_id id = free_bot_id(universe);
+    float x, y;
+    if (chose_position(universe, &x, &y, SHIP_RADIUS,
+                                   universe->universe_width, universe->universe_height) != 0) {
+        return -1;
+    }
+
+    int index = universe_add_ship(universe, x, y, id);
+    if (index < 0) {
+        return -1;
+    }
+    pilot->count++;
+    return index;
+}
+
+bool autopilot_is_bot(const autopilot *pilot, ship_id id) {
+    (void)pilot;
+    return ship_id_is_bot(id);
+}
+
+// The newest bot, the highest id
+ship_id autopilot_pick_bot(const autopilot *pilot, const universe_data *universe) {
+    ship_id bot = SHIP_ID_NONE;
+    if (pilot->count == 0) {
+        return bot;
+    }
+    for (int i = 0; i < universe->num_ships; i++) {
+        ship_id id = universe->ships[i].id;
+        if (ship_id_is_bot(id) && id > bot) {
+            bot = id;
+        }
+    }
+    return bot;
+}
+
+// Callers adopt a bot once per ship added and forget it once per ship removed
+void autopilot_adopt(autopilot *pilot, ship_id id) {
+    if (ship_id_is_bot(id)) {
+        pilot->count++;
+    }
+}
+
+void autopilot_forget(autopilot *pilot, ship_id id) {
+    if (ship_id_is_bot(id) && pilot->count > 0) {
+        pilot->count--;
+    }
+}
+
+// A planet other than the recycling one close ahead of the ship, -1 if none.
+// One the target itself is next to is not avoided, or it could never be reached.
+static int planet_in_the_way(universe_data *universe, const ship_structure *ship,
+                             float dir_x, float dir_y, float target_x, float target_y) {
+    float range = ship->radius + CENTER_RADIUS + AVOID_RANGE;
+    for (int i = 0; i < universe->num_planets; i++) {
+        planet_structure *planet = &universe->planets[i];
+        float to_x = planet->x - ship->x;
+        float to_y = planet->y - ship->y;
+        if (planet->is_recycling || to_x * to_x + to_y * to_y >= range * range ||
+            to_x * dir_x + to_y * dir_y <= 0) {
+            continue;
+        }
+        if (calculate_distance(planet->x, planet->y, target_x, target_y) < range) {
+            continue;
+        }
+        return i;
+    }
+    return -1;
+}
+
+// -1, 0 or 1 along one axis of the closest of the eight directions
+static int step_along(float component, float length) {
+    if (component > 0.38f * length) return 1;   // sin(22.5 degrees)
+    if (component < -0.38f * length) return -1;
+    return 0;
+}
+
+void autopilot_steer(const autopilot *pilot, universe_data *universe, move_batch *moves) {
+    if (pilot->count == 0) {
+        return;
+    }
+    planet_structure *recycling = universe_get_planet(universe, universe->recycling_planet_index);
+
+    for (int i = 0; i < universe->num_ships; i++) {
+        ship_structure *ship = &universe->ships[i];
+        if (!ship_id_is_bot(ship->id)) continue;
+
+        float target_x, target_y;
+        int trash = ship->num_trash < universe->ship_capacity
+                    ? universe_nearest_trash(universe, ship->x, ship->y) : -1;
+        if (trash != -1) {
+            target_x = universe->trash[trash].x;
+            target_y = universe->trash[trash].y;
+        } else if (ship->num_trash > 0 && recycling) {
+            // The flow field already goes around the other planets
+            int dx, dy;
+            if (universe_recycling_step(universe, ship->x, ship->y, &dx, &dy)) {
+                move_batch_add_step(moves, i, dx, dy);
+                continue;
+            }
+            target_x = recycling->x;
+            target_y = recycling->y;
+        } else {
+            continue;  // empty and nothing to collect
+        }
+
+        float dir_x = target_x - ship->x;
+        float dir_y = target_y - ship->y;
+
+        // Cargo is lost on any other planet: slide around it along its
+        // tangent, on the side of the target
+        int planet = ship->num_trash > 0
+                     ? planet_in_the_way(universe, ship, dir_x, dir_y, target_x, target_y) : -1;
+        if (planet != -1) {
+            float to_x = universe->planets[planet].x - ship->x;
+            float to_y = universe->planets[planet].y - ship->y;
+            float side = to_x * dir_y - to_y * dir_x;
+            dir_x = side >= 0 ? -to_y : to_y;
+            dir_y = side >= 0 ? to_x : -to_x;
+        }
+
+        float length = sqrtf(dir_x * dir_x + dir_y * dir_y);
+        int dx = length < 0.5f ? 1 : step_along(dir_x, length);
+        int dy = length < 0.5f ? 0 : step_along(dir_y, length);
+        move_batch_add_step(moves, i, dx, dy);
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef AUTOPILOT_H
+#define AUTOPILOT_H
+
+#include <stdbool.h>
+#include "universe-data.h"
+
+// Ships flown by the server, to soak test it and to fill the universe when
+// few players are around. Every tick each bot takes one step toward the
+// nearest trash or, once its cargo is full (or no trash is left), toward the
+// recycling planet along the universe's flow field, going around the other
+// planets on the way. Bots use
+// ship ids players never ask for, from SHIP_ID_FIRST_BOT up (see ship-id.h).
+typedef struct {
+    int count;
+} autopilot;
+
+void autopilot_init(autopilot *pilot);
+
+// Add a bot at a free position
+// Returns its ship index, or -1 if there is no slot or room left
+int autopilot_spawn(autopilot *pilot, universe_data *universe);
+
+bool autopilot_is_bot(const autopilot *pilot, ship_id id);
+
+// Id of a bot to give up its place to a player, SHIP_ID_NONE if there are no bots
+ship_id autopilot_pick_bot(const autopilot *pilot, const universe_data *universe);
+
+// A bot handed over by another shard (see shard-map.h)
+void autopilot_adopt(autopilot *pilot, ship_id id);
+
+// The ship is gone, its id is free again
+void autopilot_forget(autopilot *pilot, ship_id id);
+
+// Add this tick's step of every bot to moves
+void autopilot_steer(const autopilot *pilot, universe_data *universe, move_batch *moves);
+
+#endif // AUTOPILOT_H
@@ -2,6 +2,35 @@
 #include <libconfig.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+// Read a list of zmq endpoints, a missing list means the default endpoint
+// Returns 0 on success, -1 on error
+static int read_endpoints(config_t *cfg, const char *name, const char *default_endpoint,
+                          char endpoints[MAX_ENDPOINTS][ENDPOINT_LEN], int *num_endpoints) {
+    *num_endpoints = 0;
+    config_setting_t *list = config_lookup(cfg, name);
+    if (list != NULL) {
+        int count = config_setting_length(list);
+        if (count > MAX_ENDPOINTS) {
+            fprintf(stderr, "Error: At most %d %s are supported\n", MAX_ENDPOINTS, name);
+            return -1;
+        }
+        for (int i = 0; i < count; i++) {
+            const char *endpoint = config_setting_get_string_elem(list, i);
+            if (endpoint == NULL || strlen(endpoint) >= ENDPOINT_LEN) {
+                fprintf(stderr, "Error: Invalid endpoint at position %d of %s\n", i, name);
+                return -1;
+            }
+            strcpy(endpoints[(*num_endpoints)++], endpoint);
+        }
+    }
+    if (*num_endpoints == 0) {
+        strcpy(endpoints[0], default_endpoint);
+        *num_endpoints = 1;
+    }
+    return 0;
+}
 
 int load_config(const char *filename, universe_config *config) {
     config_t cfg;
@@ -66,6 +95,52 @@ int load_config(const char *filename, universe_config *config) {
         return -1;
     }
 
+    // Read ship_idle_timeout (optional)
+    config->ship_idle_timeout = DEFAULT_SHIP_IDLE_TIMEOUT;
+    config_lookup_int(&cfg, "ship_idle_timeout", &config->ship_idle_timeout);
+
+    // Read tick_rate (optional)
+    config->tick_rate = DEFAULT_TICK_RATE;
+    config_lookup_int(&cfg, "tick_rate", &config->tick_rate);
+
+    // Read server_endpoints (optional, defaults to TCP on port 5555)
+    if (read_endpoints(&cfg, "server_endpoints", DEFAULT_SERVER_ENDPOINT,
+                       config->server_endpoints, &config->num_server_endpoints) != 0) {
+        config_destroy(&cfg);
+        return -1;
+    }
+
+    // Read update_endpoints (optional, defaults to TCP on port 5556)
+    if (read_endpoints(&cfg, "update_endpoints", DEFAULT_UPDATE_ENDPOINT,
+                       config->update_endpoints, &config->num_update_endpoints) != 0) {
+        config_destroy(&cfg);
+        return -1;
+    }
+
+    // Read interest_radius (optional)
+    config->interest_radius = DEFAULT_INTEREST_RADIUS;
+    config_lookup_int(&cfg, "interest_radius", &config->interest_radius);
+
+    // Read bots (optional)
+    config->bots = 0;
+    config_lookup_int(&cfg, "bots", &config->bots);
+
+    // Read shards and seed (optional)
+    config->shards = 1;
+    config_lookup_int(&cfg, "shards", &config->shards);
+    config->seed = 0;
+    config_lookup_int(&cfg, "seed", &config->seed);
+
+    // Read move threads (optional)
+    config->move_threads = 0;
+    config_lookup_int(&cfg, "move_threads", &config->move_threads);
+
+    // Read the staged pipeline settings (optional)
+    config->pipeline = 0;
+    config_lookup_bool(&cfg, "pipeline", &config->pipeline);
+    config->pipeline_core = 0;
+    config_lookup_int(&cfg, "pipeline_core", &config->pipeline_core);
+
     // Validate values
     if (config->universe_width <= 0 || config->universe_height <= 0) {
         fprintf(stderr, "Error: Universe dimensions must be positive\n");
@@ -103,6 +178,61 @@ int load_config(const char *filename, universe_config *config) {
         return -1;
     }
 
+    if (config->tick_rate < 1 || config->tick_rate > 1000) {
+        fprintf(stderr, "Error: Tick rate must be between 1 and 1000\n");
+        config_destroy(&cfg);
+        return -1;
+    }
+
+    if (config->interest_radius <= 0) {
+        fprintf(stderr, "Error: Interest radius must be positive\n");
+        config_destroy(&cfg);
+        return -1;
+    }
+
+    if (config->max_ships < 1 || config->max_ships > MAX_SHIPS) {
+        fprintf(stderr, "Error: Max ships must be between 1 and %d\n", MAX_SHIPS);
+        config_destroy(&cfg);
+        return -1;
+    }
+
+    if (config->bots < 0 || config->bots > config->max_ships) {
+        fprintf(stderr, "Error: Bots must be between 0 and max_ships\n");
+        config_destroy(&cfg);
+        return -1;
+    }
+
+    if (config->shards < 1 || config->shards > MAX_SHARDS || config->shards > config->universe_width) {
+        fprintf(stderr, "Error: Shards must be between 1 and %d (and at most universe_width)\n", MAX_SHARDS);
+        config_destroy(&cfg);
+        return -1;
+    }
+
+    if (config->move_threads < 0 || config->move_threads > MAX_MOVE_THREADS) {
+        fprintf(stderr, "Error: Move threads must be between 0 and %d\n", MAX_MOVE_THREADS);
+        config_destroy(&cfg);
+        return -1;
+    }
+
+    if (config->pipeline_core < -1) {
+        fprintf(stderr, "Error: Pipeline core must be -1 (not pinned) or a core number\n");
+        config_destroy(&cfg);
+        return -1;
+    }
+
+    // Every shard builds the same initial universe and keeps its strip
+    if (config->shards > 1 && config->seed == 0) {
+        fprintf(stderr, "Error: A seed must be set when the universe has several shards\n");
+        config_destroy(&cfg);
+        return -1;
+    }
+
+    if (config->ship_idle_timeout < 0) {
+        fprintf(stderr, "Error: Ship idle timeout must not be negative\n");
+        config_destroy(&cfg);
+        return -1;
+    }
+
     config_destroy(&cfg);
     return 0;
 }
@@ -114,5 +244,27 @@ void print_config(universe_config *config) {
     printf("Maximum trash: %d\n", config->max_trash);
     printf("Initial trash: %d\n", config->initial_trash);
     printf("Ship capacity: %d\n", config->ship_capacity);
+    printf("Ship idle timeout: %d s\n", config->ship_idle_timeout);
+    printf("Tick rate: %d Hz\n", config->tick_rate);
+    for (int i = 0; i < config->num_server_endpoints; i++) {
+        printf("Server endpoint: %s\n", config->server_endpoints[i]);
+    }
+    for (int i = 0; i < config->num_update_endpoints; i++) {
+        printf("Update endpoint: %s\n", config->update_endpoints[i]);
+    }
+    printf("Interest radius: %d\n", config->interest_radius);
+    printf("Bots: %d\n", config->bots);
+    printf("Shards: %d\n", config->shards);
+    if (config->seed != 0) {
+        printf("Seed: %d\n", config->seed);
+    }
+    printf("Move threads: %d\n", config->move_threads);
+    if (config->pipeline) {
+        if (config->pipeline_core >= 0) {
+            printf("Pipeline: on, stages pinned from core %d\n", config->pipeline_core);
+        } else {
+            printf("Pipeline: on, stages not pinned\n");
+        }
+    }
     printf("==============================\n");
 }
\ No newline at end of file
@@ -1,6 +1,17 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
+#define MAX_ENDPOINTS 8
+#define ENDPOINT_LEN 128
+#define DEFAULT_SERVER_ENDPOINT "tcp://*:5555"
+#define DEFAULT_UPDATE_ENDPOINT "tcp://*:5556"
+#define DEFAULT_INTEREST_RADIUS 150
+#define DEFAULT_SHIP_IDLE_TIMEOUT 60
+#define DEFAULT_TICK_RATE 100
+#define MAX_SHARDS 16
+#define MAX_MOVE_THREADS 16
+#define MAX_SHIPS 16384
+
 typedef struct {
     int universe_width;
     int universe_height;
@@ -9,6 +20,19 @@ typedef struct {
     int initial_trash;
     int ship_capacity;
     int max_ships;
+    int ship_idle_timeout;  // seconds without requests before a ship is removed, 0 = never
+    int tick_rate;          // simulation ticks per second
+    char server_endpoints[MAX_ENDPOINTS][ENDPOINT_LEN];  // zmq endpoints the server binds
+    int num_server_endpoints;
+    char update_endpoints[MAX_ENDPOINTS][ENDPOINT_LEN];  // zmq endpoints world updates are published on
+    int num_update_endpoints;
+    int interest_radius;    // half side of the square a client receives updates for
+    int bots;               // server controlled ships spawned at start
+    int shards;             // server processes the universe is split across, see shard-map.h
+    int seed;               // random seed of the initial universe, 0 = a new one every run
+    int move_threads;       // threads resolving ship moves besides the tick thread
+    int pipeline;           // decode and encode on their own threads, see pipeline.h
+    int pipeline_core;      // first core the pipeline stages are pinned to, -1 = not pinned
 } universe_config;
 
 // Function to load configuration from file
@@ -0,0 +1,173 @@
+#include "flow-field.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+int flow_field_init(flow_field *field, int width, int height, int cell_size) {
+    field->cell_size = cell_size;
+    field->width = width;
+    field->height = height;
+    field->cols = (width + cell_size - 1) / cell_size;
+    field->rows = (height + cell_size - 1) / cell_size;
+    if (field->cols < 1) field->cols = 1;
+    if (field->rows < 1) field->rows = 1;
+
+    int num_cells = field->cols * field->rows;
+    field->blocked = (bool*)malloc(sizeof(bool) * num_cells);
+    field->distance = (int*)malloc(sizeof(int) * num_cells);
+    field->step_x = (signed char*)malloc(num_cells);
+    field->step_y = (signed char*)malloc(num_cells);
+    field->queue = (int*)malloc(sizeof(int) * num_cells);
+    if (!field->blocked || !field->distance || !field->step_x || !field->step_y || !field->queue) {
+        fprintf(stderr, "Failed to allocate flow field\n");
+        flow_field_destroy(field);
+        return -1;
+    }
+    flow_field_clear(field);
+    return 0;
+}
+
+void flow_field_destroy(flow_field *field) {
+    free(field->blocked);
+    free(field->distance);
+    free(field->step_x);
+    free(field->step_y);
+    free(field->queue);
+    field->blocked = NULL;
+    field->distance = NULL;
+    field->step_x = field->step_y = NULL;
+    field->queue = NULL;
+}
+
+void flow_field_clear(flow_field *field) {
+    for (int i = 0; i < field->cols * field->rows; i++) {
+        field->blocked[i] = false;
+        field->distance[i] = FLOW_UNREACHED;
+        field->step_x[i] = 0;
+        field->step_y[i] = 0;
+    }
+}
+
+static int wrap_index(int value, int count) {
+    value %= count;
+    return value < 0 ? value + count : value;
+}
+
+// Shortest offset from a to b on an axis that wraps every size pixels
+static float wrapped_delta(float a, float b, int size) {
+    float delta = fmodf(b - a, (float)size);
+    if (delta > size / 2.0f) delta -= size;
+    if (delta < -size / 2.0f) delta += size;
+    return delta;
+}
+
+static int cell_of(const flow_field *field, float x, float y) {
+    int col = (int)floorf(x / field->cell_size);
+    int row = (int)floorf(y / field->cell_size);
+    return wrap_index(row, field->rows) * field->cols + wrap_index(col, field->cols);
+}
+
+// Cells whose center lies within radius of (x, y), written to field->queue
+static int disc_cells(flow_field *field, float x, float y, float radius) {
+    int col_min = (int)floorf((x - radius) / field->cell_size);
+    int row_min = (int)floorf((y - radius) / field->cell_size);
+    int num_cols = (int)floorf((x + radius) / field->cell_size) - col_min + 1;
+    int num_rows = (int)floorf((y + radius) / field->cell_size) - row_min + 1;
+    if (num_cols > field->cols) num_cols = field->cols;
+    if (num_rows > field->rows) num_rows = field->rows;
+
+    int count = 0;
+    for (int r = 0; r < num_rows; r++) {
+        int row = wrap_index(row_min + r, field->rows);
+        float dy = wrapped_delta(y, (row + 0.5f) * field->cell_size, field->height);
+        for (int c = 0; c < num_cols; c++) {
+            int col = wrap_index(col_min + c, field->cols);
+            float dx = wrapped_delta(x, (col + 0.5f) * field->cell_size, field->width);
+            if (dx * dx + dy * dy <= radius * radius) {
+                field->queue[count++] = row * field->cols + col;
+            }
+        }
+    }
+    return count;
+}
+
+void flow_field_block(flow_field *field, float x, float y, float radius) {
+    int count = disc_cells(field, x, y, radius);
+    for (int i = 0; i < count; i++) {
+        field->blocked[field->queue[i]] = true;
+    }
+}
+
+void flow_field_build(flow_field *field, float x, float y, float radius) {
+    int num_cells = field->cols * field->rows;
+    for (int i = 0; i < num_cells; i++) {
+        field->distance[i] = FLOW_UNREACHED;
+        field->step_x[i] = 0;
+        field->step_y[i] = 0;
+    }
+
+    // The goal cells start the queue, at least the one holding the goal
+    int count = disc_cells(field, x, y, radius);
+    if (count == 0) {
+        field->queue[count++] = cell_of(field, x, y);
+    }
+    int tail = 0;
+    for (int i = 0; i < count; i++) {
+        int cell = field->queue[i];
+        if (!field->blocked[cell]) {
+            field->distance[cell] = 0;
+            field->queue[tail++] = cell;
+        }
+    }
+
+    for (int head = 0; head < tail; head++) {
+        int cell = field->queue[head];
+        int col = cell % field->cols;
+        int row = cell / field->cols;
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                int next = wrap_index(row + dy, field->rows) * field->cols + wrap_index(col + dx, field->cols);
+                if (field->blocked[next] || field->distance[next] != FLOW_UNREACHED) continue;
+                field->distance[next] = field->distance[cell] + 1;
+                field->queue[tail++] = next;
+            }
+        }
+    }
+
+    // Of the neighbours one cell closer, head for the one most in line with
+    // the goal, so open space is crossed straight rather than in a staircase
+    for (int cell = 0; cell < num_cells; cell++) {
+        if (field->distance[cell] <= 0) continue;
+        int col = cell % field->cols;
+        int row = cell / field->cols;
+        float to_x = wrapped_delta((col + 0.5f) * field->cell_size, x, field->width);
+        float to_y = wrapped_delta((row + 0.5f) * field->cell_size, y, field->height);
+        float best = -INFINITY;
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                int next = wrap_index(row + dy, field->rows) * field->cols + wrap_index(col + dx, field->cols);
+                if (field->distance[next] != field->distance[cell] - 1) continue;
+                float along = (dx * to_x + dy * to_y) / sqrtf((float)(dx * dx + dy * dy));
+                if (along > best) {
+                    best = along;
+                    field->step_x[cell] = (signed char)dx;
+                    field->step_y[cell] = (signed char)dy;
+                }
+            }
+        }
+    }
+}
+
+bool flow_field_step(const flow_field *field, float x, float y, int *dx, int *dy) {
+    int cell = cell_of(field, x, y);
+    if (field->distance[cell] <= 0) {
+        return false;
+    }
+    *dx = field->step_x[cell];
+    *dy = field->step_y[cell];
+    return true;
+}
+
+int flow_field_distance(const flow_field *field, float x, float y) {
+    return field->distance[cell_of(field, x, y)];
+}
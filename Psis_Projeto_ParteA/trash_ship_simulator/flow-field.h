@@ -0,0 +1,51 @@
+#ifndef FLOW_FIELD_H
+#define FLOW_FIELD_H
+
+#include <stdbool.h>
+
+#define FLOW_UNREACHED -1  // distance of blocked cells and cells the goal cannot be reached from
+
+// Distance transform toward one goal over a coarse grid of the universe,
+// wrapping around the edges like ship positions do. Ships step at most one
+// pixel per axis, so a diagonal costs the same as a straight step and a
+// breadth first search over the 8 neighbours of every cell gives the number
+// of cells to the goal. Each cell keeps the neighbour to head for, so any
+// number of ships look their step up in O(1) until the field is rebuilt.
+typedef struct {
+    int cell_size;
+    int width;
+    int height;
+    int cols;
+    int rows;
+    bool *blocked;
+    int *distance;             // cells to the goal, FLOW_UNREACHED if none
+    signed char *step_x;       // -1, 0 or 1 toward the goal, 0 and 0 in goal cells
+    signed char *step_y;
+    int *queue;
+} flow_field;
+
+// Allocate a field covering width x height, no cell blocked
+// Returns 0 on success, -1 on error
+int flow_field_init(flow_field *field, int width, int height, int cell_size);
+
+// Free the field arrays
+void flow_field_destroy(flow_field *field);
+
+// Unblock every cell and forget the goal
+void flow_field_clear(flow_field *field);
+
+// Block the cells whose center lies within radius of (x, y)
+void flow_field_block(flow_field *field, float x, float y, float radius);
+
+// Recompute distances and steps toward the cells whose center lies within
+// radius of (x, y). Blocked cells are never entered nor made goals.
+void flow_field_build(flow_field *field, float x, float y, float radius);
+
+// Step toward the goal from (x, y). Returns false in goal cells and where
+// the goal cannot be reached, the caller then steers on its own.
+bool flow_field_step(const flow_field *field, float x, float y, int *dx, int *dy);
+
+// Cells from (x, y) to the goal, FLOW_UNREACHED if it cannot be reached
+int flow_field_distance(const flow_field *field, float x, float y);
+
+#endif // FLOW_FIELD_H
@@ -0,0 +1,104 @@
+#include "free-space.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+int free_space_init(free_space_map *map, int width, int height, int cell_size, float clearance) {
+    map->cell_size = cell_size;
+    map->clearance = clearance;
+    map->cols = (width + cell_size - 1) / cell_size;
+    map->rows = (height + cell_size - 1) / cell_size;
+    if (map->cols < 1) map->cols = 1;
+    if (map->rows < 1) map->rows = 1;
+
+    int num_cells = map->cols * map->rows;
+    map->count = (int*)calloc(num_cells, sizeof(int));
+    map->free_cells = (int*)malloc(sizeof(int) * num_cells);
+    map->free_pos = (int*)malloc(sizeof(int) * num_cells);
+    if (!map->count || !map->free_cells || !map->free_pos) {
+        fprintf(stderr, "Failed to allocate free space map\n");
+        free_space_destroy(map);
+        return -1;
+    }
+
+    for (int i = 0; i < num_cells; i++) {
+        map->free_cells[i] = i;
+        map->free_pos[i] = i;
+    }
+    map->num_free = num_cells;
+    return 0;
+}
+
+void free_space_destroy(free_space_map *map) {
+    free(map->count);
+    free(map->free_cells);
+    free(map->free_pos);
+    map->count = map->free_cells = map->free_pos = NULL;
+    map->num_free = 0;
+}
+
+static void remove_free_cell(free_space_map *map, int cell) {
+    int pos = map->free_pos[cell];
+    int last = map->free_cells[--map->num_free];
+    map->free_cells[pos] = last;
+    map->free_pos[last] = pos;
+    map->free_pos[cell] = -1;
+}
+
+static void add_free_cell(free_space_map *map, int cell) {
+    map->free_pos[cell] = map->num_free;
+    map->free_cells[map->num_free++] = cell;
+}
+
+static int clamp_index(int value, int count) {
+    if (value < 0) return 0;
+    if (value >= count) return count - 1;
+    return value;
+}
+
+// Add delta to every cell lying completely within reach of the object.
+// Placed positions are integers, so a cell spans cell_size points per axis
+// and its farthest point from the object is one of those corners.
+static void update_cells(free_space_map *map, float x, float y, float radius, int delta) {
+    float reach = radius + map->clearance;
+    int col_min = clamp_index((int)floorf((x - reach) / map->cell_size), map->cols);
+    int col_max = clamp_index((int)floorf((x + reach) / map->cell_size), map->cols);
+    int row_min = clamp_index((int)floorf((y - reach) / map->cell_size), map->rows);
+    int row_max = clamp_index((int)floorf((y + reach) / map->cell_size), map->rows);
+
+    for (int row = row_min; row <= row_max; row++) {
+        float top = row * map->cell_size;
+        float dy = fmaxf(fabsf(top - y), fabsf(top + map->cell_size - 1 - y));
+
+        for (int col = col_min; col <= col_max; col++) {
+            float left = col * map->cell_size;
+            float dx = fmaxf(fabsf(left - x), fabsf(left + map->cell_size - 1 - x));
+            if (dx * dx + dy * dy >= reach * reach) {
+                continue;
+            }
+
+            int cell = row * map->cols + col;
+            int before = map->count[cell];
+            map->count[cell] = before + delta;
+
+            if (before == 0 && delta > 0) {
+                remove_free_cell(map, cell);
+            } else if (map->count[cell] == 0) {
+                add_free_cell(map, cell);
+            }
+        }
+    }
+}
+
+void free_space_occupy(free_space_map *map, float x, float y, float radius) {
+    update_cells(map, x, y, radius, 1);
+}
+
+void free_space_release(free_space_map *map, float x, float y, float radius) {
+    update_cells(map, x, y, radius, -1);
+}
+
+void free_space_cell_origin(const free_space_map *map, int cell, int *x, int *y) {
+    *x = (cell % map->cols) * map->cell_size;
+    *y = (cell / map->cols) * map->cell_size;
+}
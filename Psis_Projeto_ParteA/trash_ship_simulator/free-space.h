@@ -0,0 +1,37 @@
+#ifndef FREE_SPACE_H
+#define FREE_SPACE_H
+
+// Occupancy raster of the universe used to place new objects. A cell is
+// blocked by an object when no circle of radius clearance (the smallest
+// thing ever placed) could be centered anywhere in it without touching the
+// object. Every cell counts the objects blocking it, and the cells with no
+// objects are kept in a list so a spot can be drawn directly instead of
+// retrying random positions.
+typedef struct {
+    int cell_size;
+    float clearance;
+    int cols;
+    int rows;
+    int *count;       // objects overlapping each cell
+    int *free_cells;  // cells with count 0, in no particular order
+    int *free_pos;    // position of each cell in free_cells, -1 if occupied
+    int num_free;
+} free_space_map;
+
+// Allocate a map covering width x height, all cells free
+// Returns 0 on success, -1 on error
+int free_space_init(free_space_map *map, int width, int height, int cell_size, float clearance);
+
+// Free the map arrays
+void free_space_destroy(free_space_map *map);
+
+// Mark the cells blocked by an object at (x, y) as occupied
+void free_space_occupy(free_space_map *map, float x, float y, float radius);
+
+// Undo free_space_occupy, with the same position and radius
+void free_space_release(free_space_map *map, float x, float y, float radius);
+
+// Top-left corner of a cell
+void free_space_cell_origin(const free_space_map *map, int cell, int *x, int *y);
+
+#endif // FREE_SPACE_H
@@ -0,0 +1,119 @@
+#include "id-map.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// Ids are handed out in sequence, mix them so they do not fill runs of buckets
+static unsigned int bucket_of(const id_map *map, uint32_t key) {
+    key ^= key >> 16;
+    key *= 0x45d9f3bu;
+    key ^= key >> 16;
+    return key & map->mask;
+}
+
+static int allocate(id_map *map, unsigned int buckets) {
+    map->keys = (uint32_t*)calloc(buckets, sizeof(uint32_t));
+    map->values = (int*)malloc(sizeof(int) * buckets);
+    if (!map->keys || !map->values) {
+        fprintf(stderr, "Failed to allocate id map of %u buckets\n", buckets);
+        free(map->keys);
+        free(map->values);
+        map->keys = NULL;
+        map->values = NULL;
+        return -1;
+    }
+    map->mask = buckets - 1;
+    map->count = 0;
+    return 0;
+}
+
+int id_map_init(id_map *map, int expected) {
+    unsigned int buckets = 16;
+    while (buckets < (unsigned int)expected * 2) {
+        buckets <<= 1;
+    }
+    return allocate(map, buckets);
+}
+
+void id_map_destroy(id_map *map) {
+    free(map->keys);
+    free(map->values);
+    map->keys = NULL;
+    map->values = NULL;
+    map->count = 0;
+}
+
+int id_map_get(const id_map *map, uint32_t key) {
+    if (key == 0) {
+        return -1;
+    }
+    for (unsigned int b = bucket_of(map, key); map->keys[b] != 0; b = (b + 1) & map->mask) {
+        if (map->keys[b] == key) {
+            return map->values[b];
+        }
+    }
+    return -1;
+}
+
+// Twice the buckets, every entry placed again
+static int grow(id_map *map) {
+    id_map old = *map;
+    if (allocate(map, (old.mask + 1) * 2) != 0) {
+        *map = old;
+        return -1;
+    }
+    for (unsigned int b = 0; b <= old.mask; b++) {
+        if (old.keys[b] != 0) {
+            id_map_put(map, old.keys[b], old.values[b]);
+        }
+    }
+    free(old.keys);
+    free(old.values);
+    return 0;
+}
+
+int id_map_put(id_map *map, uint32_t key, int value) {
+    if (key == 0) {
+        return -1;
+    }
+    if ((unsigned int)(map->count + 1) * 2 > map->mask + 1 && grow(map) != 0) {
+        return -1;
+    }
+    unsigned int b = bucket_of(map, key);
+    while (map->keys[b] != 0 && map->keys[b] != key) {
+        b = (b + 1) & map->mask;
+    }
+    if (map->keys[b] == 0) {
+        map->keys[b] = key;
+        map->count++;
+    }
+    map->values[b] = value;
+    return 0;
+}
+
+void id_map_remove(id_map *map, uint32_t key) {
+    if (key == 0) {
+        return;
+    }
+    unsigned int b = bucket_of(map, key);
+    while (map->keys[b] != key) {
+        if (map->keys[b] == 0) {
+            return;
+        }
+        b = (b + 1) & map->mask;
+    }
+
+    // Shift back the entries after it that probed past the freed bucket, so
+    // every lookup still finds its key before the first free bucket
+    unsigned int hole = b;
+    for (unsigned int next = (b + 1) & map->mask; map->keys[next] != 0; next = (next + 1) & map->mask) {
+        unsigned int home = bucket_of(map, map->keys[next]);
+        // The entry can fill the hole if its home is not between the hole and it
+        if (((next - home) & map->mask) >= ((next - hole) & map->mask)) {
+            map->keys[hole] = map->keys[next];
+            map->values[hole] = map->values[next];
+            hole = next;
+        }
+    }
+    map->keys[hole] = 0;
+    map->count--;
+}
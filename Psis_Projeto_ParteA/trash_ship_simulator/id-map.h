@@ -0,0 +1,32 @@
+#ifndef ID_MAP_H
+#define ID_MAP_H
+
+#include <stdint.h>
+
+// Ship ids to small ints (indices, shards), as an open addressing hash table
+// with linear probing. Lookups cost the same with ten ships or ten thousand,
+// and the table grows when it gets half full. Key 0 (SHIP_ID_NONE) marks a
+// free bucket and can not be stored.
+typedef struct {
+    uint32_t *keys;
+    int *values;
+    unsigned int mask;   // buckets - 1, a power of two
+    int count;
+} id_map;
+
+// Sized for expected entries without growing
+// Returns 0 on success, -1 on error
+int id_map_init(id_map *map, int expected);
+void id_map_destroy(id_map *map);
+
+// Value stored for key, -1 if there is none
+int id_map_get(const id_map *map, uint32_t key);
+
+// Store value for key, replacing the previous one
+// Returns 0 on success, -1 if the table could not grow
+int id_map_put(id_map *map, uint32_t key, int value);
+
+// Forget key (no-op if it is not there)
+void id_map_remove(id_map *map, uint32_t key);
+
+#endif // ID_MAP_H
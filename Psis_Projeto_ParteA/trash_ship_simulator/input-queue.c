@@ -0,0 +1,57 @@
+#include "input-queue.h"
+
+void input_queue_clear(input_queue *queue) {
+    queue->head = 0;
+    queue->count = 0;
+    queue->has_keys = false;
+}
+
+void input_queue_push_move(input_queue *queue, char direction, uint64_t now_ns, input_queue_stats *stats) {
+    stats->moves++;
+
+    if (queue->count > 0) {
+        queued_move *last = &queue->moves[(queue->head + queue->count - 1) % INPUT_QUEUE_CAPACITY];
+        if (last->direction == direction && last->steps < MAX_COALESCED_STEPS) {
+            last->steps++;
+            stats->coalesced++;
+            return;
+        }
+    }
+
+    if (queue->count == INPUT_QUEUE_CAPACITY) {
+        stats->dropped_full += queue->moves[queue->head].steps;
+        queue->head = (queue->head + 1) % INPUT_QUEUE_CAPACITY;
+        queue->count--;
+    }
+
+    queued_move *move = &queue->moves[(queue->head + queue->count) % INPUT_QUEUE_CAPACITY];
+    move->direction = direction;
+    move->steps = 1;
+    move->enqueued_ns = now_ns;
+    queue->count++;
+}
+
+void input_queue_push_keys(input_queue *queue, uint32_t keys, uint32_t seq, uint64_t now_ns,
+                           input_queue_stats *stats) {
+    if (queue->has_keys) {
+        stats->keys_replaced++;
+    }
+    queue->has_keys = true;
+    queue->keys = keys;
+    queue->seq = seq;
+    queue->keys_ns = now_ns;
+}
+
+bool input_queue_pop_move(input_queue *queue, uint64_t now_ns, queued_move *move, input_queue_stats *stats) {
+    while (queue->count > 0) {
+        *move = queue->moves[queue->head];
+        queue->head = (queue->head + 1) % INPUT_QUEUE_CAPACITY;
+        queue->count--;
+
+        if (now_ns - move->enqueued_ns <= INPUT_STALE_NS) {
+            return true;
+        }
+        stats->dropped_stale += move->steps;
+    }
+    return false;
+}
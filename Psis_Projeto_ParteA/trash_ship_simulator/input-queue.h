@@ -0,0 +1,55 @@
+#ifndef INPUT_QUEUE_H
+#define INPUT_QUEUE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Inputs of one ship waiting for the next tick. Requests are accepted as
+// soon as they arrive and applied when the tick drains the queues of all
+// ships in turn, so a client that floods the server only fills its own
+// queue. Consecutive moves in the same direction become one multi-step
+// move, and only the latest held-key state is kept.
+#define INPUT_QUEUE_CAPACITY 16
+#define MAX_COALESCED_STEPS 8      // longest move built from coalesced moves
+#define INPUT_STALE_NS 250000000ull  // moves older than this are dropped, not applied
+
+typedef struct {
+    char direction;
+    int steps;             // moves in the same direction, applied one after the other
+    uint64_t enqueued_ns;  // of the first of them
+} queued_move;
+
+typedef struct {
+    queued_move moves[INPUT_QUEUE_CAPACITY];  // ring buffer
+    int head;
+    int count;
+
+    bool has_keys;         // a held-key state is waiting
+    uint32_t keys;
+    uint32_t seq;
+    uint64_t keys_ns;
+} input_queue;
+
+// Counters over all queues
+typedef struct {
+    uint64_t moves;        // moves accepted
+    uint64_t coalesced;    // moves merged into the previous one
+    uint64_t dropped_full; // oldest moves pushed out of a full queue
+    uint64_t dropped_stale;
+    uint64_t keys_replaced;  // key states superseded before being applied
+} input_queue_stats;
+
+void input_queue_clear(input_queue *queue);
+
+// Queue one move, dropping the oldest one if the queue is full
+void input_queue_push_move(input_queue *queue, char direction, uint64_t now_ns, input_queue_stats *stats);
+
+// Queue a held-key state, replacing one that was not applied yet
+void input_queue_push_keys(input_queue *queue, uint32_t keys, uint32_t seq, uint64_t now_ns,
+                           input_queue_stats *stats);
+
+// Take the oldest move that is not stale, dropping the stale ones before it
+// Returns false if there is none
+bool input_queue_pop_move(input_queue *queue, uint64_t now_ns, queued_move *move, input_queue_stats *stats);
+
+#endif // INPUT_QUEUE_H
@@ -0,0 +1,165 @@
+#include "interest-region.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int interest_scratch_init(interest_scratch *scratch, universe_data *universe) {
+    scratch->max_entities = universe->max_trash + universe->max_planets + universe->max_ships;
+    scratch->visible = (interest_entry*)malloc(sizeof(interest_entry) * scratch->max_entities);
+    scratch->entered = (entity_state*)malloc(sizeof(entity_state) * scratch->max_entities);
+    scratch->moved = (entity_state*)malloc(sizeof(entity_state) * scratch->max_entities);
+    scratch->left = (uint64_t*)malloc(sizeof(uint64_t) * scratch->max_entities);
+    if (!scratch->visible || !scratch->entered || !scratch->moved || !scratch->left) {
+        fprintf(stderr, "Failed to allocate interest scratch\n");
+        interest_scratch_destroy(scratch);
+        return -1;
+    }
+    return 0;
+}
+
+void interest_scratch_destroy(interest_scratch *scratch) {
+    free(scratch->visible);
+    free(scratch->entered);
+    free(scratch->moved);
+    free(scratch->left);
+    scratch->visible = NULL;
+    scratch->entered = NULL;
+    scratch->moved = NULL;
+    scratch->left = NULL;
+}
+
+void interest_view_init(interest_view *view) {
+    view->entries = NULL;
+    view->count = 0;
+    view->capacity = 0;
+    view->seq = 0;
+}
+
+void interest_view_destroy(interest_view *view) {
+    free(view->entries);
+    interest_view_init(view);
+}
+
+void interest_view_reset(interest_view *view) {
+    view->count = 0;
+    view->seq = 0;
+}
+
+static int compare_entries(const void *a, const void *b) {
+    uint64_t x = ((const interest_entry*)a)->id;
+    uint64_t y = ((const interest_entry*)b)->id;
+    return (x > y) - (x < y);
+}
+
+static bool cell_in_range(const spatial_grid *grid, float x, float y,
+                          int col_min, int row_min, int col_max, int row_max) {
+    int col, row, unused_col, unused_row;
+    spatial_grid_cell_range(grid, x, y, 0, &col, &row, &unused_col, &unused_row);
+    return col >= col_min && col <= col_max && row >= row_min && row <= row_max;
+}
+
+static void add_visible(interest_scratch *scratch, int *count, uint64_t id, float x, float y) {
+    interest_entry *entry = &scratch->visible[(*count)++];
+    entry->id = id;
+    entry->x = (int32_t)lroundf(x);
+    entry->y = (int32_t)lroundf(y);
+}
+
+// Everything in the cells of the region, sorted by id
+static int collect_visible(universe_data *universe, float x, float y, float radius,
+                           interest_scratch *scratch) {
+    const spatial_grid *grid = &universe->interest_grid;
+    int col_min, row_min, col_max, row_max;
+    spatial_grid_cell_range(grid, x, y, radius, &col_min, &row_min, &col_max, &row_max);
+
+    int count = 0;
+    for (int row = row_min; row <= row_max; row++) {
+        for (int col = col_min; col <= col_max; col++) {
+            for (int i = grid->head[row * grid->cols + col]; i != -1; i = grid->next[i]) {
+                trash_structure *trash = &universe->trash[i];
+                add_visible(scratch, &count, ENTITY_ID(ENTITY_TRASH, trash->generation, i), trash->x, trash->y);
+            }
+        }
+    }
+
+    // Planets and ships are few, checking each one is cheaper than indexing them
+    for (int i = 0; i < universe->num_planets; i++) {
+        planet_structure *planet = &universe->planets[i];
+        if (cell_in_range(grid, planet->x, planet->y, col_min, row_min, col_max, row_max)) {
+            add_visible(scratch, &count, ENTITY_ID(ENTITY_PLANET, 0, i), planet->x, planet->y);
+        }
+    }
+    for (int i = 0; i < universe->num_ships; i++) {
+        ship_structure *ship = &universe->ships[i];
+        if (cell_in_range(grid, ship->x, ship->y, col_min, row_min, col_max, row_max)) {
+            add_visible(scratch, &count, ENTITY_SHIP_ID(ship->id), ship->x, ship->y);
+        }
+    }
+
+    qsort(scratch->visible, count, sizeof(interest_entry), compare_entries);
+    return count;
+}
+
+static void set_entity(entity_state *entity, universe_data *universe, const interest_entry *entry) {
+    entity->id = entry->id;
+    entity->kind = (uint8_t)(entry->id >> 56);
+    entity->name = entity->kind == ENTITY_PLANET ? universe->planets[entry->id & 0xFFFFFF].name : 0;
+    entity->ship = entity->kind == ENTITY_SHIP ? (ship_id)entry->id : SHIP_ID_NONE;
+    entity->x = entry->x;
+    entity->y = entry->y;
+}
+
+int interest_view_update(interest_view *view, universe_data *universe, float x, float y,
+                         float radius, interest_scratch *scratch, world_update *update) {
+    int num_visible = collect_visible(universe, x, y, radius, scratch);
+
+    update->full = view->seq == 0;
+    update->entered = scratch->entered;
+    update->moved = scratch->moved;
+    update->left = scratch->left;
+    update->num_entered = 0;
+    update->num_moved = 0;
+    update->num_left = 0;
+
+    // Both lists are sorted by id, one merge pass finds every difference
+    int old = 0, now = 0;
+    while (old < view->count || now < num_visible) {
+        interest_entry *previous = old < view->count ? &view->entries[old] : NULL;
+        interest_entry *current = now < num_visible ? &scratch->visible[now] : NULL;
+
+        if (current == NULL || (previous != NULL && previous->id < current->id)) {
+            update->left[update->num_left++] = previous->id;
+            old++;
+        } else if (previous == NULL || current->id < previous->id) {
+            set_entity(&update->entered[update->num_entered++], universe, current);
+            now++;
+        } else {
+            if (current->x != previous->x || current->y != previous->y) {
+                set_entity(&update->moved[update->num_moved++], universe, current);
+            }
+            old++;
+            now++;
+        }
+    }
+
+    if (num_visible > view->capacity) {
+        int capacity = view->capacity > 0 ? view->capacity : 64;
+        while (capacity < num_visible) capacity *= 2;
+        interest_entry *entries = (interest_entry*)realloc(view->entries, sizeof(interest_entry) * capacity);
+        if (!entries) {
+            fprintf(stderr, "Failed to grow interest view\n");
+            return -1;
+        }
+        view->entries = entries;
+        view->capacity = capacity;
+    }
+    memcpy(view->entries, scratch->visible, sizeof(interest_entry) * num_visible);
+    view->count = num_visible;
+
+    if (!update->full && update->num_entered == 0 && update->num_moved == 0 && update->num_left == 0) {
+        return 0;
+    }
+    update->seq = ++view->seq;
+    return 1;
+}
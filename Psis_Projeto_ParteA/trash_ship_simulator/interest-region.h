@@ -0,0 +1,62 @@
+#ifndef INTEREST_REGION_H
+#define INTEREST_REGION_H
+
+#include <stdint.h>
+#include "universe-data.h"
+#include "zmq-comm.h"
+
+// Area of interest of a client: the cells of universe->interest_grid that
+// overlap a square around its ship. Each session remembers what it was last
+// sent, sorted by id, so an update only carries what entered, moved or left
+// the region and its cost follows what the player can see, not the number of
+// entities in the universe.
+
+// Entity ids: kind in the top byte, then the slot generation (trash only, so
+// a reused slot is a new entity) and the index. Ships use their ship id in
+// the low 32 bits instead.
+#define ENTITY_ID(kind, generation, index) \
+    (((uint64_t)(kind) << 56) | ((uint64_t)(uint32_t)(generation) << 24) | (uint64_t)((index) & 0xFFFFFF))
+#define ENTITY_SHIP_ID(id) (((uint64_t)ENTITY_SHIP << 56) | (uint64_t)(uint32_t)(id))
+
+typedef struct {
+    uint64_t id;
+    int32_t x;
+    int32_t y;
+} interest_entry;
+
+// What one session was last sent
+typedef struct {
+    interest_entry *entries;  // sorted by id
+    int count;
+    int capacity;
+    uint32_t seq;             // updates sent since the view was reset
+} interest_view;
+
+// Work arrays shared by every view, sized for all the entities of the
+// universe once so computing an update never allocates
+typedef struct {
+    interest_entry *visible;
+    entity_state *entered;
+    entity_state *moved;
+    uint64_t *left;
+    int max_entities;
+} interest_scratch;
+
+// Returns 0 on success, -1 on error
+int interest_scratch_init(interest_scratch *scratch, universe_data *universe);
+void interest_scratch_destroy(interest_scratch *scratch);
+
+void interest_view_init(interest_view *view);
+void interest_view_destroy(interest_view *view);
+
+// Forget what was sent, the next update lists the whole region again
+void interest_view_reset(interest_view *view);
+
+// Compare the region of half side radius around (x, y) with what the view
+// was last sent and fill update with the differences (its arrays point into
+// scratch). Returns 1 if the update must be sent, 0 if nothing changed,
+// -1 on error
+int interest_view_update(interest_view *view, universe_data *universe, float x, float y,
+                         float radius, interest_scratch *scratch, world_update *update);
+
+#endif // INTEREST_REGION_H
@@ -0,0 +1,87 @@
+#include "latency-stats.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+uint64_t latency_now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void latency_reset(latency_histogram *histogram) {
+    memset(histogram, 0, sizeof(*histogram));
+}
+
+// Values below LATENCY_SUB_BUCKETS are stored exactly; above that the shift
+// drops all but the LATENCY_SUB_BUCKET_BITS most significant bits
+static int bucket_index(uint64_t value) {
+    if (value < LATENCY_SUB_BUCKETS) {
+        return (int)value;
+    }
+    int msb = 63 - __builtin_clzll(value);
+    int shift = msb - LATENCY_SUB_BUCKET_BITS + 1;
+    return shift * LATENCY_HALF_SUB_BUCKETS + (int)(value >> shift);
+}
+
+// Highest value that falls into a bucket
+static uint64_t bucket_upper_value(int index) {
+    if (index < LATENCY_SUB_BUCKETS) {
+        return (uint64_t)index;
+    }
+    int shift = index / LATENCY_HALF_SUB_BUCKETS - 1;
+    uint64_t sub = (uint64_t)(index - shift * LATENCY_HALF_SUB_BUCKETS);
+    return ((sub + 1) << shift) - 1;
+}
+
+void latency_record(latency_histogram *histogram, uint64_t value_ns) {
+    histogram->counts[bucket_index(value_ns)]++;
+    if (histogram->total_count == 0 || value_ns < histogram->min) {
+        histogram->min = value_ns;
+    }
+    if (value_ns > histogram->max) {
+        histogram->max = value_ns;
+    }
+    histogram->total_count++;
+}
+
+uint64_t latency_percentile(const latency_histogram *histogram, double percentile) {
+    if (histogram->total_count == 0) {
+        return 0;
+    }
+
+    uint64_t rank = (uint64_t)(percentile / 100.0 * histogram->total_count + 0.5);
+    if (rank < 1) rank = 1;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < LATENCY_NUM_BUCKETS; i++) {
+        seen += histogram->counts[i];
+        if (seen >= rank) {
+            uint64_t value = bucket_upper_value(i);
+            return value < histogram->max ? value : histogram->max;
+        }
+    }
+    return histogram->max;
+}
+
+void latency_summarize(const latency_histogram *histogram, const char *command,
+                       const char *stage, latency_summary *summary) {
+    snprintf(summary->command, sizeof(summary->command), "%s", command);
+    snprintf(summary->stage, sizeof(summary->stage), "%s", stage);
+    summary->count = histogram->total_count;
+    summary->p50_ns = latency_percentile(histogram, 50);
+    summary->p90_ns = latency_percentile(histogram, 90);
+    summary->p99_ns = latency_percentile(histogram, 99);
+    summary->max_ns = histogram->max;
+}
+
+void latency_print_summaries(const latency_summary *summaries, int count) {
+    printf("%-10s %-10s %9s %11s %11s %11s %11s\n",
+           "command", "stage", "count", "p50(us)", "p90(us)", "p99(us)", "max(us)");
+    for (int i = 0; i < count; i++) {
+        const latency_summary *s = &summaries[i];
+        printf("%-10s %-10s %9llu %11.1f %11.1f %11.1f %11.1f\n",
+               s->command, s->stage, (unsigned long long)s->count,
+               s->p50_ns / 1000.0, s->p90_ns / 1000.0, s->p99_ns / 1000.0, s->max_ns / 1000.0);
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef LATENCY_STATS_H
+#define LATENCY_STATS_H
+
+#include <stdint.h>
+
+// HDR-style latency histogram: values (in nanoseconds) are grouped by power
+// of two and every power of two is split into LATENCY_HALF_SUB_BUCKETS linear
+// sub-buckets, so any recorded value is reproduced within
+// 1/LATENCY_HALF_SUB_BUCKETS (~6%) while the range covers everything a
+// uint64_t can hold. Values below LATENCY_SUB_BUCKETS are kept exactly.
+#define LATENCY_SUB_BUCKET_BITS 5
+#define LATENCY_SUB_BUCKETS (1 << LATENCY_SUB_BUCKET_BITS)
+#define LATENCY_HALF_SUB_BUCKETS (LATENCY_SUB_BUCKETS / 2)
+#define LATENCY_NUM_BUCKETS ((64 - LATENCY_SUB_BUCKET_BITS + 2) * LATENCY_HALF_SUB_BUCKETS)
+
+typedef struct {
+    uint64_t counts[LATENCY_NUM_BUCKETS];
+    uint64_t total_count;
+    uint64_t min;
+    uint64_t max;
+} latency_histogram;
+
+// One row of a latency report (also the payload of a stats response)
+typedef struct {
+    char command[16];
+    char stage[16];
+    uint64_t count;
+    uint64_t p50_ns;
+    uint64_t p90_ns;
+    uint64_t p99_ns;
+    uint64_t max_ns;
+} latency_summary;
+
+// Monotonic clock in nanoseconds
+uint64_t latency_now_ns();
+
+// Clear all recorded values
+void latency_reset(latency_histogram *histogram);
+
+// Record one value (nanoseconds)
+void latency_record(latency_histogram *histogram, uint64_t value_ns);
+
+// Value at the given percentile (0-100); 0 if nothing was recorded
+uint64_t latency_percentile(const latency_histogram *histogram, double percentile);
+
+// Fill a report row from a histogram
+void latency_summarize(const latency_histogram *histogram, const char *command,
+                       const char *stage, latency_summary *summary);
+
+// Print report rows as a table (times in microseconds)
+void latency_print_summaries(const latency_summary *summaries, int count);
+
+#endif // LATENCY_STATS_H
@@ -142,6 +142,231 @@ void   movement_request__free_unpacked
   assert(message->base.descriptor == &movement_request__descriptor);
   protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
 }
+void   disconnect_request__init
+                     (DisconnectRequest         *message)
+{
+  static const DisconnectRequest init_value = DISCONNECT_REQUEST__INIT;
+  *message = init_value;
+}
+size_t disconnect_request__get_packed_size
+                     (const DisconnectRequest *message)
+{
+  assert(message->base.descriptor == &disconnect_request__descriptor);
+  return protobuf_c_message_get_packed_size ((const ProtobufCMessage*)(message));
+}
+size_t disconnect_request__pack
+                     (const DisconnectRequest *message,
+                      uint8_t       *out)
+{
+  assert(message->base.descriptor == &disconnect_request__descriptor);
+  return protobuf_c_message_pack ((const ProtobufCMessage*)message, out);
+}
+size_t disconnect_request__pack_to_buffer
+                     (const DisconnectRequest *message,
+                      ProtobufCBuffer *buffer)
+{
+  assert(message->base.descriptor == &disconnect_request__descriptor);
+  return protobuf_c_message_pack_to_buffer ((const ProtobufCMessage*)message, buffer);
+}
+DisconnectRequest *
+       disconnect_request__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data)
+{
+  return (DisconnectRequest *)
+     protobuf_c_message_unpack (&disconnect_request__descriptor,
+                                allocator, len, data);
+}
+void   disconnect_request__free_unpacked
+                     (DisconnectRequest *message,
+                      ProtobufCAllocator *allocator)
+{
+  if(!message)
+    return;
+  assert(message->base.descriptor == &disconnect_request__descriptor);
+  protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
+}
+void   input_request__init
+                     (InputRequest         *message)
+{
+  static const InputRequest init_value = INPUT_REQUEST__INIT;
+  *message = init_value;
+}
+size_t input_request__get_packed_size
+                     (const InputRequest *message)
+{
+  assert(message->base.descriptor == &input_request__descriptor);
+  return protobuf_c_message_get_packed_size ((const ProtobufCMessage*)(message));
+}
+size_t input_request__pack
+                     (const InputRequest *message,
+                      uint8_t       *out)
+{
+  assert(message->base.descriptor == &input_request__descriptor);
+  return protobuf_c_message_pack ((const ProtobufCMessage*)message, out);
+}
+size_t input_request__pack_to_buffer
+                     (const InputRequest *message,
+                      ProtobufCBuffer *buffer)
+{
+  assert(message->base.descriptor == &input_request__descriptor);
+  return protobuf_c_message_pack_to_buffer ((const ProtobufCMessage*)message, buffer);
+}
+InputRequest *
+       input_request__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data)
+{
+  return (InputRequest *)
+     protobuf_c_message_unpack (&input_request__descriptor,
+                                allocator, len, data);
+}
+void   input_request__free_unpacked
+                     (InputRequest *message,
+                      ProtobufCAllocator *allocator)
+{
+  if(!message)
+    return;
+  assert(message->base.descriptor == &input_request__descriptor);
+  protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
+}
+void   stats_request__init
+                     (StatsRequest         *message)
+{
+  static const StatsRequest init_value = STATS_REQUEST__INIT;
+  *message = init_value;
+}
+size_t stats_request__get_packed_size
+                     (const StatsRequest *message)
+{
+  assert(message->base.descriptor == &stats_request__descriptor);
+  return protobuf_c_message_get_packed_size ((const ProtobufCMessage*)(message));
+}
+size_t stats_request__pack
+                     (const StatsRequest *message,
+                      uint8_t       *out)
+{
+  assert(message->base.descriptor == &stats_request__descriptor);
+  return protobuf_c_message_pack ((const ProtobufCMessage*)message, out);
+}
+size_t stats_request__pack_to_buffer
+                     (const StatsRequest *message,
+                      ProtobufCBuffer *buffer)
+{
+  assert(message->base.descriptor == &stats_request__descriptor);
+  return protobuf_c_message_pack_to_buffer ((const ProtobufCMessage*)message, buffer);
+}
+StatsRequest *
+       stats_request__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data)
+{
+  return (StatsRequest *)
+     protobuf_c_message_unpack (&stats_request__descriptor,
+                                allocator, len, data);
+}
+void   stats_request__free_unpacked
+                     (StatsRequest *message,
+                      ProtobufCAllocator *allocator)
+{
+  if(!message)
+    return;
+  assert(message->base.descriptor == &stats_request__descriptor);
+  protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
+}
+void   client_message__init
+                     (ClientMessage         *message)
+{
+  static const ClientMessage init_value = CLIENT_MESSAGE__INIT;
+  *message = init_value;
+}
+size_t client_message__get_packed_size
+                     (const ClientMessage *message)
+{
+  assert(message->base.descriptor == &client_message__descriptor);
+  return protobuf_c_message_get_packed_size ((const ProtobufCMessage*)(message));
+}
+size_t client_message__pack
+                     (const ClientMessage *message,
+                      uint8_t       *out)
+{
+  assert(message->base.descriptor == &client_message__descriptor);
+  return protobuf_c_message_pack ((const ProtobufCMessage*)message, out);
+}
+size_t client_message__pack_to_buffer
+                     (const ClientMessage *message,
+                      ProtobufCBuffer *buffer)
+{
+  assert(message->base.descriptor == &client_message__descriptor);
+  return protobuf_c_message_pack_to_buffer ((const ProtobufCMessage*)message, buffer);
+}
+ClientMessage *
+       client_message__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data)
+{
+  return (ClientMessage *)
+     protobuf_c_message_unpack (&client_message__descriptor,
+                                allocator, len, data);
+}
+void   client_message__free_unpacked
+                     (ClientMessage *message,
+                      ProtobufCAllocator *allocator)
+{
+  if(!message)
+    return;
+  assert(message->base.descriptor == &client_message__descriptor);
+  protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
+}
+void   stage_latency__init
+                     (StageLatency         *message)
+{
+  static const StageLatency init_value = STAGE_LATENCY__INIT;
+  *message = init_value;
+}
+size_t stage_latency__get_packed_size
+                     (const StageLatency *message)
+{
+  assert(message->base.descriptor == &stage_latency__descriptor);
+  return protobuf_c_message_get_packed_size ((const ProtobufCMessage*)(message));
+}
+size_t stage_latency__pack
+                     (const StageLatency *message,
+                      uint8_t       *out)
+{
+  assert(message->base.descriptor == &stage_latency__descriptor);
+  return protobuf_c_message_pack ((const ProtobufCMessage*)message, out);
+}
+size_t stage_latency__pack_to_buffer
+                     (const StageLatency *message,
+                      ProtobufCBuffer *buffer)
+{
+  assert(message->base.descriptor == &stage_latency__descriptor);
+  return protobuf_c_message_pack_to_buffer ((const ProtobufCMessage*)message, buffer);
+}
+StageLatency *
+       stage_latency__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data)
+{
+  return (StageLatency *)
+     protobuf_c_message_unpack (&stage_latency__descriptor,
+                                allocator, len, data);
+}
+void   stage_latency__free_unpacked
+                     (StageLatency *message,
+                      ProtobufCAllocator *allocator)
+{
+  if(!message)
+    return;
+  assert(message->base.descriptor == &stage_latency__descriptor);
+  protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
+}
 void   server_response__init
                      (ServerResponse         *message)
 {
@@ -174,235 +399,1617 @@ ServerResponse *
                       size_t               len,
                       const uint8_t       *data)
 {
-  return (ServerResponse *)
-     protobuf_c_message_unpack (&server_response__descriptor,
-                                allocator, len, data);
-}
-void   server_response__free_unpacked
-                     (ServerResponse *message,
-                      ProtobufCAllocator *allocator)
+  return (ServerResponse *)
+     protobuf_c_message_unpack (&server_response__descriptor,
+                                allocator, len, data);
+}
+void   server_response__free_unpacked
+                     (ServerResponse *message,
+                      ProtobufCAllocator *allocator)
+{
+  if(!message)
+    return;
+  assert(message->base.descriptor == &server_response__descriptor);
+  protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
+}
+void   entity_state__init
+                     (EntityState         *message)
+{
+  static const EntityState init_value = ENTITY_STATE__INIT;
+  *message = init_value;
+}
+size_t entity_state__get_packed_size
+                     (const EntityState *message)
+{
+  assert(message->base.descriptor == &entity_state__descriptor);
+  return protobuf_c_message_get_packed_size ((const ProtobufCMessage*)(message));
+}
+size_t entity_state__pack
+                     (const EntityState *message,
+                      uint8_t       *out)
+{
+  assert(message->base.descriptor == &entity_state__descriptor);
+  return protobuf_c_message_pack ((const ProtobufCMessage*)message, out);
+}
+size_t entity_state__pack_to_buffer
+                     (const EntityState *message,
+                      ProtobufCBuffer *buffer)
+{
+  assert(message->base.descriptor == &entity_state__descriptor);
+  return protobuf_c_message_pack_to_buffer ((const ProtobufCMessage*)message, buffer);
+}
+EntityState *
+       entity_state__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data)
+{
+  return (EntityState *)
+     protobuf_c_message_unpack (&entity_state__descriptor,
+                                allocator, len, data);
+}
+void   entity_state__free_unpacked
+                     (EntityState *message,
+                      ProtobufCAllocator *allocator)
+{
+  if(!message)
+    return;
+  assert(message->base.descriptor == &entity_state__descriptor);
+  protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
+}
+void   world_update__init
+                     (WorldUpdate         *message)
+{
+  static const WorldUpdate init_value = WORLD_UPDATE__INIT;
+  *message = init_value;
+}
+size_t world_update__get_packed_size
+                     (const WorldUpdate *message)
+{
+  assert(message->base.descriptor == &world_update__descriptor);
+  return protobuf_c_message_get_packed_size ((const ProtobufCMessage*)(message));
+}
+size_t world_update__pack
+                     (const WorldUpdate *message,
+                      uint8_t       *out)
+{
+  assert(message->base.descriptor == &world_update__descriptor);
+  return protobuf_c_message_pack ((const ProtobufCMessage*)message, out);
+}
+size_t world_update__pack_to_buffer
+                     (const WorldUpdate *message,
+                      ProtobufCBuffer *buffer)
+{
+  assert(message->base.descriptor == &world_update__descriptor);
+  return protobuf_c_message_pack_to_buffer ((const ProtobufCMessage*)message, buffer);
+}
+WorldUpdate *
+       world_update__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data)
+{
+  return (WorldUpdate *)
+     protobuf_c_message_unpack (&world_update__descriptor,
+                                allocator, len, data);
+}
+void   world_update__free_unpacked
+                     (WorldUpdate *message,
+                      ProtobufCAllocator *allocator)
+{
+  if(!message)
+    return;
+  assert(message->base.descriptor == &world_update__descriptor);
+  protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
+}
+void   shard_ship__init
+                     (ShardShip         *message)
+{
+  static const ShardShip init_value = SHARD_SHIP__INIT;
+  *message = init_value;
+}
+size_t shard_ship__get_packed_size
+                     (const ShardShip *message)
+{
+  assert(message->base.descriptor == &shard_ship__descriptor);
+  return protobuf_c_message_get_packed_size ((const ProtobufCMessage*)(message));
+}
+size_t shard_ship__pack
+                     (const ShardShip *message,
+                      uint8_t       *out)
+{
+  assert(message->base.descriptor == &shard_ship__descriptor);
+  return protobuf_c_message_pack ((const ProtobufCMessage*)message, out);
+}
+size_t shard_ship__pack_to_buffer
+                     (const ShardShip *message,
+                      ProtobufCBuffer *buffer)
+{
+  assert(message->base.descriptor == &shard_ship__descriptor);
+  return protobuf_c_message_pack_to_buffer ((const ProtobufCMessage*)message, buffer);
+}
+ShardShip *
+       shard_ship__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data)
+{
+  return (ShardShip *)
+     protobuf_c_message_unpack (&shard_ship__descriptor,
+                                allocator, len, data);
+}
+void   shard_ship__free_unpacked
+                     (ShardShip *message,
+                      ProtobufCAllocator *allocator)
+{
+  if(!message)
+    return;
+  assert(message->base.descriptor == &shard_ship__descriptor);
+  protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
+}
+void   shard_trash__init
+                     (ShardTrash         *message)
+{
+  static const ShardTrash init_value = SHARD_TRASH__INIT;
+  *message = init_value;
+}
+size_t shard_trash__get_packed_size
+                     (const ShardTrash *message)
+{
+  assert(message->base.descriptor == &shard_trash__descriptor);
+  return protobuf_c_message_get_packed_size ((const ProtobufCMessage*)(message));
+}
+size_t shard_trash__pack
+                     (const ShardTrash *message,
+                      uint8_t       *out)
+{
+  assert(message->base.descriptor == &shard_trash__descriptor);
+  return protobuf_c_message_pack ((const ProtobufCMessage*)message, out);
+}
+size_t shard_trash__pack_to_buffer
+                     (const ShardTrash *message,
+                      ProtobufCBuffer *buffer)
+{
+  assert(message->base.descriptor == &shard_trash__descriptor);
+  return protobuf_c_message_pack_to_buffer ((const ProtobufCMessage*)message, buffer);
+}
+ShardTrash *
+       shard_trash__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data)
+{
+  return (ShardTrash *)
+     protobuf_c_message_unpack (&shard_trash__descriptor,
+                                allocator, len, data);
+}
+void   shard_trash__free_unpacked
+                     (ShardTrash *message,
+                      ProtobufCAllocator *allocator)
+{
+  if(!message)
+    return;
+  assert(message->base.descriptor == &shard_trash__descriptor);
+  protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
+}
+void   shard_handoff__init
+                     (ShardHandoff         *message)
+{
+  static const ShardHandoff init_value = SHARD_HANDOFF__INIT;
+  *message = init_value;
+}
+size_t shard_handoff__get_packed_size
+                     (const ShardHandoff *message)
+{
+  assert(message->base.descriptor == &shard_handoff__descriptor);
+  return protobuf_c_message_get_packed_size ((const ProtobufCMessage*)(message));
+}
+size_t shard_handoff__pack
+                     (const ShardHandoff *message,
+                      uint8_t       *out)
+{
+  assert(message->base.descriptor == &shard_handoff__descriptor);
+  return protobuf_c_message_pack ((const ProtobufCMessage*)message, out);
+}
+size_t shard_handoff__pack_to_buffer
+                     (const ShardHandoff *message,
+                      ProtobufCBuffer *buffer)
+{
+  assert(message->base.descriptor == &shard_handoff__descriptor);
+  return protobuf_c_message_pack_to_buffer ((const ProtobufCMessage*)message, buffer);
+}
+ShardHandoff *
+       shard_handoff__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data)
+{
+  return (ShardHandoff *)
+     protobuf_c_message_unpack (&shard_handoff__descriptor,
+                                allocator, len, data);
+}
+void   shard_handoff__free_unpacked
+                     (ShardHandoff *message,
+                      ProtobufCAllocator *allocator)
+{
+  if(!message)
+    return;
+  assert(message->base.descriptor == &shard_handoff__descriptor);
+  protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
+}
+void   shard_notice__init
+                     (ShardNotice         *message)
+{
+  static const ShardNotice init_value = SHARD_NOTICE__INIT;
+  *message = init_value;
+}
+size_t shard_notice__get_packed_size
+                     (const ShardNotice *message)
+{
+  assert(message->base.descriptor == &shard_notice__descriptor);
+  return protobuf_c_message_get_packed_size ((const ProtobufCMessage*)(message));
+}
+size_t shard_notice__pack
+                     (const ShardNotice *message,
+                      uint8_t       *out)
+{
+  assert(message->base.descriptor == &shard_notice__descriptor);
+  return protobuf_c_message_pack ((const ProtobufCMessage*)message, out);
+}
+size_t shard_notice__pack_to_buffer
+                     (const ShardNotice *message,
+                      ProtobufCBuffer *buffer)
+{
+  assert(message->base.descriptor == &shard_notice__descriptor);
+  return protobuf_c_message_pack_to_buffer ((const ProtobufCMessage*)message, buffer);
+}
+ShardNotice *
+       shard_notice__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data)
+{
+  return (ShardNotice *)
+     protobuf_c_message_unpack (&shard_notice__descriptor,
+                                allocator, len, data);
+}
+void   shard_notice__free_unpacked
+                     (ShardNotice *message,
+                      ProtobufCAllocator *allocator)
+{
+  if(!message)
+    return;
+  assert(message->base.descriptor == &shard_notice__descriptor);
+  protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
+}
+static const ProtobufCFieldDescriptor position__field_descriptors[2] =
+{
+  {
+    "x",
+    1,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_SINT32,
+    0,   /* quantifier_offset */
+    offsetof(Position, x),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "y",
+    2,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_SINT32,
+    0,   /* quantifier_offset */
+    offsetof(Position, y),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned position__field_indices_by_name[] = {
+  0,   /* field[0] = x */
+  1,   /* field[1] = y */
+};
+static const ProtobufCIntRange position__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 2 }
+};
+const ProtobufCMessageDescriptor position__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "Position",
+  "Position",
+  "Position",
+  "",
+  sizeof(Position),
+  2,
+  position__field_descriptors,
+  position__field_indices_by_name,
+  1,  position__number_ranges,
+  (ProtobufCMessageInit) position__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor connect_request__field_descriptors[3] =
+{
+  {
+    "seq",
+    2,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT32,
+    offsetof(ConnectRequest, has_seq),   /* quantifier_offset */
+    offsetof(ConnectRequest, seq),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "sent_ns",
+    3,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT64,
+    offsetof(ConnectRequest, has_sent_ns),   /* quantifier_offset */
+    offsetof(ConnectRequest, sent_ns),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "ship_id",
+    4,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT32,
+    0,   /* quantifier_offset */
+    offsetof(ConnectRequest, ship_id),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned connect_request__field_indices_by_name[] = {
+  1,   /* field[1] = sent_ns */
+  0,   /* field[0] = seq */
+  2,   /* field[2] = ship_id */
+};
+static const ProtobufCIntRange connect_request__number_ranges[1 + 1] =
+{
+  { 2, 0 },
+  { 0, 3 }
+};
+const ProtobufCMessageDescriptor connect_request__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "connect_request",
+  "ConnectRequest",
+  "ConnectRequest",
+  "",
+  sizeof(ConnectRequest),
+  3,
+  connect_request__field_descriptors,
+  connect_request__field_indices_by_name,
+  1,  connect_request__number_ranges,
+  (ProtobufCMessageInit) connect_request__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor movement_request__field_descriptors[5] =
+{
+  {
+    "direction",
+    2,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_BYTES,
+    0,   /* quantifier_offset */
+    offsetof(MovementRequest, direction),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "token",
+    3,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT32,
+    0,   /* quantifier_offset */
+    offsetof(MovementRequest, token),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "seq",
+    4,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT32,
+    offsetof(MovementRequest, has_seq),   /* quantifier_offset */
+    offsetof(MovementRequest, seq),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "sent_ns",
+    5,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT64,
+    offsetof(MovementRequest, has_sent_ns),   /* quantifier_offset */
+    offsetof(MovementRequest, sent_ns),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "ship_id",
+    6,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT32,
+    0,   /* quantifier_offset */
+    offsetof(MovementRequest, ship_id),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned movement_request__field_indices_by_name[] = {
+  0,   /* field[0] = direction */
+  3,   /* field[3] = sent_ns */
+  2,   /* field[2] = seq */
+  4,   /* field[4] = ship_id */
+  1,   /* field[1] = token */
+};
+static const ProtobufCIntRange movement_request__number_ranges[1 + 1] =
+{
+  { 2, 0 },
+  { 0, 5 }
+};
+const ProtobufCMessageDescriptor movement_request__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "movement_request",
+  "MovementRequest",
+  "MovementRequest",
+  "",
+  sizeof(MovementRequest),
+  5,
+  movement_request__field_descriptors,
+  movement_request__field_indices_by_name,
+  1,  movement_request__number_ranges,
+  (ProtobufCMessageInit) movement_request__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor disconnect_request__field_descriptors[2] =
+{
+  {
+    "token",
+    2,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT32,
+    0,   /* quantifier_offset */
+    offsetof(DisconnectRequest, token),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "ship_id",
+    3,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT32,
+    0,   /* quantifier_offset */
+    offsetof(DisconnectRequest, ship_id),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned disconnect_request__field_indices_by_name[] = {
+  1,   /* field[1] = ship_id */
+  0,   /* field[0] = token */
+};
+static const ProtobufCIntRange disconnect_request__number_ranges[1 + 1] =
+{
+  { 2, 0 },
+  { 0, 2 }
+};
+const ProtobufCMessageDescriptor disconnect_request__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "disconnect_request",
+  "DisconnectRequest",
+  "DisconnectRequest",
+  "",
+  sizeof(DisconnectRequest),
+  2,
+  disconnect_request__field_descriptors,
+  disconnect_request__field_indices_by_name,
+  1,  disconnect_request__number_ranges,
+  (ProtobufCMessageInit) disconnect_request__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor input_request__field_descriptors[6] =
+{
+  {
+    "token",
+    2,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT32,
+    0,   /* quantifier_offset */
+    offsetof(InputRequest, token),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "keys",
+    3,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT32,
+    0,   /* quantifier_offset */
+    offsetof(InputRequest, keys),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "resync",
+    4,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_BOOL,
+    offsetof(InputRequest, has_resync),   /* quantifier_offset */
+    offsetof(InputRequest, resync),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "seq",
+    5,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT32,
+    offsetof(InputRequest, has_seq),   /* quantifier_offset */
+    offsetof(InputRequest, seq),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "sent_ns",
+    6,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT64,
+    offsetof(InputRequest, has_sent_ns),   /* quantifier_offset */
+    offsetof(InputRequest, sent_ns),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "ship_id",
+    7,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT32,
+    0,   /* quantifier_offset */
+    offsetof(InputRequest, ship_id),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned input_request__field_indices_by_name[] = {
+  1,   /* field[1] = keys */
+  2,   /* field[2] = resync */
+  4,   /* field[4] = sent_ns */
+  3,   /* field[3] = seq */
+  5,   /* field[5] = ship_id */
+  0,   /* field[0] = token */
+};
+static const ProtobufCIntRange input_request__number_ranges[1 + 1] =
+{
+  { 2, 0 },
+  { 0, 6 }
+};
+const ProtobufCMessageDescriptor input_request__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "input_request",
+  "InputRequest",
+  "InputRequest",
+  "",
+  sizeof(InputRequest),
+  6,
+  input_request__field_descriptors,
+  input_request__field_indices_by_name,
+  1,  input_request__number_ranges,
+  (ProtobufCMessageInit) input_request__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor stats_request__field_descriptors[0] =
+{
+};
+static const unsigned stats_request__field_indices_by_name[] = {
+};
+static const ProtobufCIntRange stats_request__number_ranges[0 + 1] =
+{
+  { 0, 0 }
+};
+const ProtobufCMessageDescriptor stats_request__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "stats_request",
+  "StatsRequest",
+  "StatsRequest",
+  "",
+  sizeof(StatsRequest),
+  0,
+  stats_request__field_descriptors,
+  stats_request__field_indices_by_name,
+  0,  stats_request__number_ranges,
+  (ProtobufCMessageInit) stats_request__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor client_message__field_descriptors[5] =
+{
+  {
+    "connect",
+    1,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(ClientMessage, payload_case),   /* quantifier_offset */
+    offsetof(ClientMessage, connect),
+    &connect_request__descriptor,
+    NULL,
+    PROTOBUF_C_FIELD_FLAG_ONEOF,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "move",
+    2,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(ClientMessage, payload_case),   /* quantifier_offset */
+    offsetof(ClientMessage, move),
+    &movement_request__descriptor,
+    NULL,
+    PROTOBUF_C_FIELD_FLAG_ONEOF,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "stats",
+    3,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(ClientMessage, payload_case),   /* quantifier_offset */
+    offsetof(ClientMessage, stats),
+    &stats_request__descriptor,
+    NULL,
+    PROTOBUF_C_FIELD_FLAG_ONEOF,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "disconnect",
+    4,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(ClientMessage, payload_case),   /* quantifier_offset */
+    offsetof(ClientMessage, disconnect),
+    &disconnect_request__descriptor,
+    NULL,
+    PROTOBUF_C_FIELD_FLAG_ONEOF,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "input",
+    5,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(ClientMessage, payload_case),   /* quantifier_offset */
+    offsetof(ClientMessage, input),
+    &input_request__descriptor,
+    NULL,
+    PROTOBUF_C_FIELD_FLAG_ONEOF,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned client_message__field_indices_by_name[] = {
+  0,   /* field[0] = connect */
+  3,   /* field[3] = disconnect */
+  4,   /* field[4] = input */
+  1,   /* field[1] = move */
+  2,   /* field[2] = stats */
+};
+static const ProtobufCIntRange client_message__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 5 }
+};
+const ProtobufCMessageDescriptor client_message__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "client_message",
+  "ClientMessage",
+  "ClientMessage",
+  "",
+  sizeof(ClientMessage),
+  5,
+  client_message__field_descriptors,
+  client_message__field_indices_by_name,
+  1,  client_message__number_ranges,
+  (ProtobufCMessageInit) client_message__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor stage_latency__field_descriptors[7] =
+{
+  {
+    "command",
+    1,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_STRING,
+    0,   /* quantifier_offset */
+    offsetof(StageLatency, command),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "stage",
+    2,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_STRING,
+    0,   /* quantifier_offset */
+    offsetof(StageLatency, stage),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "count",
+    3,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(StageLatency, count),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "p50_ns",
+    4,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(StageLatency, p50_ns),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "p90_ns",
+    5,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(StageLatency, p90_ns),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "p99_ns",
+    6,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(StageLatency, p99_ns),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "max_ns",
+    7,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(StageLatency, max_ns),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned stage_latency__field_indices_by_name[] = {
+  0,   /* field[0] = command */
+  2,   /* field[2] = count */
+  6,   /* field[6] = max_ns */
+  3,   /* field[3] = p50_ns */
+  4,   /* field[4] = p90_ns */
+  5,   /* field[5] = p99_ns */
+  1,   /* field[1] = stage */
+};
+static const ProtobufCIntRange stage_latency__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 7 }
+};
+const ProtobufCMessageDescriptor stage_latency__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "stage_latency",
+  "StageLatency",
+  "StageLatency",
+  "",
+  sizeof(StageLatency),
+  7,
+  stage_latency__field_descriptors,
+  stage_latency__field_indices_by_name,
+  1,  stage_latency__number_ranges,
+  (ProtobufCMessageInit) stage_latency__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCEnumValue server_response__response_type__enum_values_by_number[5] =
+{
+  { "CONNECT", "SERVER_RESPONSE__RESPONSE_TYPE__CONNECT", 1 },
+  { "MOVEMENT", "SERVER_RESPONSE__RESPONSE_TYPE__MOVEMENT", 2 },
+  { "STATS", "SERVER_RESPONSE__RESPONSE_TYPE__STATS", 3 },
+  { "DISCONNECT", "SERVER_RESPONSE__RESPONSE_TYPE__DISCONNECT", 4 },
+  { "INPUT", "SERVER_RESPONSE__RESPONSE_TYPE__INPUT", 5 },
+};
+static const ProtobufCIntRange server_response__response_type__value_ranges[] = {
+{1, 0},{0, 5}
+};
+static const ProtobufCEnumValueIndex server_response__response_type__enum_values_by_name[5] =
+{
+  { "CONNECT", 0 },
+  { "DISCONNECT", 3 },
+  { "INPUT", 4 },
+  { "MOVEMENT", 1 },
+  { "STATS", 2 },
+};
+const ProtobufCEnumDescriptor server_response__response_type__descriptor =
+{
+  PROTOBUF_C__ENUM_DESCRIPTOR_MAGIC,
+  "server_response.ResponseType",
+  "ResponseType",
+  "ServerResponse__ResponseType",
+  "",
+  5,
+  server_response__response_type__enum_values_by_number,
+  5,
+  server_response__response_type__enum_values_by_name,
+  1,
+  server_response__response_type__value_ranges,
+  NULL,NULL,NULL,NULL   /* reserved[1234] */
+};
+static const ProtobufCFieldDescriptor server_response__field_descriptors[9] =
+{
+  {
+    "type",
+    1,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_ENUM,
+    0,   /* quantifier_offset */
+    offsetof(ServerResponse, type),
+    &server_response__response_type__descriptor,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "success",
+    2,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_BOOL,
+    0,   /* quantifier_offset */
+    offsetof(ServerResponse, success),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "stats",
+    3,
+    PROTOBUF_C_LABEL_REPEATED,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(ServerResponse, n_stats),   /* quantifier_offset */
+    offsetof(ServerResponse, stats),
+    &stage_latency__descriptor,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "token",
+    4,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT32,
+    offsetof(ServerResponse, has_token),   /* quantifier_offset */
+    offsetof(ServerResponse, token),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "tick_rate",
+    5,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT32,
+    offsetof(ServerResponse, has_tick_rate),   /* quantifier_offset */
+    offsetof(ServerResponse, tick_rate),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "universe_width",
+    6,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_SINT32,
+    offsetof(ServerResponse, has_universe_width),   /* quantifier_offset */
+    offsetof(ServerResponse, universe_width),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "universe_height",
+    7,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_SINT32,
+    offsetof(ServerResponse, has_universe_height),   /* quantifier_offset */
+    offsetof(ServerResponse, universe_height),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "echo_seq",
+    8,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT32,
+    offsetof(ServerResponse, has_echo_seq),   /* quantifier_offset */
+    offsetof(ServerResponse, echo_seq),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "echo_sent_ns",
+    9,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT64,
+    offsetof(ServerResponse, has_echo_sent_ns),   /* quantifier_offset */
+    offsetof(ServerResponse, echo_sent_ns),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned server_response__field_indices_by_name[] = {
+  8,   /* field[8] = echo_sent_ns */
+  7,   /* field[7] = echo_seq */
+  2,   /* field[2] = stats */
+  1,   /* field[1] = success */
+  4,   /* field[4] = tick_rate */
+  3,   /* field[3] = token */
+  0,   /* field[0] = type */
+  6,   /* field[6] = universe_height */
+  5,   /* field[5] = universe_width */
+};
+static const ProtobufCIntRange server_response__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 9 }
+};
+const ProtobufCMessageDescriptor server_response__descriptor =
+{
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "server_response",
+  "ServerResponse",
+  "ServerResponse",
+  "",
+  sizeof(ServerResponse),
+  9,
+  server_response__field_descriptors,
+  server_response__field_indices_by_name,
+  1,  server_response__number_ranges,
+  (ProtobufCMessageInit) server_response__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor entity_state__field_descriptors[6] =
+{
+  {
+    "id",
+    1,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT64,
+    0,   /* quantifier_offset */
+    offsetof(EntityState, id),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "kind",
+    2,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT32,
+    0,   /* quantifier_offset */
+    offsetof(EntityState, kind),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "x",
+    3,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_SINT32,
+    0,   /* quantifier_offset */
+    offsetof(EntityState, x),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "y",
+    4,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_SINT32,
+    0,   /* quantifier_offset */
+    offsetof(EntityState, y),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "name",
+    5,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_BYTES,
+    offsetof(EntityState, has_name),   /* quantifier_offset */
+    offsetof(EntityState, name),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "ship_id",
+    6,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT32,
+    offsetof(EntityState, has_ship_id),   /* quantifier_offset */
+    offsetof(EntityState, ship_id),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+};
+static const unsigned entity_state__field_indices_by_name[] = {
+  0,   /* field[0] = id */
+  1,   /* field[1] = kind */
+  4,   /* field[4] = name */
+  5,   /* field[5] = ship_id */
+  2,   /* field[2] = x */
+  3,   /* field[3] = y */
+};
+static const ProtobufCIntRange entity_state__number_ranges[1 + 1] =
+{
+  { 1, 0 },
+  { 0, 6 }
+};
+const ProtobufCMessageDescriptor entity_state__descriptor =
 {
-  if(!message)
-    return;
-  assert(message->base.descriptor == &server_response__descriptor);
-  protobuf_c_message_free_unpacked ((ProtobufCMessage*)message, allocator);
-}
-static const ProtobufCFieldDescriptor position__field_descriptors[2] =
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "entity_state",
+  "EntityState",
+  "EntityState",
+  "",
+  sizeof(EntityState),
+  6,
+  entity_state__field_descriptors,
+  entity_state__field_indices_by_name,
+  1,  entity_state__number_ranges,
+  (ProtobufCMessageInit) entity_state__init,
+  NULL,NULL,NULL    /* reserved[123] */
+};
+static const ProtobufCFieldDescriptor world_update__field_descriptors[8] =
 {
   {
-    "x",
+    "tick",
     1,
     PROTOBUF_C_LABEL_REQUIRED,
-    PROTOBUF_C_TYPE_SINT32,
+    PROTOBUF_C_TYPE_UINT32,
     0,   /* quantifier_offset */
-    offsetof(Position, x),
+    offsetof(WorldUpdate, tick),
     NULL,
     NULL,
     0,             /* flags */
     0,NULL,NULL    /* reserved1,reserved2, etc */
   },
   {
-    "y",
+    "seq",
     2,
     PROTOBUF_C_LABEL_REQUIRED,
-    PROTOBUF_C_TYPE_SINT32,
+    PROTOBUF_C_TYPE_UINT32,
     0,   /* quantifier_offset */
-    offsetof(Position, y),
+    offsetof(WorldUpdate, seq),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "full",
+    3,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_BOOL,
+    0,   /* quantifier_offset */
+    offsetof(WorldUpdate, full),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "entered",
+    4,
+    PROTOBUF_C_LABEL_REPEATED,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(WorldUpdate, n_entered),   /* quantifier_offset */
+    offsetof(WorldUpdate, entered),
+    &entity_state__descriptor,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "moved",
+    5,
+    PROTOBUF_C_LABEL_REPEATED,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(WorldUpdate, n_moved),   /* quantifier_offset */
+    offsetof(WorldUpdate, moved),
+    &entity_state__descriptor,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "left",
+    6,
+    PROTOBUF_C_LABEL_REPEATED,
+    PROTOBUF_C_TYPE_UINT64,
+    offsetof(WorldUpdate, n_left),   /* quantifier_offset */
+    offsetof(WorldUpdate, left),
+    NULL,
+    NULL,
+    PROTOBUF_C_FIELD_FLAG_PACKED,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "ack_seq",
+    7,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT32,
+    offsetof(WorldUpdate, has_ack_seq),   /* quantifier_offset */
+    offsetof(WorldUpdate, ack_seq),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "ack_ticks",
+    8,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT32,
+    offsetof(WorldUpdate, has_ack_ticks),   /* quantifier_offset */
+    offsetof(WorldUpdate, ack_ticks),
     NULL,
     NULL,
     0,             /* flags */
     0,NULL,NULL    /* reserved1,reserved2, etc */
   },
 };
-static const unsigned position__field_indices_by_name[] = {
-  0,   /* field[0] = x */
-  1,   /* field[1] = y */
+static const unsigned world_update__field_indices_by_name[] = {
+  6,   /* field[6] = ack_seq */
+  7,   /* field[7] = ack_ticks */
+  3,   /* field[3] = entered */
+  2,   /* field[2] = full */
+  5,   /* field[5] = left */
+  4,   /* field[4] = moved */
+  1,   /* field[1] = seq */
+  0,   /* field[0] = tick */
 };
-static const ProtobufCIntRange position__number_ranges[1 + 1] =
+static const ProtobufCIntRange world_update__number_ranges[1 + 1] =
 {
   { 1, 0 },
-  { 0, 2 }
+  { 0, 8 }
 };
-const ProtobufCMessageDescriptor position__descriptor =
+const ProtobufCMessageDescriptor world_update__descriptor =
 {
   PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
-  "Position",
-  "Position",
-  "Position",
+  "world_update",
+  "WorldUpdate",
+  "WorldUpdate",
   "",
-  sizeof(Position),
-  2,
-  position__field_descriptors,
-  position__field_indices_by_name,
-  1,  position__number_ranges,
-  (ProtobufCMessageInit) position__init,
+  sizeof(WorldUpdate),
+  8,
+  world_update__field_descriptors,
+  world_update__field_indices_by_name,
+  1,  world_update__number_ranges,
+  (ProtobufCMessageInit) world_update__init,
   NULL,NULL,NULL    /* reserved[123] */
 };
-static const ProtobufCFieldDescriptor connect_request__field_descriptors[1] =
+static const ProtobufCFieldDescriptor shard_ship__field_descriptors[9] =
 {
   {
-    "letter",
-    1,
+    "x",
+    2,
     PROTOBUF_C_LABEL_REQUIRED,
-    PROTOBUF_C_TYPE_BYTES,
+    PROTOBUF_C_TYPE_FLOAT,
+    0,   /* quantifier_offset */
+    offsetof(ShardShip, x),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "y",
+    3,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_FLOAT,
+    0,   /* quantifier_offset */
+    offsetof(ShardShip, y),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "token",
+    4,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT32,
+    offsetof(ShardShip, has_token),   /* quantifier_offset */
+    offsetof(ShardShip, token),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "bot",
+    5,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_BOOL,
+    offsetof(ShardShip, has_bot),   /* quantifier_offset */
+    offsetof(ShardShip, bot),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "cargo",
+    6,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT32,
+    offsetof(ShardShip, has_cargo),   /* quantifier_offset */
+    offsetof(ShardShip, cargo),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "input_keys",
+    7,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT32,
+    offsetof(ShardShip, has_input_keys),   /* quantifier_offset */
+    offsetof(ShardShip, input_keys),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "input_seq",
+    8,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT32,
+    offsetof(ShardShip, has_input_seq),   /* quantifier_offset */
+    offsetof(ShardShip, input_seq),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "input_ticks",
+    9,
+    PROTOBUF_C_LABEL_OPTIONAL,
+    PROTOBUF_C_TYPE_UINT32,
+    offsetof(ShardShip, has_input_ticks),   /* quantifier_offset */
+    offsetof(ShardShip, input_ticks),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "ship_id",
+    10,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_UINT32,
     0,   /* quantifier_offset */
-    offsetof(ConnectRequest, letter),
+    offsetof(ShardShip, ship_id),
     NULL,
     NULL,
     0,             /* flags */
     0,NULL,NULL    /* reserved1,reserved2, etc */
   },
 };
-static const unsigned connect_request__field_indices_by_name[] = {
-  0,   /* field[0] = letter */
+static const unsigned shard_ship__field_indices_by_name[] = {
+  3,   /* field[3] = bot */
+  4,   /* field[4] = cargo */
+  5,   /* field[5] = input_keys */
+  6,   /* field[6] = input_seq */
+  7,   /* field[7] = input_ticks */
+  8,   /* field[8] = ship_id */
+  2,   /* field[2] = token */
+  0,   /* field[0] = x */
+  1,   /* field[1] = y */
 };
-static const ProtobufCIntRange connect_request__number_ranges[1 + 1] =
+static const ProtobufCIntRange shard_ship__number_ranges[1 + 1] =
 {
-  { 1, 0 },
-  { 0, 1 }
+  { 2, 0 },
+  { 0, 9 }
 };
-const ProtobufCMessageDescriptor connect_request__descriptor =
+const ProtobufCMessageDescriptor shard_ship__descriptor =
 {
   PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
-  "connect_request",
-  "ConnectRequest",
-  "ConnectRequest",
+  "shard_ship",
+  "ShardShip",
+  "ShardShip",
   "",
-  sizeof(ConnectRequest),
-  1,
-  connect_request__field_descriptors,
-  connect_request__field_indices_by_name,
-  1,  connect_request__number_ranges,
-  (ProtobufCMessageInit) connect_request__init,
+  sizeof(ShardShip),
+  9,
+  shard_ship__field_descriptors,
+  shard_ship__field_indices_by_name,
+  1,  shard_ship__number_ranges,
+  (ProtobufCMessageInit) shard_ship__init,
   NULL,NULL,NULL    /* reserved[123] */
 };
-static const ProtobufCFieldDescriptor movement_request__field_descriptors[2] =
+static const ProtobufCFieldDescriptor shard_trash__field_descriptors[4] =
 {
   {
-    "letter",
+    "x",
     1,
     PROTOBUF_C_LABEL_REQUIRED,
-    PROTOBUF_C_TYPE_BYTES,
+    PROTOBUF_C_TYPE_FLOAT,
     0,   /* quantifier_offset */
-    offsetof(MovementRequest, letter),
+    offsetof(ShardTrash, x),
     NULL,
     NULL,
     0,             /* flags */
     0,NULL,NULL    /* reserved1,reserved2, etc */
   },
   {
-    "direction",
+    "y",
     2,
     PROTOBUF_C_LABEL_REQUIRED,
-    PROTOBUF_C_TYPE_BYTES,
+    PROTOBUF_C_TYPE_FLOAT,
     0,   /* quantifier_offset */
-    offsetof(MovementRequest, direction),
+    offsetof(ShardTrash, y),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "speed",
+    3,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_FLOAT,
+    0,   /* quantifier_offset */
+    offsetof(ShardTrash, speed),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "angle",
+    4,
+    PROTOBUF_C_LABEL_REQUIRED,
+    PROTOBUF_C_TYPE_FLOAT,
+    0,   /* quantifier_offset */
+    offsetof(ShardTrash, angle),
     NULL,
     NULL,
     0,             /* flags */
     0,NULL,NULL    /* reserved1,reserved2, etc */
   },
 };
-static const unsigned movement_request__field_indices_by_name[] = {
-  1,   /* field[1] = direction */
-  0,   /* field[0] = letter */
+static const unsigned shard_trash__field_indices_by_name[] = {
+  3,   /* field[3] = angle */
+  2,   /* field[2] = speed */
+  0,   /* field[0] = x */
+  1,   /* field[1] = y */
 };
-static const ProtobufCIntRange movement_request__number_ranges[1 + 1] =
+static const ProtobufCIntRange shard_trash__number_ranges[1 + 1] =
 {
   { 1, 0 },
-  { 0, 2 }
+  { 0, 4 }
 };
-const ProtobufCMessageDescriptor movement_request__descriptor =
+const ProtobufCMessageDescriptor shard_trash__descriptor =
 {
   PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
-  "movement_request",
-  "MovementRequest",
-  "MovementRequest",
+  "shard_trash",
+  "ShardTrash",
+  "ShardTrash",
   "",
-  sizeof(MovementRequest),
-  2,
-  movement_request__field_descriptors,
-  movement_request__field_indices_by_name,
-  1,  movement_request__number_ranges,
-  (ProtobufCMessageInit) movement_request__init,
+  sizeof(ShardTrash),
+  4,
+  shard_trash__field_descriptors,
+  shard_trash__field_indices_by_name,
+  1,  shard_trash__number_ranges,
+  (ProtobufCMessageInit) shard_trash__init,
   NULL,NULL,NULL    /* reserved[123] */
 };
-static const ProtobufCEnumValue server_response__response_type__enum_values_by_number[2] =
+static const ProtobufCFieldDescriptor shard_handoff__field_descriptors[3] =
 {
-  { "CONNECT", "SERVER_RESPONSE__RESPONSE_TYPE__CONNECT", 1 },
-  { "MOVEMENT", "SERVER_RESPONSE__RESPONSE_TYPE__MOVEMENT", 2 },
+  {
+    "ships",
+    1,
+    PROTOBUF_C_LABEL_REPEATED,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(ShardHandoff, n_ships),   /* quantifier_offset */
+    offsetof(ShardHandoff, ships),
+    &shard_ship__descriptor,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "trash",
+    2,
+    PROTOBUF_C_LABEL_REPEATED,
+    PROTOBUF_C_TYPE_MESSAGE,
+    offsetof(ShardHandoff, n_trash),   /* quantifier_offset */
+    offsetof(ShardHandoff, trash),
+    &shard_trash__descriptor,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
+  {
+    "relayed",
+    3,
+    PROTOBUF_C_LABEL_REPEATED,
+    PROTOBUF_C_TYPE_BYTES,
+    offsetof(ShardHandoff, n_relayed),   /* quantifier_offset */
+    offsetof(ShardHandoff, relayed),
+    NULL,
+    NULL,
+    0,             /* flags */
+    0,NULL,NULL    /* reserved1,reserved2, etc */
+  },
 };
-static const ProtobufCIntRange server_response__response_type__value_ranges[] = {
-{1, 0},{0, 2}
+static const unsigned shard_handoff__field_indices_by_name[] = {
+  2,   /* field[2] = relayed */
+  0,   /* field[0] = ships */
+  1,   /* field[1] = trash */
 };
-static const ProtobufCEnumValueIndex server_response__response_type__enum_values_by_name[2] =
+static const ProtobufCIntRange shard_handoff__number_ranges[1 + 1] =
 {
-  { "CONNECT", 0 },
-  { "MOVEMENT", 1 },
+  { 1, 0 },
+  { 0, 3 }
 };
-const ProtobufCEnumDescriptor server_response__response_type__descriptor =
+const ProtobufCMessageDescriptor shard_handoff__descriptor =
 {
-  PROTOBUF_C__ENUM_DESCRIPTOR_MAGIC,
-  "server_response.ResponseType",
-  "ResponseType",
-  "ServerResponse__ResponseType",
+  PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
+  "shard_handoff",
+  "ShardHandoff",
+  "ShardHandoff",
   "",
-  2,
-  server_response__response_type__enum_values_by_number,
-  2,
-  server_response__response_type__enum_values_by_name,
-  1,
-  server_response__response_type__value_ranges,
-  NULL,NULL,NULL,NULL   /* reserved[1234] */
+  sizeof(ShardHandoff),
+  3,
+  shard_handoff__field_descriptors,
+  shard_handoff__field_indices_by_name,
+  1,  shard_handoff__number_ranges,
+  (ProtobufCMessageInit) shard_handoff__init,
+  NULL,NULL,NULL    /* reserved[123] */
 };
-static const ProtobufCFieldDescriptor server_response__field_descriptors[2] =
+static const ProtobufCFieldDescriptor shard_notice__field_descriptors[2] =
 {
   {
-    "type",
-    1,
+    "shard",
+    2,
     PROTOBUF_C_LABEL_REQUIRED,
-    PROTOBUF_C_TYPE_ENUM,
+    PROTOBUF_C_TYPE_SINT32,
     0,   /* quantifier_offset */
-    offsetof(ServerResponse, type),
-    &server_response__response_type__descriptor,
+    offsetof(ShardNotice, shard),
+    NULL,
     NULL,
     0,             /* flags */
     0,NULL,NULL    /* reserved1,reserved2, etc */
   },
   {
-    "success",
-    2,
+    "ship_id",
+    3,
     PROTOBUF_C_LABEL_REQUIRED,
-    PROTOBUF_C_TYPE_BOOL,
+    PROTOBUF_C_TYPE_UINT32,
     0,   /* quantifier_offset */
-    offsetof(ServerResponse, success),
+    offsetof(ShardNotice, ship_id),
     NULL,
     NULL,
     0,             /* flags */
     0,NULL,NULL    /* reserved1,reserved2, etc */
   },
 };
-static const unsigned server_response__field_indices_by_name[] = {
-  1,   /* field[1] = success */
-  0,   /* field[0] = type */
+static const unsigned shard_notice__field_indices_by_name[] = {
+  0,   /* field[0] = shard */
+  1,   /* field[1] = ship_id */
 };
-static const ProtobufCIntRange server_response__number_ranges[1 + 1] =
+static const ProtobufCIntRange shard_notice__number_ranges[1 + 1] =
 {
-  { 1, 0 },
+  { 2, 0 },
   { 0, 2 }
 };
-const ProtobufCMessageDescriptor server_response__descriptor =
+const ProtobufCMessageDescriptor shard_notice__descriptor =
 {
   PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,
-  "server_response",
-  "ServerResponse",
-  "ServerResponse",
+  "shard_notice",
+  "ShardNotice",
+  "ShardNotice",
   "",
-  sizeof(ServerResponse),
+  sizeof(ShardNotice),
   2,
-  server_response__field_descriptors,
-  server_response__field_indices_by_name,
-  1,  server_response__number_ranges,
-  (ProtobufCMessageInit) server_response__init,
+  shard_notice__field_descriptors,
+  shard_notice__field_indices_by_name,
+  1,  shard_notice__number_ranges,
+  (ProtobufCMessageInit) shard_notice__init,
   NULL,NULL,NULL    /* reserved[123] */
 };
@@ -18,14 +18,28 @@ PROTOBUF_C__BEGIN_DECLS
 typedef struct Position Position;
 typedef struct ConnectRequest ConnectRequest;
 typedef struct MovementRequest MovementRequest;
+typedef struct DisconnectRequest DisconnectRequest;
+typedef struct InputRequest InputRequest;
+typedef struct StatsRequest StatsRequest;
+typedef struct ClientMessage ClientMessage;
+typedef struct StageLatency StageLatency;
 typedef struct ServerResponse ServerResponse;
+typedef struct EntityState EntityState;
+typedef struct WorldUpdate WorldUpdate;
+typedef struct ShardShip ShardShip;
+typedef struct ShardTrash ShardTrash;
+typedef struct ShardHandoff ShardHandoff;
+typedef struct ShardNotice ShardNotice;
 
 
 /* --- enums --- */
 
 typedef enum _ServerResponse__ResponseType {
   SERVER_RESPONSE__RESPONSE_TYPE__CONNECT = 1,
-  SERVER_RESPONSE__RESPONSE_TYPE__MOVEMENT = 2
+  SERVER_RESPONSE__RESPONSE_TYPE__MOVEMENT = 2,
+  SERVER_RESPONSE__RESPONSE_TYPE__STATS = 3,
+  SERVER_RESPONSE__RESPONSE_TYPE__DISCONNECT = 4,
+  SERVER_RESPONSE__RESPONSE_TYPE__INPUT = 5
     PROTOBUF_C__FORCE_ENUM_TO_BE_INT_SIZE(SERVER_RESPONSE__RESPONSE_TYPE)
 } ServerResponse__ResponseType;
 
@@ -43,19 +57,29 @@ struct  Position
 
 
 /*
- * Client connection request - sent when client wants to connect with a letter
+ * Client connection request - sent when client wants to connect with a ship
  */
 struct  ConnectRequest
 {
   ProtobufCMessage base;
   /*
-   * The character/letter the client wants to use
+   * echoed in the response, see server_response
    */
-  ProtobufCBinaryData letter;
+  protobuf_c_boolean has_seq;
+  uint32_t seq;
+  /*
+   * client clock when sent, echoed in the response
+   */
+  protobuf_c_boolean has_sent_ns;
+  uint64_t sent_ns;
+  /*
+   * The ship the client wants to fly (see ship-id.h)
+   */
+  uint32_t ship_id;
 };
 #define CONNECT_REQUEST__INIT \
  { PROTOBUF_C_MESSAGE_INIT (&connect_request__descriptor) \
-    , {0,NULL} }
+    , 0, 0, 0, 0, 0 }
 
 
 /*
@@ -64,18 +88,148 @@ struct  ConnectRequest
 struct  MovementRequest
 {
   ProtobufCMessage base;
-  /*
-   * The character being moved
-   */
-  ProtobufCBinaryData letter;
   /*
    * Direction: 'u', 'd', 'l', 'r'
    */
   ProtobufCBinaryData direction;
+  /*
+   * Session token from the connect response
+   */
+  uint32_t token;
+  /*
+   * echoed in the response
+   */
+  protobuf_c_boolean has_seq;
+  uint32_t seq;
+  /*
+   * client clock when sent, echoed in the response
+   */
+  protobuf_c_boolean has_sent_ns;
+  uint64_t sent_ns;
+  /*
+   * The ship being moved
+   */
+  uint32_t ship_id;
 };
 #define MOVEMENT_REQUEST__INIT \
  { PROTOBUF_C_MESSAGE_INIT (&movement_request__descriptor) \
-    , {0,NULL}, {0,NULL} }
+    , {0,NULL}, 0, 0, 0, 0, 0, 0 }
+
+
+/*
+ * Client disconnect request - frees the ship and returns its cargo
+ */
+struct  DisconnectRequest
+{
+  ProtobufCMessage base;
+  uint32_t token;
+  uint32_t ship_id;
+};
+#define DISCONNECT_REQUEST__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&disconnect_request__descriptor) \
+    , 0, 0 }
+
+
+/*
+ * Client input state - sent when the set of held direction keys changes,
+ * the server moves the ship every tick while keys are held
+ */
+struct  InputRequest
+{
+  ProtobufCMessage base;
+  uint32_t token;
+  /*
+   * INPUT_UP | INPUT_DOWN | INPUT_LEFT | INPUT_RIGHT
+   */
+  uint32_t keys;
+  /*
+   * world updates were lost, send the whole region again
+   */
+  protobuf_c_boolean has_resync;
+  protobuf_c_boolean resync;
+  /*
+   * client numbering of its inputs, echoed in world updates and the response
+   */
+  protobuf_c_boolean has_seq;
+  uint32_t seq;
+  /*
+   * client clock when sent, echoed in the response
+   */
+  protobuf_c_boolean has_sent_ns;
+  uint64_t sent_ns;
+  uint32_t ship_id;
+};
+#define INPUT_REQUEST__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&input_request__descriptor) \
+    , 0, 0, 0, 0, 0, 0, 0, 0, 0 }
+
+
+/*
+ * Request for the server's latency histograms
+ */
+struct  StatsRequest
+{
+  ProtobufCMessage base;
+};
+#define STATS_REQUEST__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&stats_request__descriptor) \
+     }
+
+
+typedef enum {
+  CLIENT_MESSAGE__PAYLOAD__NOT_SET = 0,
+  CLIENT_MESSAGE__PAYLOAD_CONNECT = 1,
+  CLIENT_MESSAGE__PAYLOAD_MOVE = 2,
+  CLIENT_MESSAGE__PAYLOAD_STATS = 3,
+  CLIENT_MESSAGE__PAYLOAD_DISCONNECT = 4,
+  CLIENT_MESSAGE__PAYLOAD_INPUT = 5
+    PROTOBUF_C__FORCE_ENUM_TO_BE_INT_SIZE(CLIENT_MESSAGE__PAYLOAD__CASE)
+} ClientMessage__PayloadCase;
+
+/*
+ * Envelope for every client request - the server decodes it once and
+ * dispatches on the payload case
+ */
+struct  ClientMessage
+{
+  ProtobufCMessage base;
+  ClientMessage__PayloadCase payload_case;
+  union {
+    ConnectRequest *connect;
+    MovementRequest *move;
+    StatsRequest *stats;
+    DisconnectRequest *disconnect;
+    InputRequest *input;
+  };
+};
+#define CLIENT_MESSAGE__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&client_message__descriptor) \
+    , CLIENT_MESSAGE__PAYLOAD__NOT_SET, {0} }
+
+
+/*
+ * Latency percentiles of one processing stage of one command type
+ */
+struct  StageLatency
+{
+  ProtobufCMessage base;
+  /*
+   * CONNECT, MOVE
+   */
+  char *command;
+  /*
+   * wait, receive, decode, apply, reply, total
+   */
+  char *stage;
+  uint64_t count;
+  uint64_t p50_ns;
+  uint64_t p90_ns;
+  uint64_t p99_ns;
+  uint64_t max_ns;
+};
+#define STAGE_LATENCY__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&stage_latency__descriptor) \
+    , NULL, NULL, 0, 0, 0, 0, 0 }
 
 
 /*
@@ -92,10 +246,199 @@ struct  ServerResponse
    * true = OK/accepted, false = NOT OK/WALL
    */
   protobuf_c_boolean success;
+  /*
+   * only in STATS responses
+   */
+  size_t n_stats;
+  StageLatency **stats;
+  /*
+   * only in accepted CONNECT responses
+   */
+  protobuf_c_boolean has_token;
+  uint32_t token;
+  /*
+   * accepted CONNECT: lets the client predict its moves
+   */
+  protobuf_c_boolean has_tick_rate;
+  uint32_t tick_rate;
+  protobuf_c_boolean has_universe_width;
+  int32_t universe_width;
+  protobuf_c_boolean has_universe_height;
+  int32_t universe_height;
+  /*
+   * seq and sent_ns of the request answered, so the
+   */
+  protobuf_c_boolean has_echo_seq;
+  uint32_t echo_seq;
+  /*
+   * client measures the round trip it really sees
+   */
+  protobuf_c_boolean has_echo_sent_ns;
+  uint64_t echo_sent_ns;
 };
 #define SERVER_RESPONSE__INIT \
  { PROTOBUF_C_MESSAGE_INIT (&server_response__descriptor) \
-    , SERVER_RESPONSE__RESPONSE_TYPE__CONNECT, 0 }
+    , SERVER_RESPONSE__RESPONSE_TYPE__CONNECT, 0, 0,NULL, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }
+
+
+/*
+ * One entity inside the interest region of a ship
+ */
+struct  EntityState
+{
+  ProtobufCMessage base;
+  /*
+   * kind, generation and index, unique while it exists
+   */
+  uint64_t id;
+  /*
+   * 0 planet, 1 trash, 2 ship
+   */
+  uint32_t kind;
+  int32_t x;
+  int32_t y;
+  /*
+   * planets
+   */
+  protobuf_c_boolean has_name;
+  ProtobufCBinaryData name;
+  /*
+   * ships, the client shows its letter
+   */
+  protobuf_c_boolean has_ship_id;
+  uint32_t ship_id;
+};
+#define ENTITY_STATE__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&entity_state__descriptor) \
+    , 0, 0, 0, 0, 0, {0,NULL}, 0, 0 }
+
+
+/*
+ * What changed in the interest region of one ship since its previous update.
+ * Published after a tick with the ship id (4 bytes, big endian) as the topic frame.
+ */
+struct  WorldUpdate
+{
+  ProtobufCMessage base;
+  uint32_t tick;
+  /*
+   * per ship, a gap means an update was dropped
+   */
+  uint32_t seq;
+  /*
+   * entered lists the whole region, forget the rest
+   */
+  protobuf_c_boolean full;
+  size_t n_entered;
+  EntityState **entered;
+  size_t n_moved;
+  EntityState **moved;
+  size_t n_left;
+  uint64_t *left;
+  /*
+   * last input of this ship the server applied
+   */
+  protobuf_c_boolean has_ack_seq;
+  uint32_t ack_seq;
+  /*
+   * ticks the ship has moved since it applied it
+   */
+  protobuf_c_boolean has_ack_ticks;
+  uint32_t ack_ticks;
+};
+#define WORLD_UPDATE__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&world_update__descriptor) \
+    , 0, 0, 0, 0,NULL, 0,NULL, 0,NULL, 0, 0, 0, 0 }
+
+
+/*
+ * A ship crossing into the strip of another shard (see shard-map.h)
+ */
+struct  ShardShip
+{
+  ProtobufCMessage base;
+  float x;
+  float y;
+  /*
+   * session token, none for bots
+   */
+  protobuf_c_boolean has_token;
+  uint32_t token;
+  protobuf_c_boolean has_bot;
+  protobuf_c_boolean bot;
+  /*
+   * trash pieces carried
+   */
+  protobuf_c_boolean has_cargo;
+  uint32_t cargo;
+  /*
+   * held keys and the input that set them
+   */
+  protobuf_c_boolean has_input_keys;
+  uint32_t input_keys;
+  protobuf_c_boolean has_input_seq;
+  uint32_t input_seq;
+  protobuf_c_boolean has_input_ticks;
+  uint32_t input_ticks;
+  uint32_t ship_id;
+};
+#define SHARD_SHIP__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&shard_ship__descriptor) \
+    , 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }
+
+
+/*
+ * Trash drifting into the strip of another shard
+ */
+struct  ShardTrash
+{
+  ProtobufCMessage base;
+  float x;
+  float y;
+  float speed;
+  float angle;
+};
+#define SHARD_TRASH__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&shard_trash__descriptor) \
+    , 0, 0, 0, 0 }
+
+
+/*
+ * Everything one shard hands another after a tick
+ */
+struct  ShardHandoff
+{
+  ProtobufCMessage base;
+  size_t n_ships;
+  ShardShip **ships;
+  size_t n_trash;
+  ShardTrash **trash;
+  /*
+   * client_message requests that reached the shard a ship just left
+   */
+  size_t n_relayed;
+  ProtobufCBinaryData *relayed;
+};
+#define SHARD_HANDOFF__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&shard_handoff__descriptor) \
+    , 0,NULL, 0,NULL, 0,NULL }
+
+
+/*
+ * Tells the front-end where a player's ship is now
+ */
+struct  ShardNotice
+{
+  ProtobufCMessage base;
+  /*
+   * -1 once the ship left the universe
+   */
+  int32_t shard;
+  uint32_t ship_id;
+};
+#define SHARD_NOTICE__INIT \
+ { PROTOBUF_C_MESSAGE_INIT (&shard_notice__descriptor) \
+    , 0, 0 }
 
 
 /* Position methods */
@@ -155,6 +498,101 @@ MovementRequest *
 void   movement_request__free_unpacked
                      (MovementRequest *message,
                       ProtobufCAllocator *allocator);
+/* DisconnectRequest methods */
+void   disconnect_request__init
+                     (DisconnectRequest         *message);
+size_t disconnect_request__get_packed_size
+                     (const DisconnectRequest   *message);
+size_t disconnect_request__pack
+                     (const DisconnectRequest   *message,
+                      uint8_t             *out);
+size_t disconnect_request__pack_to_buffer
+                     (const DisconnectRequest   *message,
+                      ProtobufCBuffer     *buffer);
+DisconnectRequest *
+       disconnect_request__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data);
+void   disconnect_request__free_unpacked
+                     (DisconnectRequest *message,
+                      ProtobufCAllocator *allocator);
+/* InputRequest methods */
+void   input_request__init
+                     (InputRequest         *message);
+size_t input_request__get_packed_size
+                     (const InputRequest   *message);
+size_t input_request__pack
+                     (const InputRequest   *message,
+                      uint8_t             *out);
+size_t input_request__pack_to_buffer
+                     (const InputRequest   *message,
+                      ProtobufCBuffer     *buffer);
+InputRequest *
+       input_request__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data);
+void   input_request__free_unpacked
+                     (InputRequest *message,
+                      ProtobufCAllocator *allocator);
+/* StatsRequest methods */
+void   stats_request__init
+                     (StatsRequest         *message);
+size_t stats_request__get_packed_size
+                     (const StatsRequest   *message);
+size_t stats_request__pack
+                     (const StatsRequest   *message,
+                      uint8_t             *out);
+size_t stats_request__pack_to_buffer
+                     (const StatsRequest   *message,
+                      ProtobufCBuffer     *buffer);
+StatsRequest *
+       stats_request__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data);
+void   stats_request__free_unpacked
+                     (StatsRequest *message,
+                      ProtobufCAllocator *allocator);
+/* ClientMessage methods */
+void   client_message__init
+                     (ClientMessage         *message);
+size_t client_message__get_packed_size
+                     (const ClientMessage   *message);
+size_t client_message__pack
+                     (const ClientMessage   *message,
+                      uint8_t             *out);
+size_t client_message__pack_to_buffer
+                     (const ClientMessage   *message,
+                      ProtobufCBuffer     *buffer);
+ClientMessage *
+       client_message__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data);
+void   client_message__free_unpacked
+                     (ClientMessage *message,
+                      ProtobufCAllocator *allocator);
+/* StageLatency methods */
+void   stage_latency__init
+                     (StageLatency         *message);
+size_t stage_latency__get_packed_size
+                     (const StageLatency   *message);
+size_t stage_latency__pack
+                     (const StageLatency   *message,
+                      uint8_t             *out);
+size_t stage_latency__pack_to_buffer
+                     (const StageLatency   *message,
+                      ProtobufCBuffer     *buffer);
+StageLatency *
+       stage_latency__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data);
+void   stage_latency__free_unpacked
+                     (StageLatency *message,
+                      ProtobufCAllocator *allocator);
 /* ServerResponse methods */
 void   server_response__init
                      (ServerResponse         *message);
@@ -174,6 +612,120 @@ ServerResponse *
 void   server_response__free_unpacked
                      (ServerResponse *message,
                       ProtobufCAllocator *allocator);
+/* EntityState methods */
+void   entity_state__init
+                     (EntityState         *message);
+size_t entity_state__get_packed_size
+                     (const EntityState   *message);
+size_t entity_state__pack
+                     (const EntityState   *message,
+                      uint8_t             *out);
+size_t entity_state__pack_to_buffer
+                     (const EntityState   *message,
+                      ProtobufCBuffer     *buffer);
+EntityState *
+       entity_state__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data);
+void   entity_state__free_unpacked
+                     (EntityState *message,
+                      ProtobufCAllocator *allocator);
+/* WorldUpdate methods */
+void   world_update__init
+                     (WorldUpdate         *message);
+size_t world_update__get_packed_size
+                     (const WorldUpdate   *message);
+size_t world_update__pack
+                     (const WorldUpdate   *message,
+                      uint8_t             *out);
+size_t world_update__pack_to_buffer
+                     (const WorldUpdate   *message,
+                      ProtobufCBuffer     *buffer);
+WorldUpdate *
+       world_update__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data);
+void   world_update__free_unpacked
+                     (WorldUpdate *message,
+                      ProtobufCAllocator *allocator);
+/* ShardShip methods */
+void   shard_ship__init
+                     (ShardShip         *message);
+size_t shard_ship__get_packed_size
+                     (const ShardShip   *message);
+size_t shard_ship__pack
+                     (const ShardShip   *message,
+                      uint8_t             *out);
+size_t shard_ship__pack_to_buffer
+                     (const ShardShip   *message,
+                      ProtobufCBuffer     *buffer);
+ShardShip *
+       shard_ship__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data);
+void   shard_ship__free_unpacked
+                     (ShardShip *message,
+                      ProtobufCAllocator *allocator);
+/* ShardTrash methods */
+void   shard_trash__init
+                     (ShardTrash         *message);
+size_t shard_trash__get_packed_size
+                     (const ShardTrash   *message);
+size_t shard_trash__pack
+                     (const ShardTrash   *message,
+                      uint8_t             *out);
+size_t shard_trash__pack_to_buffer
+                     (const ShardTrash   *message,
+                      ProtobufCBuffer     *buffer);
+ShardTrash *
+       shard_trash__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data);
+void   shard_trash__free_unpacked
+                     (ShardTrash *message,
+                      ProtobufCAllocator *allocator);
+/* ShardHandoff methods */
+void   shard_handoff__init
+                     (ShardHandoff         *message);
+size_t shard_handoff__get_packed_size
+                     (const ShardHandoff   *message);
+size_t shard_handoff__pack
+                     (const ShardHandoff   *message,
+                      uint8_t             *out);
+size_t shard_handoff__pack_to_buffer
+                     (const ShardHandoff   *message,
+                      ProtobufCBuffer     *buffer);
+ShardHandoff *
+       shard_handoff__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data);
+void   shard_handoff__free_unpacked
+                     (ShardHandoff *message,
+                      ProtobufCAllocator *allocator);
+/* ShardNotice methods */
+void   shard_notice__init
+                     (ShardNotice         *message);
+size_t shard_notice__get_packed_size
+                     (const ShardNotice   *message);
+size_t shard_notice__pack
+                     (const ShardNotice   *message,
+                      uint8_t             *out);
+size_t shard_notice__pack_to_buffer
+                     (const ShardNotice   *message,
+                      ProtobufCBuffer     *buffer);
+ShardNotice *
+       shard_notice__unpack
+                     (ProtobufCAllocator  *allocator,
+                      size_t               len,
+                      const uint8_t       *data);
+void   shard_notice__free_unpacked
+                     (ShardNotice *message,
+                      ProtobufCAllocator *allocator);
 /* --- per-message closures --- */
 
 typedef void (*Position_Closure)
@@ -185,9 +737,42 @@ typedef void (*ConnectRequest_Closure)
 typedef void (*MovementRequest_Closure)
                  (const MovementRequest *message,
                   void *closure_data);
+typedef void (*DisconnectRequest_Closure)
+                 (const DisconnectRequest *message,
+                  void *closure_data);
+typedef void (*InputRequest_Closure)
+                 (const InputRequest *message,
+                  void *closure_data);
+typedef void (*StatsRequest_Closure)
+                 (const StatsRequest *message,
+                  void *closure_data);
+typedef void (*ClientMessage_Closure)
+                 (const ClientMessage *message,
+                  void *closure_data);
+typedef void (*StageLatency_Closure)
+                 (const StageLatency *message,
+                  void *closure_data);
 typedef void (*ServerResponse_Closure)
                  (const ServerResponse *message,
                   void *closure_data);
+typedef void (*EntityState_Closure)
+                 (const EntityState *message,
+                  void *closure_data);
+typedef void (*WorldUpdate_Closure)
+                 (const WorldUpdate *message,
+                  void *closure_data);
+typedef void (*ShardShip_Closure)
+                 (const ShardShip *message,
+                  void *closure_data);
+typedef void (*ShardTrash_Closure)
+                 (const ShardTrash *message,
+                  void *closure_data);
+typedef void (*ShardHandoff_Closure)
+                 (const ShardHandoff *message,
+                  void *closure_data);
+typedef void (*ShardNotice_Closure)
+                 (const ShardNotice *message,
+                  void *closure_data);
 
 /* --- services --- */
 
@@ -197,8 +782,19 @@ typedef void (*ServerResponse_Closure)
 extern const ProtobufCMessageDescriptor position__descriptor;
 extern const ProtobufCMessageDescriptor connect_request__descriptor;
 extern const ProtobufCMessageDescriptor movement_request__descriptor;
+extern const ProtobufCMessageDescriptor disconnect_request__descriptor;
+extern const ProtobufCMessageDescriptor input_request__descriptor;
+extern const ProtobufCMessageDescriptor stats_request__descriptor;
+extern const ProtobufCMessageDescriptor client_message__descriptor;
+extern const ProtobufCMessageDescriptor stage_latency__descriptor;
 extern const ProtobufCMessageDescriptor server_response__descriptor;
 extern const ProtobufCEnumDescriptor    server_response__response_type__descriptor;
+extern const ProtobufCMessageDescriptor entity_state__descriptor;
+extern const ProtobufCMessageDescriptor world_update__descriptor;
+extern const ProtobufCMessageDescriptor shard_ship__descriptor;
+extern const ProtobufCMessageDescriptor shard_trash__descriptor;
+extern const ProtobufCMessageDescriptor shard_handoff__descriptor;
+extern const ProtobufCMessageDescriptor shard_notice__descriptor;
 
 PROTOBUF_C__END_DECLS
 
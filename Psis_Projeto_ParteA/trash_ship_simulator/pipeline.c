@@ -0,0 +1,359 @@
+#define _GNU_SOURCE  // pthread_setaffinity_np
+#include "pipeline.h"
+#include <errno.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define STAGE_POLL_MS 100          // how often an idle stage looks at the stopping flag
+#define FULL_RING_POLL_MS 1        // the decode stage waiting for room in the requests ring
+#define REQUESTS_PER_WAKE 256      // read from the router before ringing the bell
+#define REPLIES_PER_WAKE 256       // forwarded to the router before reading it again
+
+// Pin thread to core, wrapping around the cores online
+static void pin_to_core(pthread_t thread, int core) {
+#ifdef __linux__
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cores > 0 ? core % cores : 0, &set);
+    int err = pthread_setaffinity_np(thread, sizeof(set), &set);
+    if (err != 0) {
+        fprintf(stderr, "Failed to pin a pipeline stage to core %d: %s\n", core, strerror(err));
+    }
+#else
+    (void)thread;
+    (void)core;
+#endif
+}
+
+// One end of an inproc PAIR, bound (bind) or connected to endpoint, that
+// queues up to hwm messages on each side (0 = no limit). Over inproc the
+// limits of both ends add up.
+static void *open_pair(const char *endpoint, bool bind, int hwm) {
+    void *socket = zmq_socket(get_comm_context(), ZMQ_PAIR);
+    zmq_setsockopt(socket, ZMQ_SNDHWM, &hwm, sizeof(hwm));
+    zmq_setsockopt(socket, ZMQ_RCVHWM, &hwm, sizeof(hwm));
+    int linger = 0;
+    zmq_setsockopt(socket, ZMQ_LINGER, &linger, sizeof(linger));
+
+    if ((bind ? zmq_bind(socket, endpoint) : zmq_connect(socket, endpoint)) != 0) {
+        fprintf(stderr, "Failed to open %s: %s\n", endpoint, zmq_strerror(zmq_errno()));
+        zmq_close(socket);
+        return NULL;
+    }
+    return socket;
+}
+
+static void ring_bell(void *bell) {
+    zmq_send(bell, "", 0, ZMQ_DONTWAIT);
+}
+
+// Wait up to timeout_ms for the bell, then take every ring of it
+// Returns 1 if it rang, 0 if not, -1 on error
+static int wait_bell(void *bell, int timeout_ms) {
+    int rang = wait_message(bell, timeout_ms);
+    if (rang > 0) {
+        char ignored;
+        while (zmq_recv(bell, &ignored, sizeof(ignored), ZMQ_DONTWAIT) >= 0) {
+        }
+    }
+    return rang;
+}
+
+// Drop the rest of a message whose first frames were already read
+static void drain_message(void *socket, int more) {
+    while (more) {
+        zmq_msg_t frame;
+        zmq_msg_init(&frame);
+        if (zmq_msg_recv(&frame, socket, 0) < 0) {
+            more = 0;
+        } else {
+            more = zmq_msg_more(&frame);
+        }
+        zmq_msg_close(&frame);
+    }
+}
+
+// Read one request waiting on the router into slot, envelope included
+// Returns 1 if one was read, 0 if none is waiting, -1 if it was dropped
+static int read_request(pipeline *p, pipeline_request *slot) {
+    zmq_msg_t frame;
+    zmq_msg_init(&frame);
+    slot->receive_start = latency_now_ns();
+    if (zmq_msg_recv(&frame, p->router, ZMQ_DONTWAIT) < 0) {
+        zmq_msg_close(&frame);
+        return 0;
+    }
+
+    // Routing frames, then the request in the last frame
+    slot->envelope.num_frames = 0;
+    int more = zmq_msg_more(&frame);
+    while (more) {
+        size_t size = zmq_msg_size(&frame);
+        if (slot->envelope.num_frames == PIPELINE_MAX_ENVELOPE || size > PIPELINE_MAX_ROUTE) {
+            zmq_msg_close(&frame);
+            drain_message(p->router, more);
+            return -1;  // could not be answered
+        }
+        int i = slot->envelope.num_frames++;
+        slot->envelope.sizes[i] = (uint8_t)size;
+        memcpy(slot->envelope.frames[i], zmq_msg_data(&frame), size);
+
+        zmq_msg_close(&frame);
+        zmq_msg_init(&frame);
+        if (zmq_msg_recv(&frame, p->router, 0) < 0) {
+            zmq_msg_close(&frame);
+            return -1;
+        }
+        more = zmq_msg_more(&frame);
+    }
+    if (slot->envelope.num_frames == 0) {
+        zmq_msg_close(&frame);
+        return -1;
+    }
+
+    slot->decode_start = latency_now_ns();
+    int size = (int)zmq_msg_size(&frame);
+    if (size > PIPELINE_MAX_FRAME) {
+        memset(&slot->request, 0, sizeof(slot->request));
+        slot->request.type = MSG_UNKNOWN;
+        slot->size = 0;
+    } else {
+        memcpy(slot->frame, zmq_msg_data(&frame), size);
+        slot->size = size;
+        // Ship-less requests keep their type, the apply stage refuses them
+        // with the reply the client expects
+        decode_message(slot->frame, size, &slot->request);
+    }
+    zmq_msg_close(&frame);
+    return 1;
+}
+
+static void *decode_main(void *data) {
+    pipeline *p = (pipeline*)data;
+    zmq_pollitem_t items[2];
+    items[0] = (zmq_pollitem_t){p->replies[1], 0, ZMQ_POLLIN, 0};
+    items[1] = (zmq_pollitem_t){p->router, 0, ZMQ_POLLIN, 0};
+
+    while (!atomic_load(&p->stopping)) {
+        // Only read clients while the apply stage has room for their requests
+        bool room = spsc_ring_reserve(&p->requests) != NULL;
+        if (zmq_poll(items, room ? 2 : 1, room ? STAGE_POLL_MS : FULL_RING_POLL_MS) < 0) {
+            continue;
+        }
+
+        if (items[0].revents & ZMQ_POLLIN) {
+            int forwarded = 0;
+            do {
+                forward_message(p->replies[1], p->router);
+            } while (++forwarded < REPLIES_PER_WAKE && wait_message(p->replies[1], 0) > 0);
+        }
+
+        if (room && (items[1].revents & ZMQ_POLLIN)) {
+            int queued = 0;
+            pipeline_request *slot;
+            while (queued < REQUESTS_PER_WAKE && (slot = spsc_ring_reserve(&p->requests)) != NULL) {
+                int result = read_request(p, slot);
+                if (result == 0) break;
+                if (result < 0) {
+                    atomic_fetch_add(&p->dropped, 1);
+                    continue;
+                }
+                spsc_ring_publish(&p->requests);
+                queued++;
+            }
+            if (queued > 0) {
+                ring_bell(p->request_bell[0]);
+            }
+        }
+    }
+    return NULL;
+}
+
+// Send one output: replies go back to the decode stage, envelope first
+static void send_output(pipeline *p, const pipeline_output *output) {
+    if (output->kind == OUTPUT_UPDATE) {
+        int size = send_world_update(p->publisher, output->ship, &output->update);
+        if (size > 0) {
+            atomic_fetch_add(&p->update_bytes, (uint64_t)size);
+        }
+        return;
+    }
+    for (int i = 0; i < output->envelope.num_frames; i++) {
+        zmq_send(p->replies[0], output->envelope.frames[i], output->envelope.sizes[i], ZMQ_SNDMORE);
+    }
+    send_server_reply(p->replies[0], &output->reply);
+}
+
+static void *encode_main(void *data) {
+    pipeline *p = (pipeline*)data;
+
+    while (!atomic_load(&p->stopping)) {
+        if (wait_bell(p->output_bell[1], STAGE_POLL_MS) < 0) {
+            continue;
+        }
+        pipeline_output *output;
+        while ((output = spsc_ring_peek(&p->outputs)) != NULL) {
+            send_output(p, output);
+            spsc_ring_release(&p->outputs);
+        }
+    }
+    return NULL;
+}
+
+static void close_sockets(pipeline *p) {
+    void **sockets[] = {p->request_bell, p->output_bell, p->replies};
+    for (int i = 0; i < 3; i++) {
+        for (int end = 0; end < 2; end++) {
+            if (sockets[i][end]) {
+                zmq_close(sockets[i][end]);
+                sockets[i][end] = NULL;
+            }
+        }
+    }
+}
+
+static void free_outputs(pipeline *p) {
+    if (!p->outputs.slots) return;
+    for (unsigned int i = 0; i < spsc_ring_capacity(&p->outputs); i++) {
+        pipeline_output *output = spsc_ring_slot(&p->outputs, i);
+        world_update_free(&output->update);
+    }
+}
+
+int pipeline_start(pipeline *p, void *router, void *publisher, int first_core) {
+    memset(p, 0, sizeof(*p));
+    p->router = router;
+    p->publisher = publisher;
+    atomic_init(&p->stopping, false);
+    atomic_init(&p->update_bytes, 0);
+    atomic_init(&p->dropped, 0);
+
+    if (spsc_ring_init(&p->requests, PIPELINE_RING_SLOTS, sizeof(pipeline_request)) != 0 ||
+        spsc_ring_init(&p->outputs, PIPELINE_RING_SLOTS, sizeof(pipeline_output)) != 0) {
+        pipeline_stop(p);
+        return -1;
+    }
+
+    // Created here, each end is then only used by the stage it belongs to
+    const char *endpoints[3] = {"inproc://pipeline-requests", "inproc://pipeline-outputs",
+                                "inproc://pipeline-replies"};
+    void **sockets[3] = {p->request_bell, p->output_bell, p->replies};
+    // Never block a stage: a bell holds at most two pending rings and ring_bell
+    // drops the rest without waiting, one pending ring is enough to wake the
+    // stage. Replies are bounded by the requests in flight.
+    int hwms[3] = {1, 1, 0};
+    for (int i = 0; i < 3; i++) {
+        sockets[i][1] = open_pair(endpoints[i], true, hwms[i]);
+        sockets[i][0] = sockets[i][1] ? open_pair(endpoints[i], false, hwms[i]) : NULL;
+        if (!sockets[i][0]) {
+            pipeline_stop(p);
+            return -1;
+        }
+    }
+
+    // Signals are left to the apply stage, the main thread
+    sigset_t all, previous;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, &previous);
+    int err = pthread_create(&p->decode_thread, NULL, decode_main, p);
+    if (err == 0) {
+        p->num_threads++;
+        err = pthread_create(&p->encode_thread, NULL, encode_main, p);
+        if (err == 0) {
+            p->num_threads++;
+        }
+    }
+    pthread_sigmask(SIG_SETMASK, &previous, NULL);
+    if (err != 0) {
+        fprintf(stderr, "Failed to start a pipeline stage: %s\n", strerror(err));
+        pipeline_stop(p);
+        return -1;
+    }
+
+    if (first_core >= 0) {
+        pin_to_core(p->decode_thread, first_core);
+        pin_to_core(pthread_self(), first_core + 1);
+        pin_to_core(p->encode_thread, first_core + 2);
+    }
+    return 0;
+}
+
+void pipeline_stop(pipeline *p) {
+    atomic_store(&p->stopping, true);
+    if (p->num_threads > 0) {
+        pthread_join(p->decode_thread, NULL);
+    }
+    if (p->num_threads > 1) {
+        pthread_join(p->encode_thread, NULL);
+    }
+    p->num_threads = 0;
+    close_sockets(p);
+    free_outputs(p);
+    spsc_ring_destroy(&p->requests);
+    spsc_ring_destroy(&p->outputs);
+}
+
+int pipeline_wait(pipeline *p, int timeout_ms) {
+    if (spsc_ring_peek(&p->requests) != NULL) {
+        return 1;
+    }
+    if (wait_bell(p->request_bell[1], timeout_ms) < 0) {
+        return -1;
+    }
+    return spsc_ring_peek(&p->requests) != NULL;
+}
+
+pipeline_request *pipeline_next_request(pipeline *p) {
+    return spsc_ring_peek(&p->requests);
+}
+
+void pipeline_request_done(pipeline *p) {
+    spsc_ring_release(&p->requests);
+}
+
+// The next output slot, once the encode stage made room for it
+static pipeline_output *reserve_output(pipeline *p) {
+    pipeline_output *output;
+    while ((output = spsc_ring_reserve(&p->outputs)) == NULL) {
+        ring_bell(p->output_bell[0]);
+        sched_yield();
+    }
+    return output;
+}
+
+void pipeline_send_reply(pipeline *p, const pipeline_request *request, const server_reply *reply) {
+    pipeline_output *output = reserve_output(p);
+    output->kind = OUTPUT_REPLY;
+    output->envelope = request->envelope;
+    output->reply = *reply;
+    if (reply->kind == REPLY_STATS) {
+        int count = reply->num_stats < PIPELINE_MAX_STATS ? reply->num_stats : PIPELINE_MAX_STATS;
+        memcpy(output->stats, reply->stats, sizeof(latency_summary) * count);
+        output->reply.stats = output->stats;
+        output->reply.num_stats = count;
+    }
+    spsc_ring_publish(&p->outputs);
+}
+
+int pipeline_send_update(pipeline *p, ship_id ship, const world_update *update) {
+    pipeline_output *output = reserve_output(p);
+    if (world_update_copy(&output->update, update) != 0) {
+        return -1;
+    }
+    output->kind = OUTPUT_UPDATE;
+    output->ship = ship;
+    spsc_ring_publish(&p->outputs);
+    return 0;
+}
+
+void pipeline_flush(pipeline *p) {
+    ring_bell(p->output_bell[0]);
+}
+
+uint64_t pipeline_update_bytes(pipeline *p) {
+    return atomic_load(&p->update_bytes);
+}
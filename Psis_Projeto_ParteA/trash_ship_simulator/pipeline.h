@@ -0,0 +1,105 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "latency-stats.h"
+#include "spsc-ring.h"
+#include "zmq-comm.h"
+
+// The server as three stages, each on its own thread and core:
+//   decode - receives client requests on the router, decodes and checks them
+//   apply  - the game thread: applies requests and runs the ticks, nothing else
+//   encode - encodes and sends the replies and world updates
+// Stages pass work through lock-free rings. ZeroMQ sockets belong to one
+// thread, so the encode stage hands encoded replies back to the decode
+// stage, which owns the router, over an inproc socket.
+
+#define PIPELINE_RING_SLOTS 1024  // requests, or replies and updates, between two stages
+#define PIPELINE_MAX_FRAME 512    // bigger requests are not valid ones
+#define PIPELINE_MAX_ENVELOPE 4   // routing frames before a request
+#define PIPELINE_MAX_ROUTE 32     // bytes of one routing frame
+#define PIPELINE_MAX_STATS 64     // rows of a stats reply
+
+// Routing frames of a request, sent back before its reply
+typedef struct {
+    int num_frames;
+    uint8_t sizes[PIPELINE_MAX_ENVELOPE];
+    uint8_t frames[PIPELINE_MAX_ENVELOPE][PIPELINE_MAX_ROUTE];
+} pipeline_envelope;
+
+// A request decoded by the decode stage, in latency_now_ns() time
+typedef struct {
+    pipeline_envelope envelope;
+    client_request request;
+    uint8_t frame[PIPELINE_MAX_FRAME];  // as received, to relay it to another shard
+    int size;
+    uint64_t receive_start;
+    uint64_t decode_start;
+} pipeline_request;
+
+typedef enum {
+    OUTPUT_REPLY,
+    OUTPUT_UPDATE
+} pipeline_output_kind;
+
+// A reply or world update waiting for the encode stage
+typedef struct {
+    pipeline_output_kind kind;
+    pipeline_envelope envelope;               // OUTPUT_REPLY
+    server_reply reply;
+    latency_summary stats[PIPELINE_MAX_STATS];  // rows reply.stats points to
+    ship_id ship;                             // OUTPUT_UPDATE: ship it is for
+    world_update update;                      // arrays owned by the slot, kept between uses
+} pipeline_output;
+
+typedef struct {
+    spsc_ring requests;         // decode -> apply
+    spsc_ring outputs;          // apply -> encode
+    void *router;               // clients, read and answered by the decode stage
+    void *publisher;            // world updates, sent by the encode stage
+    void *request_bell[2];      // decode -> apply: requests waiting ([0] sends, [1] receives)
+    void *output_bell[2];       // apply -> encode: outputs waiting
+    void *replies[2];           // encode -> decode: encoded replies, envelope first
+    pthread_t decode_thread;
+    pthread_t encode_thread;
+    int num_threads;            // started, joined by pipeline_stop
+    atomic_bool stopping;
+    atomic_uint_fast64_t update_bytes;  // world update payload sent
+    atomic_uint_fast64_t dropped;       // requests that could not be answered
+} pipeline;
+
+// Run the decode and encode stages on new threads, which take over router
+// (a ROUTER, see create_server_router) and publisher until pipeline_stop.
+// With first_core >= 0 the stages are pinned to first_core, first_core + 1
+// (the calling thread, the apply stage) and first_core + 2.
+// Returns 0 on success, -1 on error
+int pipeline_start(pipeline *p, void *router, void *publisher, int first_core);
+
+// Stop and join the stages; outputs not sent yet are dropped. The caller
+// closes router and publisher afterwards.
+void pipeline_stop(pipeline *p);
+
+// Apply stage: wait up to timeout_ms for decoded requests
+// Returns 1 if some are waiting, 0 if not, -1 on error
+int pipeline_wait(pipeline *p, int timeout_ms);
+
+// Apply stage: the oldest decoded request, NULL if none, and handing it back
+// once applied (after its reply was queued)
+pipeline_request *pipeline_next_request(pipeline *p);
+void pipeline_request_done(pipeline *p);
+
+// Apply stage: queue the reply to request or a world update for a ship,
+// waiting for room in the ring if the encode stage is behind. The encode
+// stage is woken by pipeline_flush.
+void pipeline_send_reply(pipeline *p, const pipeline_request *request, const server_reply *reply);
+// Returns 0 on success, -1 if the update could not be copied
+int pipeline_send_update(pipeline *p, ship_id ship, const world_update *update);
+void pipeline_flush(pipeline *p);
+
+// World update bytes the encode stage sent so far
+uint64_t pipeline_update_bytes(pipeline *p);
+
+#endif // PIPELINE_H
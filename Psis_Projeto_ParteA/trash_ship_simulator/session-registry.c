@@ -0,0 +1,106 @@
+#include "session-registry.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int session_registry_init(session_registry *registry, int capacity, int idle_timeout) {
+    memset(registry, 0, sizeof(*registry));
+    registry->sessions = (ship_session*)calloc(capacity > 0 ? capacity : 1, sizeof(ship_session));
+    registry->free_slots = (int*)malloc(sizeof(int) * (capacity > 0 ? capacity : 1));
+    if (!registry->sessions || !registry->free_slots || id_map_init(&registry->slots, capacity) != 0) {
+        fprintf(stderr, "Failed to allocate %d sessions\n", capacity);
+        free(registry->sessions);
+        free(registry->free_slots);
+        memset(registry, 0, sizeof(*registry));
+        return -1;
+    }
+    registry->capacity = capacity;
+    // Lowest slots first
+    for (int i = 0; i < capacity; i++) {
+        registry->free_slots[i] = capacity - 1 - i;
+    }
+    registry->num_free = capacity;
+    registry->idle_timeout_ns = idle_timeout > 0 ? (uint64_t)idle_timeout * 1000000000ull : 0;
+    return 0;
+}
+
+void session_registry_destroy(session_registry *registry) {
+    free(registry->sessions);
+    free(registry->free_slots);
+    id_map_destroy(&registry->slots);
+    memset(registry, 0, sizeof(*registry));
+}
+
+// Tokens only guard against stale or confused clients taking over a ship,
+// rand() is enough for that
+static uint32_t new_token() {
+    uint32_t token;
+    do {
+        token = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+    } while (token == 0);
+    return token;
+}
+
+// Session of id, NULL if it has none
+static ship_session *find(const session_registry *registry, ship_id id) {
+    int slot = id_map_get(&registry->slots, id);
+    return slot >= 0 ? &registry->sessions[slot] : NULL;
+}
+
+// A new active session for id, NULL if it has one or no slot is left
+static ship_session *start(session_registry *registry, ship_id id, uint32_t token, uint64_t now_ns) {
+    if (id == SHIP_ID_NONE || registry->num_free == 0 || find(registry, id) != NULL) {
+        return NULL;
+    }
+    int slot = registry->free_slots[registry->num_free - 1];
+    if (id_map_put(&registry->slots, id, slot) != 0) {
+        return NULL;
+    }
+    registry->num_free--;
+
+    ship_session *session = &registry->sessions[slot];
+    session->active = true;
+    session->id = id;
+    session->token = token;
+    session->last_seen_ns = now_ns;
+    return session;
+}
+
+uint32_t session_open(session_registry *registry, ship_id id, uint64_t now_ns) {
+    ship_session *session = start(registry, id, new_token(), now_ns);
+    return session ? session->token : 0;
+}
+
+bool session_adopt(session_registry *registry, ship_id id, uint32_t token, uint64_t now_ns) {
+    return start(registry, id, token, now_ns) != NULL;
+}
+
+bool session_touch(session_registry *registry, ship_id id, uint32_t token, uint64_t now_ns) {
+    ship_session *session = find(registry, id);
+    if (!session || session->token != token) {
+        return false;
+    }
+
+    session->last_seen_ns = now_ns;
+    return true;
+}
+
+void session_close(session_registry *registry, ship_id id) {
+    int slot = id_map_get(&registry->slots, id);
+    if (slot < 0) {
+        return;
+    }
+    registry->sessions[slot].active = false;
+    id_map_remove(&registry->slots, id);
+    registry->free_slots[registry->num_free++] = slot;
+}
+
+bool session_is_idle(const session_registry *registry, ship_id id, uint64_t now_ns) {
+    const ship_session *session = find(registry, id);
+    return session && registry->idle_timeout_ns > 0 &&
+           now_ns - session->last_seen_ns > registry->idle_timeout_ns;
+}
+
+int session_slot(const session_registry *registry, ship_id id) {
+    return id_map_get(&registry->slots, id);
+}
@@ -0,0 +1,55 @@
+#ifndef SESSION_REGISTRY_H
+#define SESSION_REGISTRY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "id-map.h"
+#include "ship-id.h"
+
+// Client sessions of the connected ships, found by ship id. Every open
+// session has a slot (0..capacity-1) that stays the same until it is
+// closed, so what else the server keeps per client lives in plain arrays.
+typedef struct {
+    bool active;
+    ship_id id;
+    uint32_t token;          // issued on connect, required by every request
+    uint64_t last_seen_ns;   // latency_now_ns() of the last valid request
+} ship_session;
+
+typedef struct {
+    ship_session *sessions;    // by slot
+    int capacity;
+    id_map slots;              // ship id -> slot of its session
+    int *free_slots;           // unused slots, taken from the end
+    int num_free;
+    uint64_t idle_timeout_ns;  // 0 = sessions never expire
+} session_registry;
+
+// Room for capacity sessions, idle_timeout in seconds (0 disables eviction)
+// Returns 0 on success, -1 on error
+int session_registry_init(session_registry *registry, int capacity, int idle_timeout);
+void session_registry_destroy(session_registry *registry);
+
+// Open a session for a ship id
+// Returns its token (never 0), or 0 if the id already has a session or
+// every slot is taken
+uint32_t session_open(session_registry *registry, ship_id id, uint64_t now_ns);
+
+// Take over the session of a ship that came from another shard, with the
+// token its client already has. Returns false if the id has a session here
+// or every slot is taken
+bool session_adopt(session_registry *registry, ship_id id, uint32_t token, uint64_t now_ns);
+
+// True if the id has a session with this token; refreshes its idle time
+bool session_touch(session_registry *registry, ship_id id, uint32_t token, uint64_t now_ns);
+
+// Close the session of a ship id (no-op if there is none)
+void session_close(session_registry *registry, ship_id id);
+
+// True if the id has a session that has been idle longer than the timeout
+bool session_is_idle(const session_registry *registry, ship_id id, uint64_t now_ns);
+
+// Slot of the session of a ship id, -1 if it has none
+int session_slot(const session_registry *registry, ship_id id);
+
+#endif // SESSION_REGISTRY_H
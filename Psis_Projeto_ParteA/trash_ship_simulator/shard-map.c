@@ -0,0 +1,40 @@
+#include "shard-map.h"
+#include <math.h>
+#include <stdio.h>
+
+void shard_map_init(shard_map *map, int index, int count, int width) {
+    map->index = index;
+    map->count = count;
+    map->width = width;
+}
+
+int shard_left(const shard_map *map, int shard) {
+    return (int)((long long)shard * map->width / map->count);
+}
+
+int shard_of(const shard_map *map, float x) {
+    int shard = (int)floorf(x * map->count / map->width);
+    if (shard < 0) return 0;
+    if (shard >= map->count) return map->count - 1;
+    // Rounding can put x one strip off near an edge
+    if (x < shard_left(map, shard)) return shard - 1;
+    if (shard + 1 < map->count && x >= shard_left(map, shard + 1)) return shard + 1;
+    return shard;
+}
+
+bool shard_owns(const shard_map *map, float x, float margin) {
+    if (map->count == 1) {
+        return true;
+    }
+    float left = shard_left(map, map->index);
+    float strip = shard_left(map, map->index + 1) - left;
+    float offset = fmodf(x - left + margin, (float)map->width);
+    if (offset < 0) {
+        offset += map->width;
+    }
+    return offset < strip + 2 * margin;
+}
+
+void shard_endpoint(char *endpoint, int size, const char *format, int shard) {
+    snprintf(endpoint, size, format, shard);
+}
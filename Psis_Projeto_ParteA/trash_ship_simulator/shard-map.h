@@ -0,0 +1,42 @@
+#ifndef SHARD_MAP_H
+#define SHARD_MAP_H
+
+#include <stdbool.h>
+
+// Split of the universe into vertical strips of equal width, one per server
+// process (shard). A shard simulates what lies in its strip and hands ships
+// and trash to the shard of the strip they drift into, the last strip's
+// right neighbour being the first one across the wraparound seam. Clients
+// reach the shards through universe_frontend, which routes each request to
+// the shard of its ship.
+typedef struct {
+    int index;   // this shard
+    int count;
+    int width;   // universe width
+} shard_map;
+
+// Endpoints on the local host, %d is the shard index
+#define SHARD_REQUEST_ENDPOINT "ipc:///tmp/universe-shard-%d.ipc"          // front-end -> shard requests
+#define SHARD_UPDATE_ENDPOINT  "ipc:///tmp/universe-shard-%d-updates.ipc"  // shard world updates
+#define SHARD_HANDOFF_ENDPOINT "ipc:///tmp/universe-shard-%d-handoff.ipc"  // shard -> shard handoffs
+#define SHARD_NOTICE_ENDPOINT  "ipc:///tmp/universe-frontend-notices.ipc"  // shard -> front-end ship owners
+
+// Things stay with their shard until this far past its strip, so a ship on
+// the edge is not handed back and forth every tick
+#define SHARD_HANDOFF_MARGIN 8
+
+void shard_map_init(shard_map *map, int index, int count, int width);
+
+// Left edge of the strip of a shard, the strip ends where the next one starts
+int shard_left(const shard_map *map, int shard);
+
+// Shard of the strip holding x (0 <= x < width)
+int shard_of(const shard_map *map, float x);
+
+// True if x is within margin of this shard's strip, across the seam too
+bool shard_owns(const shard_map *map, float x, float margin);
+
+// Endpoint of a shard from one of the formats above
+void shard_endpoint(char *endpoint, int size, const char *format, int shard);
+
+#endif // SHARD_MAP_H
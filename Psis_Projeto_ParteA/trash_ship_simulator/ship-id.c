@@ -0,0 +1,36 @@
+#include "ship-id.h"
+#include <stdio.h>
+
+bool ship_id_is_bot(ship_id id) {
+    return id >= SHIP_ID_FIRST_BOT;
+}
+
+// Players and bots are both numbered from 1
+static uint32_t ship_number(ship_id id) {
+    return ship_id_is_bot(id) ? id - SHIP_ID_FIRST_BOT + 1 : id;
+}
+
+char ship_id_letter(ship_id id) {
+    if (id == SHIP_ID_NONE) {
+        return '?';
+    }
+    char first = ship_id_is_bot(id) ? 'a' : 'A';
+    return (char)(first + (ship_number(id) - 1) % 26);
+}
+
+ship_id ship_id_from_letter(char letter) {
+    if (letter < 'A' || letter > 'Z') {
+        return SHIP_ID_NONE;
+    }
+    return (ship_id)(letter - 'A' + 1);
+}
+
+const char *ship_id_label(ship_id id, char *label, int size) {
+    uint32_t number = ship_number(id);
+    if (number <= 26) {
+        snprintf(label, size, "%c", ship_id_letter(id));
+    } else {
+        snprintf(label, size, "%c%u", ship_id_letter(id), number);
+    }
+    return label;
+}
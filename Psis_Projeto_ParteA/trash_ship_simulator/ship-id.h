@@ -0,0 +1,30 @@
+#ifndef SHIP_ID_H
+#define SHIP_ID_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Ships are known by a number, on the wire and in every table. Letters are
+// only how a ship is shown: ids 1..26 are A..Z, so a client started with a
+// letter gets that letter's ship, and bots count a..z from SHIP_ID_FIRST_BOT.
+typedef uint32_t ship_id;
+
+#define SHIP_ID_NONE 0                  // no ship, never a valid id
+#define SHIP_ID_FIRST_BOT 0x80000000u   // ids from here on are flown by the server
+#define SHIP_LABEL_LEN 16               // "A12345" and its terminating 0
+
+// Bots' ids can not be asked for by clients
+bool ship_id_is_bot(ship_id id);
+
+// Letter a ship is shown with: A..Z for players, a..z for bots, cycling
+char ship_id_letter(ship_id id);
+
+// Id of the ship of a letter ('A' is 1), SHIP_ID_NONE if it is not A..Z
+ship_id ship_id_from_letter(char letter);
+
+// How logs name a ship: its letter, followed by its number past the first
+// 26 players or bots, where the letters start over ("C", "C29", "a", "a30")
+// Returns label
+const char *ship_id_label(ship_id id, char *label, int size);
+
+#endif // SHIP_ID_H
@@ -0,0 +1,105 @@
+#include "spatial-grid.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static int clamp_index(int value, int count) {
+    if (value < 0) return 0;
+    if (value >= count) return count - 1;
+    return value;
+}
+
+// Positions outside the universe (before correct_position) go to the edge cells
+static int cell_of(const spatial_grid *grid, float x, float y) {
+    int col = clamp_index((int)floorf(x / grid->cell_size), grid->cols);
+    int row = clamp_index((int)floorf(y / grid->cell_size), grid->rows);
+    return row * grid->cols + col;
+}
+
+int spatial_grid_init(spatial_grid *grid, int width, int height, float cell_size, int max_items) {
+    grid->cell_size = cell_size;
+    grid->cols = (int)ceilf(width / cell_size);
+    grid->rows = (int)ceilf(height / cell_size);
+    grid->max_items = max_items;
+    if (grid->cols < 1) grid->cols = 1;
+    if (grid->rows < 1) grid->rows = 1;
+
+    int num_cells = grid->cols * grid->rows;
+    int items = max_items > 0 ? max_items : 1;
+    grid->head = (int*)malloc(sizeof(int) * num_cells);
+    grid->next = (int*)malloc(sizeof(int) * items);
+    grid->prev = (int*)malloc(sizeof(int) * items);
+    grid->cell = (int*)malloc(sizeof(int) * items);
+    if (!grid->head || !grid->next || !grid->prev || !grid->cell) {
+        fprintf(stderr, "Failed to allocate spatial grid\n");
+        spatial_grid_destroy(grid);
+        return -1;
+    }
+
+    for (int i = 0; i < num_cells; i++) {
+        grid->head[i] = -1;
+    }
+    for (int i = 0; i < items; i++) {
+        grid->next[i] = grid->prev[i] = grid->cell[i] = -1;
+    }
+    return 0;
+}
+
+void spatial_grid_destroy(spatial_grid *grid) {
+    free(grid->head);
+    free(grid->next);
+    free(grid->prev);
+    free(grid->cell);
+    grid->head = grid->next = grid->prev = grid->cell = NULL;
+}
+
+static void link_item(spatial_grid *grid, int item, int cell) {
+    grid->cell[item] = cell;
+    grid->prev[item] = -1;
+    grid->next[item] = grid->head[cell];
+    if (grid->head[cell] != -1) {
+        grid->prev[grid->head[cell]] = item;
+    }
+    grid->head[cell] = item;
+}
+
+static void unlink_item(spatial_grid *grid, int item) {
+    int cell = grid->cell[item];
+    if (grid->prev[item] != -1) {
+        grid->next[grid->prev[item]] = grid->next[item];
+    } else {
+        grid->head[cell] = grid->next[item];
+    }
+    if (grid->next[item] != -1) {
+        grid->prev[grid->next[item]] = grid->prev[item];
+    }
+    grid->cell[item] = grid->next[item] = grid->prev[item] = -1;
+}
+
+void spatial_grid_insert(spatial_grid *grid, int item, float x, float y) {
+    if (item < 0 || item >= grid->max_items || grid->cell[item] != -1) return;
+    link_item(grid, item, cell_of(grid, x, y));
+}
+
+void spatial_grid_remove(spatial_grid *grid, int item) {
+    if (item < 0 || item >= grid->max_items || grid->cell[item] == -1) return;
+    unlink_item(grid, item);
+}
+
+void spatial_grid_move(spatial_grid *grid, int item, float x, float y) {
+    if (item < 0 || item >= grid->max_items || grid->cell[item] == -1) return;
+
+    int cell = cell_of(grid, x, y);
+    if (cell != grid->cell[item]) {
+        unlink_item(grid, item);
+        link_item(grid, item, cell);
+    }
+}
+
+void spatial_grid_cell_range(const spatial_grid *grid, float x, float y, float radius,
+                             int *col_min, int *row_min, int *col_max, int *row_max) {
+    *col_min = clamp_index((int)floorf((x - radius) / grid->cell_size), grid->cols);
+    *row_min = clamp_index((int)floorf((y - radius) / grid->cell_size), grid->rows);
+    *col_max = clamp_index((int)floorf((x + radius) / grid->cell_size), grid->cols);
+    *row_max = clamp_index((int)floorf((y + radius) / grid->cell_size), grid->rows);
+}
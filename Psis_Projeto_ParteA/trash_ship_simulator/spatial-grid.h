@@ -0,0 +1,41 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+// Uniform grid over the universe for collision queries. Items are indexes
+// into an array owned by the caller (trash, planets); every cell keeps a
+// doubly linked list of the items whose position falls inside it, so
+// inserting, removing and moving an item are O(1).
+typedef struct {
+    float cell_size;
+    int cols;
+    int rows;
+    int max_items;
+    int *head;   // first item of each cell, -1 if the cell is empty
+    int *next;   // next item in the same cell, -1 at the end
+    int *prev;   // previous item in the same cell, -1 at the start
+    int *cell;   // cell holding each item, -1 if the item is not in the grid
+} spatial_grid;
+
+// Allocate a grid covering width x height for items 0..max_items-1
+// Returns 0 on success, -1 on error
+int spatial_grid_init(spatial_grid *grid, int width, int height, float cell_size, int max_items);
+
+// Free the grid arrays
+void spatial_grid_destroy(spatial_grid *grid);
+
+// Add an item at a position (it must not already be in the grid)
+void spatial_grid_insert(spatial_grid *grid, int item, float x, float y);
+
+// Take an item out of the grid (no-op if it is not in it)
+void spatial_grid_remove(spatial_grid *grid, int item);
+
+// Update the position of an item already in the grid
+void spatial_grid_move(spatial_grid *grid, int item, float x, float y);
+
+// Inclusive range of cells overlapping the square of half side radius
+// around (x, y). Walk each cell with:
+//   for (int i = grid->head[row * grid->cols + col]; i != -1; i = grid->next[i])
+void spatial_grid_cell_range(const spatial_grid *grid, float x, float y, float radius,
+                             int *col_min, int *row_min, int *col_max, int *row_max);
+
+#endif // SPATIAL_GRID_H
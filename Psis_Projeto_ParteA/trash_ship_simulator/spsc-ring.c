@@ -0,0 +1,61 @@
+#include "spsc-ring.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+int spsc_ring_init(spsc_ring *ring, unsigned int capacity, size_t slot_size) {
+    unsigned int size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    ring->mask = size - 1;
+    ring->slot_size = slot_size;
+    ring->slots = (uint8_t*)calloc(size, slot_size);
+    if (!ring->slots) {
+        fprintf(stderr, "Failed to allocate ring of %u slots\n", size);
+        return -1;
+    }
+    return 0;
+}
+
+void spsc_ring_destroy(spsc_ring *ring) {
+    free(ring->slots);
+    ring->slots = NULL;
+}
+
+void *spsc_ring_reserve(spsc_ring *ring) {
+    unsigned int tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    unsigned int head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    if (tail - head > ring->mask) {
+        return NULL;
+    }
+    return ring->slots + (size_t)(tail & ring->mask) * ring->slot_size;
+}
+
+void spsc_ring_publish(spsc_ring *ring) {
+    unsigned int tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+}
+
+void *spsc_ring_peek(spsc_ring *ring) {
+    unsigned int head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    unsigned int tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head == tail) {
+        return NULL;
+    }
+    return ring->slots + (size_t)(head & ring->mask) * ring->slot_size;
+}
+
+void spsc_ring_release(spsc_ring *ring) {
+    unsigned int head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+void *spsc_ring_slot(spsc_ring *ring, unsigned int i) {
+    return ring->slots + (size_t)(i & ring->mask) * ring->slot_size;
+}
+
+unsigned int spsc_ring_capacity(const spsc_ring *ring) {
+    return ring->mask + 1;
+}
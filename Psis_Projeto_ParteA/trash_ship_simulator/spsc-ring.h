@@ -0,0 +1,40 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Fixed size slots passed from exactly one producer thread to exactly one
+// consumer thread without locks. The producer fills a slot in place and
+// publishes it, the consumer reads it in place and releases it, so a slot
+// can own buffers that are reused once it comes around again. The indexes
+// sit on their own cache lines so the two threads do not share one.
+typedef struct {
+    _Alignas(64) atomic_uint head;  // next slot to read, written by the consumer
+    _Alignas(64) atomic_uint tail;  // next slot to fill, written by the producer
+    _Alignas(64) uint8_t *slots;
+    size_t slot_size;
+    unsigned int mask;              // capacity - 1, capacity is a power of two
+} spsc_ring;
+
+// Allocate capacity slots of slot_size bytes, zeroed (capacity is rounded
+// up to a power of two). Returns 0 on success, -1 on error
+int spsc_ring_init(spsc_ring *ring, unsigned int capacity, size_t slot_size);
+void spsc_ring_destroy(spsc_ring *ring);
+
+// Producer: the slot to fill next, NULL if the ring is full
+void *spsc_ring_reserve(spsc_ring *ring);
+// Producer: hand the reserved slot to the consumer
+void spsc_ring_publish(spsc_ring *ring);
+
+// Consumer: the oldest published slot, NULL if the ring is empty
+void *spsc_ring_peek(spsc_ring *ring);
+// Consumer: give the peeked slot back to the producer
+void spsc_ring_release(spsc_ring *ring);
+
+// Slot i of the ring in storage order, to set up or free what slots own
+void *spsc_ring_slot(spsc_ring *ring, unsigned int i);
+unsigned int spsc_ring_capacity(const spsc_ring *ring);
+
+#endif // SPSC_RING_H
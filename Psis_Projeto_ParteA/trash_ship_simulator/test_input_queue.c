@@ -0,0 +1,173 @@
+#include "input-queue.h"
+#include <stdio.h>
+#include <string.h>
+
+int test_coalescing() {
+    printf("\n=== Testing Move Coalescing ===\n");
+
+    int errors = 0;
+    input_queue queue;
+    input_queue_stats stats;
+    memset(&stats, 0, sizeof(stats));
+    input_queue_clear(&queue);
+
+    // Twenty moves right become moves of at most MAX_COALESCED_STEPS steps
+    for (int i = 0; i < 20; i++) {
+        input_queue_push_move(&queue, 'r', i, &stats);
+    }
+    input_queue_push_move(&queue, 'u', 20, &stats);
+    int expected[] = {MAX_COALESCED_STEPS, MAX_COALESCED_STEPS, 20 - 2 * MAX_COALESCED_STEPS};
+    queued_move move;
+    for (int i = 0; i < 3; i++) {
+        if (!input_queue_pop_move(&queue, 20, &move, &stats)) {
+            errors++;
+            continue;
+        }
+        errors += move.direction != 'r' || move.steps != expected[i];
+        errors += move.enqueued_ns != (uint64_t)(i * MAX_COALESCED_STEPS);
+    }
+    errors += !input_queue_pop_move(&queue, 20, &move, &stats) || move.direction != 'u' || move.steps != 1;
+    errors += input_queue_pop_move(&queue, 20, &move, &stats);
+    errors += stats.moves != 21 || stats.coalesced != 17;
+    printf("%llu moves, %llu coalesced: %d errors\n",
+           (unsigned long long)stats.moves, (unsigned long long)stats.coalesced, errors);
+    return errors;
+}
+
+int test_full_queue() {
+    printf("\n=== Testing Full Queue ===\n");
+
+    int errors = 0;
+    input_queue queue;
+    input_queue_stats stats;
+    memset(&stats, 0, sizeof(stats));
+    input_queue_clear(&queue);
+
+    // A five-step move, then alternating single moves until three more
+    // than fit: the oldest entries go first, counted in steps
+    for (int i = 0; i < 5; i++) {
+        input_queue_push_move(&queue, 'l', 0, &stats);
+    }
+    for (int i = 0; i < INPUT_QUEUE_CAPACITY + 2; i++) {
+        input_queue_push_move(&queue, i % 2 ? 'd' : 'u', 1 + i, &stats);
+    }
+    errors += queue.count != INPUT_QUEUE_CAPACITY;
+    errors += stats.dropped_full != 5 + 2;
+
+    queued_move move;
+    int popped = 0;
+    while (input_queue_pop_move(&queue, INPUT_QUEUE_CAPACITY + 2, &move, &stats)) {
+        errors += move.steps != 1 || move.enqueued_ns != (uint64_t)(3 + popped);
+        popped++;
+    }
+    errors += popped != INPUT_QUEUE_CAPACITY;
+    printf("%d moves kept, %llu steps dropped: %d errors\n",
+           popped, (unsigned long long)stats.dropped_full, errors);
+    return errors;
+}
+
+int test_stale_moves() {
+    printf("\n=== Testing Stale Moves ===\n");
+
+    int errors = 0;
+    input_queue queue;
+    input_queue_stats stats;
+    memset(&stats, 0, sizeof(stats));
+    input_queue_clear(&queue);
+
+    // The coalesced moves right are one nanosecond too old, the move down
+    // is exactly at the limit
+    uint64_t start = 1000;
+    input_queue_push_move(&queue, 'r', start, &stats);
+    input_queue_push_move(&queue, 'r', start, &stats);
+    input_queue_push_move(&queue, 'd', start + 1, &stats);
+    input_queue_push_move(&queue, 'l', start + 2, &stats);
+
+    queued_move move;
+    uint64_t now = start + 1 + INPUT_STALE_NS;
+    errors += !input_queue_pop_move(&queue, now, &move, &stats) || move.direction != 'd';
+    errors += stats.dropped_stale != 2;
+    errors += !input_queue_pop_move(&queue, now, &move, &stats) || move.direction != 'l';
+
+    // Nothing but stale moves leaves the queue empty
+    input_queue_push_move(&queue, 'u', start, &stats);
+    errors += input_queue_pop_move(&queue, now, &move, &stats);
+    errors += queue.count != 0 || stats.dropped_stale != 3;
+    printf("%llu stale steps dropped: %d errors\n", (unsigned long long)stats.dropped_stale, errors);
+    return errors;
+}
+
+int test_keys_replaced() {
+    printf("\n=== Testing Held Keys ===\n");
+
+    int errors = 0;
+    input_queue queue;
+    input_queue_stats stats;
+    memset(&stats, 0, sizeof(stats));
+    input_queue_clear(&queue);
+
+    // Only the latest state waits for the tick
+    input_queue_push_keys(&queue, 0x1, 1, 10, &stats);
+    input_queue_push_keys(&queue, 0x3, 2, 20, &stats);
+    input_queue_push_keys(&queue, 0x2, 3, 30, &stats);
+    errors += !queue.has_keys || queue.keys != 0x2 || queue.seq != 3 || queue.keys_ns != 30;
+    errors += stats.keys_replaced != 2;
+
+    // Once the tick took it, the next state replaces nothing
+    queue.has_keys = false;
+    input_queue_push_keys(&queue, 0x4, 4, 40, &stats);
+    errors += stats.keys_replaced != 2 || queue.keys != 0x4;
+
+    // Held keys and moves do not get in each other's way
+    input_queue_push_move(&queue, 'u', 40, &stats);
+    errors += queue.count != 1 || !queue.has_keys;
+    printf("%llu key states replaced: %d errors\n", (unsigned long long)stats.keys_replaced, errors);
+    return errors;
+}
+
+int test_flooding_client() {
+    printf("\n=== Testing Flooding Client ===\n");
+
+    int errors = 0;
+    input_queue flooder, player;
+    input_queue_stats stats;
+    memset(&stats, 0, sizeof(stats));
+    input_queue_clear(&flooder);
+    input_queue_clear(&player);
+
+    // Thousands of moves from one client, two from another in between
+    for (int i = 0; i < 5000; i++) {
+        input_queue_push_move(&flooder, i % 2 ? 'l' : 'r', i, &stats);
+        if (i == 2500) {
+            input_queue_push_move(&player, 'u', i, &stats);
+            input_queue_push_move(&player, 'd', i, &stats);
+        }
+    }
+    errors += flooder.count != INPUT_QUEUE_CAPACITY;
+    errors += stats.dropped_full != 5000 - INPUT_QUEUE_CAPACITY;
+
+    queued_move move;
+    errors += !input_queue_pop_move(&player, 5000, &move, &stats) || move.direction != 'u';
+    errors += !input_queue_pop_move(&player, 5000, &move, &stats) || move.direction != 'd';
+    errors += input_queue_pop_move(&player, 5000, &move, &stats);
+
+    // The flooder keeps only its newest moves
+    errors += !input_queue_pop_move(&flooder, 5000, &move, &stats);
+    errors += move.enqueued_ns != 5000 - INPUT_QUEUE_CAPACITY;
+    printf("Flooder holds %d moves, player got both of its own: %d errors\n",
+           flooder.count + 1, errors);
+    return errors;
+}
+
+int main() {
+    printf("=== Input Queue Tests ===\n");
+
+    int failures = test_coalescing();
+    failures += test_full_queue();
+    failures += test_stale_moves();
+    failures += test_keys_replaced();
+    failures += test_flooding_client();
+
+    printf("\n=== All input queue tests completed: %s ===\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,95 @@
+#include "pipeline.h"
+#include <stdio.h>
+#include <string.h>
+
+#define ROUTER_ENDPOINT "inproc://test-pipeline-router"
+#define PUBLISHER_ENDPOINT "inproc://test-pipeline-updates"
+
+// Play the apply stage for one request: check what the decode stage made of
+// it and refuse it the way apply_request does a ship-less one
+static int refuse_next(pipeline *p, message_type_t expected_type) {
+    // A bell left from an earlier request may wake the wait before this one
+    // is queued, so wait again like the apply stage does
+    int waiting = 0;
+    for (int tries = 0; tries < 10 && waiting == 0; tries++) {
+        waiting = pipeline_wait(p, 100);
+    }
+    if (waiting <= 0) {
+        printf("No request reached the apply stage\n");
+        return 1;
+    }
+    pipeline_request *queued = pipeline_next_request(p);
+    if (!queued) {
+        return 1;
+    }
+    int errors = queued->request.type != expected_type || queued->request.ship != SHIP_ID_NONE;
+
+    server_reply reply;
+    memset(&reply, 0, sizeof(reply));
+    reply.kind = queued->request.type == MSG_CONNECT ? REPLY_CONNECT : REPLY_RESULT;
+    reply.request = queued->request;
+    pipeline_send_reply(p, queued, &reply);
+    pipeline_request_done(p);
+    pipeline_flush(p);
+    return errors;
+}
+
+int test_refused_requests() {
+    printf("\n=== Testing Replies to Ship-less and Unknown Requests ===\n");
+
+    const char *endpoint = ROUTER_ENDPOINT;
+    const char *update_endpoint = PUBLISHER_ENDPOINT;
+    void *router = create_server_router(&endpoint, 1);
+    void *publisher = create_update_publisher(&update_endpoint, 1);
+    pipeline p;
+    if (!router || !publisher || pipeline_start(&p, router, publisher, -1) != 0) {
+        printf("Failed to start the pipeline\n");
+        return 1;
+    }
+    void *client = zmq_socket(get_comm_context(), ZMQ_REQ);
+    int timeout_ms = 1000;
+    zmq_setsockopt(client, ZMQ_RCVTIMEO, &timeout_ms, sizeof(timeout_ms));
+    zmq_connect(client, ROUTER_ENDPOINT);
+
+    int errors = 0;
+    char message[64];
+    session_info info;
+
+    // A connect without a ship is refused as a connect, with no token
+    send_connection_message(client, SHIP_ID_NONE, 1);
+    errors += refuse_next(&p, MSG_CONNECT);
+    receive_connect_response(client, message, &info, NULL);
+    printf("Connect without a ship: %s\n", message);
+    errors += strcmp(message, "NOT OK") != 0 || info.token != 0;
+
+    // So are moves without one
+    send_movement_message(client, SHIP_ID_NONE, 0, 'u', 2);
+    errors += refuse_next(&p, MSG_MOVE);
+    receive_response(client, message, NULL);
+    printf("Move without a ship: %s\n", message);
+    errors += strcmp(message, "BAD MOVEMENT") != 0;
+
+    // A frame that does not decode is answered, and never with OK
+    const uint8_t garbage[] = {0xff, 0xff, 0xff, 0xff};
+    zmq_send(client, garbage, sizeof(garbage), 0);
+    errors += refuse_next(&p, MSG_UNKNOWN);
+    receive_response(client, message, NULL);
+    printf("Unknown request: %s\n", message);
+    errors += strcmp(message, "NOT OK") != 0;
+
+    zmq_close(client);
+    pipeline_stop(&p);
+    zmq_close(router);
+    zmq_close(publisher);
+    return errors;
+}
+
+int main() {
+    printf("=== Pipeline Tests ===\n");
+
+    int failures = test_refused_requests();
+
+    zmq_ctx_term(get_comm_context());
+    printf("\n=== All pipeline tests completed: %s ===\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
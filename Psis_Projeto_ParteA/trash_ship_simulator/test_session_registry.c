@@ -0,0 +1,148 @@
+#include "session-registry.h"
+#include <stdio.h>
+
+#define CAPACITY 4
+#define IDLE_TIMEOUT 10  // seconds
+#define NS_PER_S 1000000000ull
+
+int test_slot_reuse() {
+    printf("\n=== Testing Slot Reuse ===\n");
+
+    session_registry registry;
+    if (session_registry_init(&registry, CAPACITY, IDLE_TIMEOUT) != 0) {
+        printf("Failed to create session registry\n");
+        return 1;
+    }
+    int errors = 0;
+
+    // Every open session gets a slot of its own
+    int used[CAPACITY] = {0};
+    for (ship_id id = 1; id <= CAPACITY; id++) {
+        errors += session_open(&registry, id, 0) == 0;
+        int slot = session_slot(&registry, id);
+        if (slot < 0 || slot >= CAPACITY || used[slot]++) errors++;
+    }
+
+    // A closed slot goes to the next ship, and the old id is forgotten
+    int freed = session_slot(&registry, 2);
+    session_close(&registry, 2);
+    errors += session_slot(&registry, 2) != -1 || registry.sessions[freed].active;
+    session_close(&registry, 2);
+    errors += registry.num_free != 1;
+    errors += session_open(&registry, 7, 0) == 0 || session_slot(&registry, 7) != freed;
+    errors += registry.sessions[freed].id != 7 || !registry.sessions[freed].active;
+
+    // The same ship may connect again once its session is closed, not before
+    errors += session_open(&registry, 3, 0) != 0;
+    session_close(&registry, 3);
+    errors += session_open(&registry, 3, 0) == 0;
+    printf("%d slots, %d free: %d errors\n", registry.capacity, registry.num_free, errors);
+
+    session_registry_destroy(&registry);
+    return errors;
+}
+
+int test_tokens() {
+    printf("\n=== Testing Tokens ===\n");
+
+    session_registry registry;
+    if (session_registry_init(&registry, CAPACITY, IDLE_TIMEOUT) != 0) {
+        printf("Failed to create session registry\n");
+        return 1;
+    }
+    int errors = 0;
+
+    uint32_t token = session_open(&registry, 5, 0);
+    errors += token == 0;
+    errors += !session_touch(&registry, 5, token, NS_PER_S);
+
+    // A wrong token neither passes nor refreshes the session
+    errors += session_touch(&registry, 5, token + 1, 2 * NS_PER_S);
+    errors += session_touch(&registry, 6, token, 2 * NS_PER_S);
+    errors += registry.sessions[session_slot(&registry, 5)].last_seen_ns != NS_PER_S;
+
+    // An adopted session keeps the token its client already has
+    errors += !session_adopt(&registry, 6, 0x1234u, 0);
+    errors += !session_touch(&registry, 6, 0x1234u, 0);
+    errors += session_adopt(&registry, 6, 0x1234u, 0);
+    errors += session_open(&registry, SHIP_ID_NONE, 0) != 0;
+    printf("%d errors\n", errors);
+
+    session_registry_destroy(&registry);
+    return errors;
+}
+
+int test_idle_timeout() {
+    printf("\n=== Testing Idle Timeout ===\n");
+
+    session_registry registry;
+    if (session_registry_init(&registry, CAPACITY, IDLE_TIMEOUT) != 0) {
+        printf("Failed to create session registry\n");
+        return 1;
+    }
+    int errors = 0;
+
+    // Idle only once more than the timeout has passed since the last request
+    uint64_t start = 5 * NS_PER_S;
+    uint64_t timeout = IDLE_TIMEOUT * NS_PER_S;
+    uint32_t token = session_open(&registry, 1, start);
+    errors += session_is_idle(&registry, 1, start + timeout);
+    errors += !session_is_idle(&registry, 1, start + timeout + 1);
+    errors += !session_touch(&registry, 1, token, start + timeout);
+    errors += session_is_idle(&registry, 1, start + timeout + 1);
+    errors += session_is_idle(&registry, 2, start + 10 * timeout);
+    session_registry_destroy(&registry);
+
+    // A timeout of 0 never evicts
+    if (session_registry_init(&registry, CAPACITY, 0) != 0) {
+        printf("Failed to create session registry\n");
+        return errors + 1;
+    }
+    session_open(&registry, 1, 0);
+    errors += session_is_idle(&registry, 1, 1000 * NS_PER_S);
+    printf("%d errors\n", errors);
+
+    session_registry_destroy(&registry);
+    return errors;
+}
+
+int test_full_registry() {
+    printf("\n=== Testing Full Registry ===\n");
+
+    session_registry registry;
+    if (session_registry_init(&registry, CAPACITY, IDLE_TIMEOUT) != 0) {
+        printf("Failed to create session registry\n");
+        return 1;
+    }
+    int errors = 0;
+
+    for (ship_id id = 1; id <= CAPACITY; id++) {
+        errors += session_open(&registry, id, 0) == 0;
+    }
+
+    // Once every slot is taken, new ships are refused, also from other shards
+    errors += session_open(&registry, CAPACITY + 1, 0) != 0;
+    errors += session_adopt(&registry, SHIP_ID_FIRST_BOT, 0x1234u, 0);
+    errors += session_slot(&registry, CAPACITY + 1) != -1 || registry.num_free != 0;
+
+    // Closing one lets the next one in
+    session_close(&registry, 1);
+    errors += session_open(&registry, CAPACITY + 1, 0) == 0;
+    errors += session_open(&registry, CAPACITY + 2, 0) != 0;
+    printf("%d sessions, %d free: %d errors\n", registry.slots.count, registry.num_free, errors);
+
+    session_registry_destroy(&registry);
+    return errors;
+}
+
+int main() {
+    printf("=== Session Registry Tests ===\n");
+
+    int failures = test_slot_reuse();
+    failures += test_tokens();
+    failures += test_idle_timeout();
+    failures += test_full_registry();
+
+    printf("\n=== All session registry tests completed: %s ===\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
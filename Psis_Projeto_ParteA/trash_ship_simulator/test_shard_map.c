@@ -0,0 +1,52 @@
+#include "shard-map.h"
+#include <stdio.h>
+
+#define UNIVERSE_WIDTH 800
+
+int test_shard_map() {
+    printf("\n=== Testing Shard Map ===\n");
+
+    int errors = 0;
+    shard_map maps[3];
+    for (int i = 0; i < 3; i++) {
+        shard_map_init(&maps[i], i, 3, UNIVERSE_WIDTH);
+    }
+
+    // Every x belongs to exactly one strip, the one shard_of names
+    for (int x = 0; x < UNIVERSE_WIDTH; x++) {
+        int owners = 0;
+        for (int i = 0; i < 3; i++) {
+            if (shard_owns(&maps[i], x + 0.5f, 0)) {
+                owners++;
+                if (shard_of(&maps[i], x + 0.5f) != i) errors++;
+            }
+        }
+        if (owners != 1) errors++;
+    }
+    printf("Strips: [%d, %d) [%d, %d) [%d, %d)\n", shard_left(&maps[0], 0), shard_left(&maps[0], 1),
+           shard_left(&maps[0], 1), shard_left(&maps[0], 2), shard_left(&maps[0], 2), shard_left(&maps[0], 3));
+
+    // The margin reaches into the neighbours, across the seam too
+    if (!shard_owns(&maps[1], shard_left(&maps[0], 1) - 4.0f, SHARD_HANDOFF_MARGIN)) errors++;
+    if (shard_owns(&maps[1], shard_left(&maps[0], 1) - 12.0f, SHARD_HANDOFF_MARGIN)) errors++;
+    if (!shard_owns(&maps[0], UNIVERSE_WIDTH - 4.0f, SHARD_HANDOFF_MARGIN)) errors++;
+    if (!shard_owns(&maps[2], 4.0f, SHARD_HANDOFF_MARGIN)) errors++;
+    if (shard_owns(&maps[2], 12.0f, SHARD_HANDOFF_MARGIN)) errors++;
+
+    // A single shard runs the whole universe
+    shard_map whole;
+    shard_map_init(&whole, 0, 1, UNIVERSE_WIDTH);
+    if (!shard_owns(&whole, UNIVERSE_WIDTH - 0.5f, 0) || shard_of(&whole, UNIVERSE_WIDTH - 0.5f) != 0) errors++;
+
+    printf("%d errors\n", errors);
+    return errors;
+}
+
+int main() {
+    printf("=== Shard Map Tests ===\n");
+
+    int failures = test_shard_map();
+
+    printf("\n=== All shard map tests completed: %s ===\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
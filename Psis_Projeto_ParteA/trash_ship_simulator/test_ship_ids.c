@@ -0,0 +1,65 @@
+#include "id-map.h"
+#include "ship-id.h"
+#include <stdio.h>
+#include <string.h>
+
+int test_id_map() {
+    printf("\n=== Testing Id Map ===\n");
+
+    // Sequential ids and bot ids, half of them removed again
+    const int num_keys = 20000;
+    id_map map;
+    if (id_map_init(&map, 4) != 0) {
+        printf("Failed to create id map\n");
+        return 1;
+    }
+    int errors = 0;
+    for (int i = 0; i < num_keys; i++) {
+        errors += id_map_put(&map, (ship_id)(i + 1), i) != 0;
+        errors += id_map_put(&map, SHIP_ID_FIRST_BOT + (ship_id)i, -i - 2) != 0;
+    }
+    for (int i = 0; i < num_keys; i += 2) {
+        id_map_remove(&map, (ship_id)(i + 1));
+    }
+    for (int i = 0; i < num_keys; i++) {
+        int expected = i % 2 == 0 ? -1 : i;
+        errors += id_map_get(&map, (ship_id)(i + 1)) != expected;
+        errors += id_map_get(&map, SHIP_ID_FIRST_BOT + (ship_id)i) != -i - 2;
+    }
+    errors += map.count != num_keys + num_keys / 2;
+    errors += id_map_get(&map, SHIP_ID_NONE) != -1;
+
+    // A value put again replaces the old one
+    errors += id_map_put(&map, 2, 7) != 0 || id_map_get(&map, 2) != 7;
+    printf("%d ids stored, %d removed: %d wrong lookups\n", 2 * num_keys, num_keys / 2, errors);
+
+    id_map_destroy(&map);
+    return errors;
+}
+
+int test_ship_labels() {
+    printf("\n=== Testing Ship Labels ===\n");
+
+    int errors = 0;
+    char label[SHIP_LABEL_LEN];
+    errors += ship_id_from_letter('C') != 3 || ship_id_from_letter('c') != SHIP_ID_NONE;
+    errors += strcmp(ship_id_label(ship_id_from_letter('C'), label, sizeof(label)), "C") != 0;
+    errors += strcmp(ship_id_label(29, label, sizeof(label)), "C29") != 0;
+    errors += ship_id_is_bot(SHIP_ID_FIRST_BOT - 1) || !ship_id_is_bot(SHIP_ID_FIRST_BOT);
+    errors += strcmp(ship_id_label(SHIP_ID_FIRST_BOT, label, sizeof(label)), "a") != 0;
+    errors += strcmp(ship_id_label(SHIP_ID_FIRST_BOT + 29, label, sizeof(label)), "d30") != 0;
+    errors += ship_id_letter(SHIP_ID_NONE) != '?';
+
+    printf("%d errors\n", errors);
+    return errors;
+}
+
+int main() {
+    printf("=== Ship Id Tests ===\n");
+
+    int failures = test_id_map();
+    failures += test_ship_labels();
+
+    printf("\n=== All ship id tests completed: %s ===\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,589 @@
+#include "spatial-grid.h"
+#include "universe-data.h"
+#include "config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define WIDTH 800
+#define HEIGHT 600
+#define NUM_ITEMS 5000
+
+static float item_x[NUM_ITEMS];
+static float item_y[NUM_ITEMS];
+static int in_grid[NUM_ITEMS];
+
+// Items within radius of (x, y) found by walking the grid cells
+static int count_grid(const spatial_grid *grid, float x, float y, float radius) {
+    int col_min, row_min, col_max, row_max;
+    spatial_grid_cell_range(grid, x, y, radius, &col_min, &row_min, &col_max, &row_max);
+
+    int count = 0;
+    for (int row = row_min; row <= row_max; row++) {
+        for (int col = col_min; col <= col_max; col++) {
+            for (int i = grid->head[row * grid->cols + col]; i != -1; i = grid->next[i]) {
+                if (calculate_distance(x, y, item_x[i], item_y[i]) < radius) {
+                    count++;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+// Same count by testing every item
+static int count_brute_force(float x, float y, float radius) {
+    int count = 0;
+    for (int i = 0; i < NUM_ITEMS; i++) {
+        if (in_grid[i] && calculate_distance(x, y, item_x[i], item_y[i]) < radius) {
+            count++;
+        }
+    }
+    return count;
+}
+
+static int compare_queries(const spatial_grid *grid, int num_queries) {
+    int mismatches = 0;
+    for (int q = 0; q < num_queries; q++) {
+        float x = rand() % WIDTH;
+        float y = rand() % HEIGHT;
+        float radius = 1 + rand() % 40;
+        if (count_grid(grid, x, y, radius) != count_brute_force(x, y, radius)) {
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+int test_grid_queries() {
+    printf("\n=== Testing Grid Queries ===\n");
+
+    spatial_grid grid;
+    if (spatial_grid_init(&grid, WIDTH, HEIGHT, SHIP_RADIUS, NUM_ITEMS) != 0) {
+        printf("Failed to create grid\n");
+        return 1;
+    }
+    printf("Grid: %dx%d cells of %.0f pixels\n", grid.cols, grid.rows, grid.cell_size);
+
+    for (int i = 0; i < NUM_ITEMS; i++) {
+        item_x[i] = rand() % WIDTH;
+        item_y[i] = rand() % HEIGHT;
+        in_grid[i] = 1;
+        spatial_grid_insert(&grid, i, item_x[i], item_y[i]);
+    }
+    int mismatches = compare_queries(&grid, 1000);
+    printf("After inserting %d items: %d mismatches in 1000 queries\n", NUM_ITEMS, mismatches);
+
+    // Remove every third item, move the rest around
+    for (int i = 0; i < NUM_ITEMS; i++) {
+        if (i % 3 == 0) {
+            spatial_grid_remove(&grid, i);
+            in_grid[i] = 0;
+        } else {
+            item_x[i] = rand() % WIDTH;
+            item_y[i] = rand() % HEIGHT;
+            spatial_grid_move(&grid, i, item_x[i], item_y[i]);
+        }
+    }
+    int moved_mismatches = compare_queries(&grid, 1000);
+    printf("After removing and moving items: %d mismatches in 1000 queries\n", moved_mismatches);
+
+    spatial_grid_destroy(&grid);
+    return mismatches + moved_mismatches;
+}
+
+// Empty universe with the sizes a test cares about
+static universe_data *create_test_universe(int width, int height, int num_planets, int max_trash,
+                                           int ship_capacity, int max_ships) {
+    universe_config config = {
+        .universe_width = width,
+        .universe_height = height,
+        .num_planets = num_planets,
+        .max_trash = max_trash,
+        .initial_trash = 0,
+        .ship_capacity = ship_capacity,
+        .max_ships = max_ships
+    };
+    universe_data *universe = universe_create(&config);
+    if (!universe) {
+        printf("Failed to create universe\n");
+    }
+    return universe;
+}
+
+int test_ship_moves() {
+    printf("\n=== Testing Ship Moves in a Crowded Universe ===\n");
+
+    universe_data *universe = create_test_universe(4000, 3000, 5, 20000, 10, 1);
+    if (!universe) {
+        return 1;
+    }
+    for (int i = 0; i < universe->max_planets; i++) {
+        universe_add_planet(universe, 400 + i * 700, 1500, 'A' + i);
+    }
+    universe_set_recycling_planet(universe, 0);
+    for (int i = 0; i < universe->max_trash; i++) {
+        universe_add_trash(universe, rand() % universe->universe_width,
+                           rand() % universe->universe_height, 0, 0);
+    }
+    universe_add_ship(universe, 100, 100, ship_id_from_letter('A'));
+
+    // Sweep the ship right along a row, one pixel per move
+    int moves = 0;
+    clock_t start = clock();
+    for (int row = 0; row < 10; row++) {
+        for (float x = 0; x < universe->universe_width; x++) {
+            float y = 50 + row * 300;
+            check_colision_ship(universe, 0, &x, &y);
+            moves++;
+        }
+    }
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    ship_structure *ship = universe_get_ship(universe, 0);
+    printf("%d moves in %.3f s (%.2f us per move), ship carries %d trash, %d trash left\n",
+           moves, seconds, seconds * 1e6 / moves, ship->num_trash,
+           universe_count_active_trash(universe));
+
+    int errors = (universe_count_active_trash(universe) + ship->num_trash > universe->max_trash);
+    universe_destroy(universe);
+    return errors;
+}
+
+int test_placement_until_full() {
+    printf("\n=== Testing Placement Until the Universe Is Full ===\n");
+
+    universe_data *universe = create_test_universe(200, 150, 2, 5000, 10, 1);
+    if (!universe) {
+        return 1;
+    }
+    universe_add_planet(universe, 50, 75, 'A');
+    universe_add_planet(universe, 150, 75, 'B');
+
+    // chose_position must give up once nothing fits instead of looping
+    float x, y;
+    int placed = 0;
+    clock_t start = clock();
+    while (chose_position(universe, &x, &y, TRASH_RADIUS,
+                          universe->universe_width, universe->universe_height) == 0) {
+        if (universe_add_trash(universe, x, y, 0, 0) == -1) break;
+        placed++;
+    }
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("Placed %d trash in %.3f s before running out of room (%d free cells left)\n",
+           placed, seconds, universe->free_space.num_free);
+
+    // No two pieces may overlap
+    int overlaps = 0;
+    for (int i = 0; i < placed; i++) {
+        for (int j = i + 1; j < placed; j++) {
+            trash_structure *a = &universe->trash[i];
+            trash_structure *b = &universe->trash[j];
+            if (do_circles_intersect(a->x, a->y, a->radius, b->x, b->y, b->radius)) {
+                overlaps++;
+            }
+        }
+    }
+    printf("Overlapping trash pairs: %d\n", overlaps);
+
+    universe_destroy(universe);
+    return overlaps;
+}
+
+// Universe with trash scattered around (300, 300) and the planets far away
+static universe_data *create_moves_universe(unsigned int seed, int max_ships) {
+    // One trash slot left for the tests, cargo never full so every pickup counts
+    universe_data *universe = create_test_universe(3000, 3000, 2, 4001, 4000, max_ships);
+    if (!universe) {
+        return NULL;
+    }
+    universe_add_planet(universe, 2500, 2500, 'A');
+    universe_add_planet(universe, 2700, 2500, 'B');
+    universe_set_recycling_planet(universe, 0);
+    srand(seed);
+    for (int i = 0; i < universe->max_trash - 1; i++) {
+        universe_add_trash(universe, 100 + rand() % 400, 100 + rand() % 400, 0, 0);
+    }
+    return universe;
+}
+
+int test_batched_moves() {
+    printf("\n=== Testing Tick-Batched Ship Moves ===\n");
+
+    // The same random walk, one collision check per step or a tick at a time
+    universe_data *single = create_moves_universe(7, 1);
+    universe_data *batched = create_moves_universe(7, 1);
+    move_batch batch;
+    if (!single || !batched || move_batch_init(&batch, 1) != 0) {
+        printf("Failed to create universe\n");
+        return 1;
+    }
+    universe_add_ship(single, 300, 300, ship_id_from_letter('A'));
+    universe_add_ship(batched, 300, 300, ship_id_from_letter('A'));
+
+    srand(99);
+    int steps = 0;
+    for (int tick = 0; tick < 200; tick++) {
+        int num_steps = 1 + rand() % 40;
+        for (int s = 0; s < num_steps; s++) {
+            int dx = rand() % 3 - 1;
+            int dy = rand() % 3 - 1;
+            ship_structure *ship = universe_get_ship(single, 0);
+            float x = ship->x + dx;
+            float y = ship->y + dy;
+            check_colision_ship(single, 0, &x, &y);
+            move_batch_add_step(&batch, 0, dx, dy);
+            steps++;
+        }
+        universe_resolve_moves(batched, &batch);
+    }
+
+    ship_structure *a = universe_get_ship(single, 0);
+    ship_structure *b = universe_get_ship(batched, 0);
+    int errors = a->x != b->x || a->y != b->y || a->num_trash != b->num_trash ||
+                 single->num_trash != batched->num_trash;
+    for (int i = 0; i < a->num_trash && !errors; i++) {
+        errors = a->cargo[i].index != b->cargo[i].index;
+    }
+    printf("%d steps: ship at (%.0f, %.0f) with %d trash, batched at (%.0f, %.0f) with %d trash\n",
+           steps, a->x, a->y, a->num_trash, b->x, b->y, b->num_trash);
+    universe_destroy(single);
+    universe_destroy(batched);
+    move_batch_destroy(&batch);
+
+    // Two ships one step from the same trash: the lower id takes it,
+    // whatever their order in the universe
+    universe_data *universe = create_moves_universe(7, 2);
+    if (!universe || move_batch_init(&batch, 2) != 0) {
+        printf("Failed to create universe\n");
+        return 1;
+    }
+    int trash = universe_add_trash(universe, 1500, 1500, 0, 0);
+    universe_add_ship(universe, 1500 - SHIP_RADIUS - 1, 1500, ship_id_from_letter('D'));
+    universe_add_ship(universe, 1500 + SHIP_RADIUS + 1, 1500, ship_id_from_letter('C'));
+    move_batch_add_step(&batch, 0, 1, 0);
+    move_batch_add_step(&batch, 1, -1, 0);
+    universe_resolve_moves(universe, &batch);
+
+    ship_structure *d = universe_get_ship(universe, 0);
+    ship_structure *c = universe_get_ship(universe, 1);
+    int conflict_ok = c->num_trash == 1 && c->cargo[0].index == trash && d->num_trash == 0;
+    printf("Shared trash taken by %s\n", conflict_ok ? "C, as expected" : "the wrong ship");
+    errors += !conflict_ok;
+
+    universe_destroy(universe);
+    move_batch_destroy(&batch);
+    return errors;
+}
+
+int test_ship_collisions() {
+    printf("\n=== Testing Ship-Ship Collisions ===\n");
+
+    universe_data *universe = create_test_universe(600, 600, 1, 1, 1, 150);
+    if (!universe) {
+        return 1;
+    }
+    universe_add_planet(universe, 300, 300, 'A');
+    universe_set_recycling_planet(universe, 0);
+
+    float x, y;
+    for (int i = 0; i < universe->max_ships; i++) {
+        if (chose_position(universe, &x, &y, SHIP_RADIUS, universe->universe_width, universe->universe_height) != 0) {
+            break;
+        }
+        universe_add_ship(universe, x, y, (ship_id)(i + 1));
+    }
+
+    // Random steps for everyone, with a ship leaving and coming back now and then
+    int refused = 0;
+    int steps = 0;
+    clock_t start = clock();
+    for (int round = 0; round < 200; round++) {
+        for (int i = 0; i < universe->num_ships; i++) {
+            ship_structure *ship = universe_get_ship(universe, i);
+            float old_x = ship->x, old_y = ship->y;
+            x = ship->x + rand() % 3 - 1;
+            y = ship->y + rand() % 3 - 1;
+            correct_position(&x, universe->universe_width);
+            correct_position(&y, universe->universe_height);
+            check_colision_ship(universe, i, &x, &y);
+            refused += ship->x == old_x && ship->y == old_y && (x != old_x || y != old_y);
+            steps++;
+        }
+        if (round % 20 == 0) {
+            ship_id id = universe->ships[0].id;
+            universe_remove_ship(universe, 0);
+            if (chose_position(universe, &x, &y, SHIP_RADIUS, universe->universe_width, universe->universe_height) == 0) {
+                universe_add_ship(universe, x, y, id);
+            }
+        }
+    }
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    // The sweep must stay sorted and no ship may sit on another
+    int errors = 0;
+    for (int slot = 0; slot < universe->num_ships; slot++) {
+        int i = universe->ship_sweep[slot];
+        errors += universe->ships[i].sweep_slot != slot;
+        if (slot > 0) {
+            errors += universe->ships[universe->ship_sweep[slot - 1]].x > universe->ships[i].x;
+        }
+    }
+    int overlaps = 0;
+    for (int i = 0; i < universe->num_ships; i++) {
+        for (int j = 0; j < universe->num_ships; j++) {
+            ship_structure *a = &universe->ships[i];
+            ship_structure *b = &universe->ships[j];
+            overlaps += i != j && do_circles_intersect(a->x, a->y, a->radius, b->x, b->y, CENTER_RADIUS);
+        }
+    }
+    printf("%d ships, %d steps in %.3f s, %d refused, %d sweep errors, %d ships on top of another\n",
+           universe->num_ships, steps, seconds, refused, errors, overlaps);
+
+    universe_destroy(universe);
+    return errors + overlaps;
+}
+
+int test_nearest_trash() {
+    printf("\n=== Testing Nearest Trash Queries ===\n");
+
+    universe_data *universe = create_test_universe(WIDTH, HEIGHT, 1, 2000, 1, 1);
+    if (!universe) {
+        return 1;
+    }
+
+    // Dense, then sparse once most of the trash is removed
+    for (int i = 0; i < universe->max_trash; i++) {
+        universe_add_trash(universe, rand() % WIDTH, rand() % HEIGHT, 0, 0);
+    }
+    int errors = 0;
+    int queries = 0;
+    clock_t start = clock();
+    for (int round = 0; round < 2; round++) {
+        for (int q = 0; q < 1000; q++) {
+            float x = rand() % WIDTH;
+            float y = rand() % HEIGHT;
+            int found = universe_nearest_trash(universe, x, y);
+
+            int expected = -1;
+            float best = 0;
+            for (int i = 0; i < universe->max_trash; i++) {
+                trash_structure *trash = &universe->trash[i];
+                float dist2 = (trash->x - x) * (trash->x - x) + (trash->y - y) * (trash->y - y);
+                if (trash->active && (expected == -1 || dist2 < best)) {
+                    expected = i;
+                    best = dist2;
+                }
+            }
+            errors += found != expected;
+            queries++;
+        }
+        for (int i = 0; i < universe->max_trash - 5; i++) {
+            universe_remove_trash(universe, i);
+        }
+    }
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("%d queries (with brute force checks) in %.3f s, %d wrong answers\n", queries, seconds, errors);
+
+    universe_destroy(universe);
+    return errors;
+}
+
+// Follow the recycling flow field from (x, y) until it runs out. Returns the
+// number of steps, or -1 if it came within reach of the planet to avoid
+static int follow_flow(universe_data *universe, float x, float y, int avoid, float *end_x, float *end_y) {
+    float reach = SHIP_RADIUS + CENTER_RADIUS;
+    int steps = 0;
+    int dx, dy;
+    while (steps < 10000 && universe_recycling_step(universe, x, y, &dx, &dy)) {
+        x += dx;
+        y += dy;
+        correct_position(&x, universe->universe_width);
+        correct_position(&y, universe->universe_height);
+        planet_structure *planet = &universe->planets[avoid];
+        if (calculate_distance(x, y, planet->x, planet->y) < reach) {
+            return -1;
+        }
+        steps++;
+    }
+    *end_x = x;
+    *end_y = y;
+    return steps;
+}
+
+int test_recycling_flow() {
+    printf("\n=== Testing Recycling Flow Field ===\n");
+
+    universe_data *universe = create_test_universe(1000, 600, 2, 1, 1, 1);
+    if (!universe) {
+        return 1;
+    }
+    universe_add_planet(universe, 700, 300, 'A');
+    universe_add_planet(universe, 450, 300, 'B');
+
+    clock_t start = clock();
+    universe_set_recycling_planet(universe, 0);
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("Field of %dx%d cells built in %.3f ms\n",
+           universe->recycling_flow.cols, universe->recycling_flow.rows, seconds * 1000);
+
+    int errors = 0;
+    float arrival = SHIP_RADIUS + CENTER_RADIUS + FLOW_CELL_SIZE * 1.5f;
+    float x, y;
+
+    // B lies on the straight line: go around it
+    int steps = follow_flow(universe, 250, 300, 1, &x, &y);
+    printf("Around planet B: %d steps, ending %.1f from A\n", steps, calculate_distance(x, y, 700, 300));
+    if (steps < 0 || calculate_distance(x, y, 700, 300) > arrival) {
+        errors++;
+    }
+
+    // Across the edge is shorter than across the universe (and B)
+    steps = follow_flow(universe, 50, 300, 1, &x, &y);
+    printf("Across the edge: %d steps, ending %.1f from A\n", steps, calculate_distance(x, y, 700, 300));
+    if (steps < 0 || steps > 350 || calculate_distance(x, y, 700, 300) > arrival) {
+        errors++;
+    }
+
+    // The field follows the recycling planet
+    universe_set_recycling_planet(universe, 1);
+    steps = follow_flow(universe, 900, 300, 0, &x, &y);
+    printf("To planet B around A: %d steps, ending %.1f from B\n", steps, calculate_distance(x, y, 450, 300));
+    if (universe->flow_target != 1 || steps < 0 || calculate_distance(x, y, 450, 300) > arrival) {
+        errors++;
+    }
+
+    printf("%d errors\n", errors);
+    universe_destroy(universe);
+    return errors;
+}
+
+static double wall_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int test_parallel_moves() {
+    printf("\n=== Testing Parallel Ship Moves ===\n");
+
+    // The same random walks resolved on the caller alone and with workers
+    const int num_ships = 40;
+    universe_data *serial = create_moves_universe(11, num_ships);
+    universe_data *parallel = create_moves_universe(11, num_ships);
+    move_batch serial_batch, parallel_batch;
+    if (!serial || !parallel || move_batch_init(&serial_batch, num_ships) != 0 ||
+        move_batch_init(&parallel_batch, num_ships) != 0 ||
+        move_batch_start_workers(&parallel_batch, 3) != 0) {
+        printf("Failed to create universe\n");
+        return 1;
+    }
+    // Most ships apart from each other, a few packed together
+    for (int i = 0; i < num_ships; i++) {
+        float x = i < 32 ? 120 + (i % 8) * 50 : 300 + (i % 4) * 12;
+        float y = i < 32 ? 120 + (i / 8) * 90 : 560 + (i % 2) * 12;
+        universe_add_ship(serial, x, y, (ship_id)(i + 1));
+        universe_add_ship(parallel, x, y, (ship_id)(i + 1));
+    }
+
+    srand(5);
+    double serial_seconds = 0, parallel_seconds = 0;
+    for (int tick = 0; tick < 300; tick++) {
+        for (int i = 0; i < num_ships; i++) {
+            int num_steps = rand() % 20;
+            for (int s = 0; s < num_steps; s++) {
+                int dx = rand() % 3 - 1;
+                int dy = rand() % 3 - 1;
+                move_batch_add_step(&serial_batch, i, dx, dy);
+                move_batch_add_step(&parallel_batch, i, dx, dy);
+            }
+        }
+        double start = wall_seconds();
+        universe_resolve_moves(serial, &serial_batch);
+        serial_seconds += wall_seconds() - start;
+        start = wall_seconds();
+        universe_resolve_moves(parallel, &parallel_batch);
+        parallel_seconds += wall_seconds() - start;
+    }
+
+    int errors = serial->num_trash != parallel->num_trash;
+    for (int i = 0; i < num_ships; i++) {
+        ship_structure *a = universe_get_ship(serial, i);
+        ship_structure *b = universe_get_ship(parallel, i);
+        if (a->x != b->x || a->y != b->y || a->num_trash != b->num_trash) {
+            errors++;
+        }
+    }
+    // The grids and the sweep are back in shape once the workers are done
+    int in_grid = 0;
+    for (int i = 0; i < parallel->max_trash; i++) {
+        bool indexed = parallel->trash_grid.cell[i] != -1;
+        in_grid += indexed;
+        if (indexed != parallel->trash[i].active) errors++;
+    }
+    if (in_grid != parallel->num_trash) errors++;
+    for (int slot = 1; slot < parallel->num_ships; slot++) {
+        if (parallel->ships[parallel->ship_sweep[slot - 1]].x > parallel->ships[parallel->ship_sweep[slot]].x) {
+            errors++;
+        }
+    }
+    printf("%d ships, %d trash left: %.3f s on the caller, %.3f s with 3 workers, %d differences\n",
+           num_ships, parallel->num_trash, serial_seconds, parallel_seconds, errors);
+
+    universe_destroy(serial);
+    universe_destroy(parallel);
+    move_batch_destroy(&serial_batch);
+    move_batch_destroy(&parallel_batch);
+    return errors;
+}
+
+int test_ship_lookup() {
+    printf("\n=== Testing Ship Lookup by Id ===\n");
+
+    // More ships than a letter or a byte could name, found again after
+    // removals shuffled their slots
+    universe_data *universe = create_test_universe(2000, 2000, 1, 1, 1, 300);
+    if (!universe) {
+        return 1;
+    }
+    universe_add_planet(universe, 1000, 1000, 'A');
+    universe_set_recycling_planet(universe, 0);
+    for (int i = 0; i < universe->max_ships; i++) {
+        universe_add_ship(universe, 50 + (i % 20) * 60, 50 + (i / 20) * 60, (ship_id)(1000 + i));
+    }
+    for (int i = 0; i < universe->max_ships; i += 3) {
+        universe_remove_ship(universe, universe_find_ship(universe, (ship_id)(1000 + i)));
+    }
+    int misplaced = 0;
+    for (int i = 0; i < universe->max_ships; i++) {
+        int index = universe_find_ship(universe, (ship_id)(1000 + i));
+        if (i % 3 == 0) {
+            misplaced += index != -1;
+        } else {
+            misplaced += index < 0 || universe->ships[index].id != (ship_id)(1000 + i);
+        }
+    }
+    printf("%d ships, %d left: %d found in the wrong place\n",
+           universe->max_ships, universe->num_ships, misplaced);
+
+    universe_destroy(universe);
+    return misplaced;
+}
+
+int main() {
+    printf("=== Spatial Grid Tests ===\n");
+    srand(42);
+
+    int failures = test_grid_queries();
+    failures += test_ship_moves();
+    failures += test_placement_until_full();
+    failures += test_batched_moves();
+    failures += test_ship_collisions();
+    failures += test_parallel_moves();
+    failures += test_nearest_trash();
+    failures += test_recycling_flow();
+    failures += test_ship_lookup();
+
+    printf("\n=== All spatial grid tests completed: %s ===\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
@@ -10,8 +10,27 @@
 
 // ===== Universe Management =====
 
+// Free everything universe holds. Members not allocated yet are zero, so
+// this also undoes a universe_create that failed halfway.
+static void universe_release(universe_data *universe) {
+    free(universe->planets);
+    free(universe->trash);
+    free(universe->ships);
+    free(universe->cargo_pool);
+    free(universe->ship_sweep);
+    id_map_destroy(&universe->ship_slots);
+
+    spatial_grid_destroy(&universe->trash_grid);
+    spatial_grid_destroy(&universe->planet_grid);
+    spatial_grid_destroy(&universe->interest_grid);
+    free_space_destroy(&universe->free_space);
+    flow_field_destroy(&universe->recycling_flow);
+
+    free(universe);
+}
+
 universe_data* universe_create(universe_config *config) {
-    universe_data *universe = (universe_data*)malloc(sizeof(universe_data));
+    universe_data *universe = (universe_data*)calloc(1, sizeof(universe_data));
     if (!universe) {
         fprintf(stderr, "Failed to allocate universe\n");
         return NULL;
@@ -33,70 +52,94 @@ universe_data* universe_create(universe_config *config) {
     universe->planets = (planet_structure*)malloc(sizeof(planet_structure) * config->num_planets);
     if (!universe->planets) {
         fprintf(stderr, "Failed to allocate planets array\n");
-        free(universe);
-        return NULL;
+        goto fail;
     }
 
     // Allocate trash array
     universe->trash = (trash_structure*)malloc(sizeof(trash_structure) * config->max_trash);
     if (!universe->trash) {
         fprintf(stderr, "Failed to allocate trash array\n");
-        free(universe->planets);
-        free(universe);
-        return NULL;
+        goto fail;
     }
     universe->ships = (ship_structure*)malloc(sizeof(ship_structure) * config->max_ships);
     if (!universe->ships) {
         fprintf(stderr, "Failed to allocate ships array\n");
-        free(universe->planets);
-        free(universe->trash);
-        free(universe);
-        return NULL;
+        goto fail;
+    }
+
+    // Cargo never grows past ship_capacity, so all of it is allocated here
+    // and picking up trash never touches the heap
+    universe->cargo_pool = (trash_handle*)malloc(sizeof(trash_handle) * config->max_ships * config->ship_capacity);
+    universe->ship_sweep = (int*)malloc(sizeof(int) * config->max_ships);
+    if (!universe->cargo_pool || !universe->ship_sweep) {
+        fprintf(stderr, "Failed to allocate cargo pool\n");
+        goto fail;
     }
 
     // Initialize trash as inactive
     for (int i = 0; i < config->max_trash; i++) {
         universe->trash[i].active = false;
+        universe->trash[i].generation = 0;
     }
 
     for (int i = 0; i < config->max_ships; i++) {
-        universe->ships[i].trash_indexs = NULL;
+        universe->ships[i].cargo = &universe->cargo_pool[i * config->ship_capacity];
         universe->ships[i].num_trash = 0;
     }
 
+    if (id_map_init(&universe->ship_slots, config->max_ships) != 0 ||
+        spatial_grid_init(&universe->trash_grid, universe->universe_width, universe->universe_height,
+                          SHIP_RADIUS, config->max_trash) != 0 ||
+        spatial_grid_init(&universe->planet_grid, universe->universe_width, universe->universe_height,
+                          SHIP_RADIUS, config->num_planets) != 0 ||
+        spatial_grid_init(&universe->interest_grid, universe->universe_width, universe->universe_height,
+                          INTEREST_CELL_SIZE, config->max_trash) != 0 ||
+        free_space_init(&universe->free_space, universe->universe_width, universe->universe_height,
+                        FREE_SPACE_CELL_SIZE, TRASH_RADIUS) != 0 ||
+        flow_field_init(&universe->recycling_flow, universe->universe_width, universe->universe_height,
+                        FLOW_CELL_SIZE) != 0) {
+        goto fail;
+    }
+    universe->flow_target = -1;
+
     printf("Universe created: %dx%d, max %d planets, max %d trash, max %d ships\n",
            universe->universe_width, universe->universe_height,
            universe->max_planets, universe->max_trash, universe->max_ships);
 
     return universe;
+
+fail:
+    universe_release(universe);
+    return NULL;
 }
 
 void universe_destroy(universe_data *universe) {
     if (!universe) return;
 
-    if (universe->planets) {
-        free(universe->planets);
-    }
+    universe_release(universe);
+    printf("Universe destroyed\n");
+}
 
-    if (universe->trash) {
-        free(universe->trash);
-    }
+// ===== Planet Functions =====
 
-    if (universe->ships) {
-        for (int i = 0; i < universe->num_ships; i++) {
-            if (universe->ships[i].trash_indexs) {
-                free(universe->ships[i].trash_indexs);
-            }
+// Lead the flow field to the recycling planet around every other planet.
+// Cells are blocked when a ship anywhere in them would touch the planet.
+static void build_recycling_flow(universe_data *universe) {
+    flow_field *field = &universe->recycling_flow;
+    float reach = SHIP_RADIUS + CENTER_RADIUS;
+    float half_diagonal = field->cell_size * 0.7072f;
+
+    flow_field_clear(field);
+    for (int i = 0; i < universe->num_planets; i++) {
+        if (i != universe->recycling_planet_index) {
+            flow_field_block(field, universe->planets[i].x, universe->planets[i].y, reach + half_diagonal);
         }
-        free(universe->ships);
     }
-
-    free(universe);
-    printf("Universe destroyed\n");
+    planet_structure *target = &universe->planets[universe->recycling_planet_index];
+    flow_field_build(field, target->x, target->y, reach);
+    universe->flow_target = universe->recycling_planet_index;
 }
 
-// ===== Planet Functions =====
-
 int universe_add_planet(universe_data *universe, float x, float y, char name) {
     if (!universe) return -1;
 
@@ -115,10 +158,16 @@ int universe_add_planet(universe_data *universe, float x, float y, char name) {
     planet->name = name;
     planet->is_recycling = false;
     planet->num_trash = 0;
-
+    spatial_grid_insert(&universe->planet_grid, index, x, y);
+    free_space_occupy(&universe->free_space, x, y, planet->radius);
 
     universe->num_planets++;
 
+    // A planet in the way once the field is built changes the paths
+    if (universe->flow_target != -1) {
+        build_recycling_flow(universe);
+    }
+
     printf("Added planet '%c' at (%.1f, %.1f)\n", name, x, y);
 
     return index;
@@ -148,6 +197,17 @@ void universe_set_recycling_planet(universe_data *universe, int index) {
 
     printf("Planet '%c' is now the recycling planet\n", 
            universe->planets[index].name);
+
+    if (universe->flow_target != index) {
+        build_recycling_flow(universe);
+    }
+}
+
+bool universe_recycling_step(universe_data *universe, float x, float y, int *dx, int *dy) {
+    if (universe->flow_target == -1) {
+        return false;
+    }
+    return flow_field_step(&universe->recycling_flow, x, y, dx, dy);
 }
 
 //used for universe-simulator
@@ -237,6 +297,22 @@ void universe_initialize_planets(universe_data *universe) {
 
 // ===== Trash Functions =====
 
+// Active trash is in the collision and interest grids and covers its free
+// space cells
+static void index_trash(universe_data *universe, int index) {
+    trash_structure *trash = &universe->trash[index];
+    spatial_grid_insert(&universe->trash_grid, index, trash->x, trash->y);
+    spatial_grid_insert(&universe->interest_grid, index, trash->x, trash->y);
+    free_space_occupy(&universe->free_space, trash->x, trash->y, trash->radius);
+}
+
+static void unindex_trash(universe_data *universe, int index) {
+    trash_structure *trash = &universe->trash[index];
+    spatial_grid_remove(&universe->trash_grid, index);
+    spatial_grid_remove(&universe->interest_grid, index);
+    free_space_release(&universe->free_space, trash->x, trash->y, trash->radius);
+}
+
 int universe_add_trash(universe_data *universe, float x, float y, 
                        float velocity_amplitude, float velocity_angle) {
     if (!universe) return -1;
@@ -266,6 +342,8 @@ int universe_add_trash(universe_data *universe, float x, float y,
     trash->acceleration.amplitude = 0.0;
     trash->acceleration.angle = 0.0;
     trash->active = true;
+    trash->generation++;  // stale handles to the previous trash stop matching
+    index_trash(universe, index);
 
     universe->num_trash++;
 
@@ -289,10 +367,23 @@ void universe_remove_trash(universe_data *universe, int index) {
 
     if (universe->trash[index].active) {
         universe->trash[index].active = false;
+        unindex_trash(universe, index);
         universe->num_trash--;
     }
 }
 
+void universe_move_trash(universe_data *universe, int index, float x, float y) {
+    trash_structure *trash = universe_get_trash(universe, index);
+    if (!trash) return;
+
+    free_space_release(&universe->free_space, trash->x, trash->y, trash->radius);
+    trash->x = x;
+    trash->y = y;
+    spatial_grid_move(&universe->trash_grid, index, x, y);
+    spatial_grid_move(&universe->interest_grid, index, x, y);
+    free_space_occupy(&universe->free_space, x, y, trash->radius);
+}
+
 int universe_count_active_trash(universe_data *universe) {
     if (!universe) return 0;
     return universe->num_trash;
@@ -323,7 +414,85 @@ vector add_vectors(vector v1, vector v2) {
 }
 
 // ===== Ship Functions =====
-int universe_add_ship(universe_data *universe, float x, float y, char name){
+
+// universe->ship_sweep keeps the ships sorted by x (sweep and prune along
+// x). Ships move a pixel at a time, so keeping it sorted is an insertion
+// sort step that hardly ever swaps, and a collision check only looks at the
+// few ships within reach along x instead of every ship.
+static void sweep_set(universe_data *universe, int slot, int index) {
+    universe->ship_sweep[slot] = index;
+    universe->ships[index].sweep_slot = slot;
+}
+
+// Put the ship at index back in order after its x changed
+static void sweep_update(universe_data *universe, int index) {
+    int slot = universe->ships[index].sweep_slot;
+    float x = universe->ships[index].x;
+    while (slot > 0 && universe->ships[universe->ship_sweep[slot - 1]].x > x) {
+        sweep_set(universe, slot, universe->ship_sweep[slot - 1]);
+        slot--;
+    }
+    while (slot < universe->num_ships - 1 && universe->ships[universe->ship_sweep[slot + 1]].x < x) {
+        sweep_set(universe, slot, universe->ship_sweep[slot + 1]);
+        slot++;
+    }
+    sweep_set(universe, slot, index);
+}
+
+// Put every ship back in order after several of them moved at once
+static void sweep_sort(universe_data *universe) {
+    for (int slot = 1; slot < universe->num_ships; slot++) {
+        int index = universe->ship_sweep[slot];
+        float x = universe->ships[index].x;
+        int to = slot;
+        while (to > 0 && universe->ships[universe->ship_sweep[to - 1]].x > x) {
+            sweep_set(universe, to, universe->ship_sweep[to - 1]);
+            to--;
+        }
+        sweep_set(universe, to, index);
+    }
+}
+
+static void sweep_remove(universe_data *universe, int index) {
+    for (int slot = universe->ships[index].sweep_slot; slot < universe->num_ships - 1; slot++) {
+        sweep_set(universe, slot, universe->ship_sweep[slot + 1]);
+    }
+}
+
+// Lowest index ship, other than skip, intersecting the circle (x, y, radius)
+// with ships taken as circles of ship_radius around their center. -1 if none.
+static int find_ship_hit(universe_data *universe, float x, float y, float radius,
+                         float ship_radius, int skip) {
+    // Further apart along x than this never intersects (whole pixel distances)
+    float reach = radius + ship_radius + 1;
+
+    // First ship of the sweep that can be in reach
+    int low = 0, high = universe->num_ships;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (universe->ships[universe->ship_sweep[mid]].x <= x - reach) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    int hit = -1;
+    for (int slot = low; slot < universe->num_ships; slot++) {
+        int i = universe->ship_sweep[slot];
+        ship_structure *other = &universe->ships[i];
+        if (other->x >= x + reach) {
+            break;
+        }
+        if (i != skip && (hit == -1 || i < hit) &&
+            do_circles_intersect(x, y, radius, other->x, other->y, ship_radius)) {
+            hit = i;
+        }
+    }
+    return hit;
+}
+
+int universe_add_ship(universe_data *universe, float x, float y, ship_id id){
     if (!universe) return -1;
 
     if (universe->num_ships >= universe->max_ships) {
@@ -334,18 +503,26 @@ int universe_add_ship(universe_data *universe, float x, float y, char name){
     int index = universe->num_ships;
     ship_structure *ship = &universe->ships[index];
 
-    ship->trash_indexs = NULL; 
     ship->x = x;
     ship->y = y;
     ship->radius = SHIP_RADIUS;
-    ship->name = name;
+    ship->id = id;
     ship->num_trash = 0;
-    
-
+    ship->input_keys = 0;
+    ship->input_seq = 0;
+    ship->input_ticks = 0;
+    if (id_map_put(&universe->ship_slots, id, index) != 0) {
+        return -1;
+    }
+    free_space_occupy(&universe->free_space, x, y, ship->radius);
 
     universe->num_ships++;
+    sweep_set(universe, index, index);
+    sweep_update(universe, index);
 
-    printf("Added ship '%c' at (%.1f, %.1f)\n", name, x, y);
+    char label[SHIP_LABEL_LEN];
+    ship_id_label(id, label, sizeof(label));
+    printf("Added ship '%s' at (%.1f, %.1f)\n", label, x, y);
 
     return index;
 }
@@ -353,17 +530,82 @@ int universe_add_ship(universe_data *universe, float x, float y, char name){
 
 
 ship_structure* universe_get_ship(universe_data *universe, int index) {
-    if (!universe || index < 0 || index >= universe->max_ships) {
+    if (!universe || index < 0 || index >= universe->num_ships) {
         return NULL;
     }
-    /*
-    if (!universe->ships[index].active) {
-        return NULL;
-    }
-    */
     return &universe->ships[index];
 }
 
+int universe_find_ship(universe_data *universe, ship_id id) {
+    if (!universe) return -1;
+    return id_map_get(&universe->ship_slots, id);
+}
+
+void universe_remove_ship(universe_data *universe, int index) {
+    ship_structure *ship = universe_get_ship(universe, index);
+    if (!ship) return;
+
+    universe_release_ship_trash(universe, ship);
+    free_space_release(&universe->free_space, ship->x, ship->y, ship->radius);
+    id_map_remove(&universe->ship_slots, ship->id);
+    sweep_remove(universe, index);
+    char label[SHIP_LABEL_LEN];
+    ship_id_label(ship->id, label, sizeof(label));
+    printf("Removed ship '%s'\n", label);
+
+    // Keep ships[] dense: the last ship takes over the freed slot and the
+    // freed cargo slice goes to the now unused last slot
+    int last = universe->num_ships - 1;
+    if (index != last) {
+        trash_handle *free_cargo = ship->cargo;
+        universe->ships[index] = universe->ships[last];
+        universe->ships[last].cargo = free_cargo;
+        id_map_put(&universe->ship_slots, universe->ships[index].id, index);
+        universe->ship_sweep[universe->ships[index].sweep_slot] = index;
+    }
+    universe->ships[last].num_trash = 0;
+    universe->num_ships--;
+}
+
+void universe_load_foreign_cargo(universe_data *universe, ship_structure *ship, int count) {
+    if (count > universe->ship_capacity) {
+        count = universe->ship_capacity;
+    }
+    for (int j = 0; j < count; j++) {
+        ship->cargo[j].index = -1;
+        ship->cargo[j].generation = 0;
+    }
+    ship->num_trash = count;
+}
+
+void universe_release_ship_trash(universe_data *universe, ship_structure *ship) {
+    for (int j = 0; j < ship->num_trash; j++){
+        trash_handle handle = ship->cargo[j];
+        float new_x, new_y;
+        if (chose_position(universe, &new_x, &new_y, TRASH_RADIUS,
+                           universe->universe_width, universe->universe_height) != 0) {
+            fprintf(stderr, "No room to release trash %d, it is lost\n", handle.index);
+            continue;
+        }
+
+        trash_structure *trash_released = handle.index >= 0 ? &universe->trash[handle.index] : NULL;
+        if (trash_released && !trash_released->active && trash_released->generation == handle.generation) {
+            trash_released->active = true;
+            trash_released->x = new_x;
+            trash_released->y = new_y;
+            index_trash(universe, handle.index);
+            universe->num_trash++; // Importante: incrementar o contador de lixo ativo!
+            printf("Trash %d released back into universe at (%.1f, %.1f)\n", handle.index, new_x, new_y);
+        } else {
+            // The slot was given to new trash while this piece was carried
+            int index = universe_add_trash(universe, new_x, new_y, 0, 0);
+            if (index != -1) {
+                printf("Trash %d released back into universe at (%.1f, %.1f)\n", index, new_x, new_y);
+            }
+        }
+    }
+    ship->num_trash = 0;
+}
 
 // ===== Utility Functions =====
 
@@ -375,165 +617,723 @@ void correct_position(float *pos, int universe_size) {
     }
 }
 
-void chose_position(universe_data *universe, float *x, float *y,
-                     int radius, int universe_width, int universe_height)
-{
-    bool valid = false;
-
-    while (!valid) {
-        valid = true;
-
-        *x = rand() % universe_width;
-        *y = rand() % universe_height;
-
-        // Check planets
-        for (int i = 0; i < universe->num_planets; i++) {
-            planet_structure *planet = universe_get_planet(universe, i);
-            if (do_circles_intersect(*x, *y, radius,
-                                     planet->x, planet->y, planet->radius)) {
-                valid = false;
-                break;
+// Lowest index planet intersecting the circle (x, y, radius), with planets
+// taken as circles of planet_radius around their center. -1 if none.
+static int find_planet_hit(universe_data *universe, float x, float y, float radius, float planet_radius) {
+    spatial_grid *grid = &universe->planet_grid;
+    int col_min, row_min, col_max, row_max;
+    spatial_grid_cell_range(grid, x, y, radius + planet_radius, &col_min, &row_min, &col_max, &row_max);
+
+    int hit = -1;
+    for (int row = row_min; row <= row_max; row++) {
+        for (int col = col_min; col <= col_max; col++) {
+            for (int i = grid->head[row * grid->cols + col]; i != -1; i = grid->next[i]) {
+                planet_structure *planet = &universe->planets[i];
+                if ((hit == -1 || i < hit) &&
+                    do_circles_intersect(x, y, radius, planet->x, planet->y, planet_radius)) {
+                    hit = i;
+                }
             }
         }
-        if (!valid) continue;
+    }
+    return hit;
+}
 
-        // Check trash
-        for (int i = 0; i < universe->max_trash; i++) {
-            trash_structure *trash = universe_get_trash(universe, i);
-            if (trash){
-                if (do_circles_intersect(*x, *y, radius,
-                                         trash->x, trash->y, trash->radius)) {
-                    valid = false;
-                    break;
+// Same as find_planet_hit for active trash
+static int find_trash_hit(universe_data *universe, float x, float y, float radius, float trash_radius) {
+    spatial_grid *grid = &universe->trash_grid;
+    int col_min, row_min, col_max, row_max;
+    spatial_grid_cell_range(grid, x, y, radius + trash_radius, &col_min, &row_min, &col_max, &row_max);
+
+    int hit = -1;
+    for (int row = row_min; row <= row_max; row++) {
+        for (int col = col_min; col <= col_max; col++) {
+            for (int i = grid->head[row * grid->cols + col]; i != -1; i = grid->next[i]) {
+                trash_structure *trash = &universe->trash[i];
+                if ((hit == -1 || i < hit) &&
+                    do_circles_intersect(x, y, radius, trash->x, trash->y, trash_radius)) {
+                    hit = i;
                 }
             }
         }
-        if (!valid) continue;
+    }
+    return hit;
+}
+
+// Closest trash of one cell to (x, y), lowest index on ties
+static void nearest_in_cell(universe_data *universe, const spatial_grid *grid, int col, int row,
+                            float x, float y, int *best, float *best_dist2) {
+    for (int i = grid->head[row * grid->cols + col]; i != -1; i = grid->next[i]) {
+        trash_structure *trash = &universe->trash[i];
+        float dx = trash->x - x;
+        float dy = trash->y - y;
+        float dist2 = dx * dx + dy * dy;
+        if (*best == -1 || dist2 < *best_dist2 || (dist2 == *best_dist2 && i < *best)) {
+            *best = i;
+            *best_dist2 = dist2;
+        }
+    }
+}
 
-        for (int i = 0; i < universe->num_ships; i++) {
-            ship_structure *ship = universe_get_ship(universe, i);
-            if (ship) {
-                if (do_circles_intersect(*x, *y, radius,
-                                         ship->x, ship->y, ship->radius)) {
-                    valid = false;
-                    break;
+int universe_nearest_trash(universe_data *universe, float x, float y) {
+    const spatial_grid *grid = &universe->trash_grid;
+    if (universe->num_trash == 0) {
+        return -1;
+    }
+
+    int col, row, unused_col, unused_row;
+    spatial_grid_cell_range(grid, x, y, 0, &col, &row, &unused_col, &unused_row);
+    int max_ring = grid->cols > grid->rows ? grid->cols : grid->rows;
+
+    int best = -1;
+    float best_dist2 = 0;
+    for (int ring = 0; ring <= max_ring; ring++) {
+        // The cells at exactly this many cells from the center one
+        for (int r = row - ring; r <= row + ring; r++) {
+            if (r < 0 || r >= grid->rows) continue;
+            bool edge_row = r == row - ring || r == row + ring;
+            for (int c = col - ring; c <= col + ring; c += edge_row ? 1 : 2 * ring) {
+                if (c >= 0 && c < grid->cols) {
+                    nearest_in_cell(universe, grid, c, r, x, y, &best, &best_dist2);
                 }
+                if (ring == 0) break;
             }
         }
-        if (!valid) continue;
+
+        // Anything in the next ring is at least ring cells away
+        float reach = ring * grid->cell_size;
+        if (best != -1 && best_dist2 <= reach * reach) {
+            break;
+        }
+    }
+    return best;
+}
+
+// True if a circle of this radius at (x, y) touches no planet, trash or ship
+static bool position_is_free(universe_data *universe, float x, float y, int radius) {
+    if (find_planet_hit(universe, x, y, radius, PLANET_RADIUS) != -1) {
+        return false;
+    }
+    if (find_trash_hit(universe, x, y, radius, TRASH_RADIUS) != -1) {
+        return false;
+    }
+    if (find_ship_hit(universe, x, y, radius, SHIP_RADIUS, -1) != -1) {
+        return false;
+    }
+    return true;
+}
+
+int chose_position(universe_data *universe, float *x, float *y,
+                   int radius, int universe_width, int universe_height)
+{
+    free_space_map *map = &universe->free_space;
+    int cell_x, cell_y;
+
+    // Random points inside random free cells. A free cell can still be too
+    // close to something for a large radius, so every point is checked.
+    for (int attempt = 0; attempt < PLACEMENT_ATTEMPTS && map->num_free > 0; attempt++) {
+        int cell = map->free_cells[rand() % map->num_free];
+        free_space_cell_origin(map, cell, &cell_x, &cell_y);
+
+        *x = cell_x + rand() % map->cell_size;
+        *y = cell_y + rand() % map->cell_size;
+        if (*x >= universe_width) *x = universe_width - 1;
+        if (*y >= universe_height) *y = universe_height - 1;
+        if (position_is_free(universe, *x, *y, radius)) {
+            return 0;
+        }
+    }
+
+    // Crowded universe: try the center of every free cell once
+    int start = map->num_free > 0 ? rand() % map->num_free : 0;
+    for (int i = 0; i < map->num_free; i++) {
+        int cell = map->free_cells[(start + i) % map->num_free];
+        free_space_cell_origin(map, cell, &cell_x, &cell_y);
+
+        *x = cell_x + map->cell_size / 2;
+        *y = cell_y + map->cell_size / 2;
+        if (*x >= universe_width) *x = universe_width - 1;
+        if (*y >= universe_height) *y = universe_height - 1;
+        if (position_is_free(universe, *x, *y, radius)) {
+            return 0;
+        }
+    }
+    return -1;
+}
+
+// Move a ship, keeping its free space cells up to date
+static void set_ship_position(universe_data *universe, ship_structure *ship, float x, float y) {
+    free_space_release(&universe->free_space, ship->x, ship->y, ship->radius);
+    ship->x = x;
+    ship->y = y;
+    free_space_occupy(&universe->free_space, x, y, ship->radius);
+    sweep_update(universe, (int)(ship - universe->ships));
+}
+
+
+
+// Lowest index trash of list intersecting the circle, like find_trash_hit
+static int find_trash_hit_in(universe_data *universe, const int *list, int count,
+                             float x, float y, float radius, float trash_radius) {
+    int hit = -1;
+    for (int k = 0; k < count; k++) {
+        int i = list[k];
+        trash_structure *trash = &universe->trash[i];
+        if (trash->active && (hit == -1 || i < hit) &&
+            do_circles_intersect(x, y, radius, trash->x, trash->y, trash_radius)) {
+            hit = i;
+        }
+    }
+    return hit;
+}
+
+// Lowest index ship of list intersecting the circle, like find_ship_hit
+static int find_ship_hit_in(universe_data *universe, const int *list, int count,
+                            float x, float y, float radius, float ship_radius) {
+    int hit = -1;
+    for (int k = 0; k < count; k++) {
+        int i = list[k];
+        ship_structure *other = &universe->ships[i];
+        if ((hit == -1 || i < hit) &&
+            do_circles_intersect(x, y, radius, other->x, other->y, ship_radius)) {
+            hit = i;
+        }
+    }
+    return hit;
+}
+
+// Lowest index planet of list intersecting the circle, like find_planet_hit
+static int find_planet_hit_in(universe_data *universe, const int *list, int count,
+                              float x, float y, float radius, float planet_radius) {
+    int hit = -1;
+    for (int k = 0; k < count; k++) {
+        int i = list[k];
+        planet_structure *planet = &universe->planets[i];
+        if ((hit == -1 || i < hit) &&
+            do_circles_intersect(x, y, radius, planet->x, planet->y, planet_radius)) {
+            hit = i;
+        }
     }
+    return hit;
 }
 
+// Move a ship to (x, y), handling the planet and trash it runs into. With a
+// path, only what was gathered around it is checked instead of the grids.
+// A parallel path only touches the ship and the trash around it, the maps
+// shared by all ships are brought up to date after the workers are done.
+static void move_ship(universe_data *universe, ship_structure *ship, float x, float y,
+                      const move_batch *batch, const ship_path *path)
+{
+    bool near = path != NULL && path->has_near;
+    bool parallel = path != NULL && path->parallel;
+    const int *near_trash = near ? batch->near + path->near_start : NULL;
+    const int *near_planets = near ? near_trash + path->num_near_trash : NULL;
+
+    // Ships do not fly into each other, the step is refused
+    int ship_index = parallel
+        ? find_ship_hit_in(universe, batch->near + path->near_ship_start, path->num_near_ships,
+                           x, y, ship->radius, CENTER_RADIUS)
+        : find_ship_hit(universe, x, y, ship->radius, CENTER_RADIUS, (int)(ship - universe->ships));
+    if (ship_index != -1) {
+        return;
+    }
+
+    // Check planets (only the grid cells around the ship)
+    int planet_index = near
+        ? find_planet_hit_in(universe, near_planets, path->num_near_planets, x, y, ship->radius, CENTER_RADIUS)
+        : find_planet_hit(universe, x, y, ship->radius, CENTER_RADIUS);
+    if (planet_index != -1) {
+        planet_structure *planet = universe_get_planet(universe, planet_index);
+
+        if (planet->is_recycling){
+
+            planet->num_trash += ship->num_trash;
+            
+            if (ship->num_trash != 0){
+                char label[SHIP_LABEL_LEN];
+                ship_id_label(ship->id, label, sizeof(label));
+                printf("Ship %s hit Recycling Planet %c which collected %d trash\n ", label, planet->name, planet->num_trash); 
+            }
+            ship->num_trash = 0;
 
+        }else{
+            if (parallel) {
+                ship->x = x;
+                ship->y = y;
+                return;  // never carrying trash, see may_drop_cargo
+            }
+            set_ship_position(universe, ship, x, y);
+            if (ship->num_trash == 0){
+                // No trash to release
+                return;
+            }
+            char label[SHIP_LABEL_LEN];
+            ship_id_label(ship->id, label, sizeof(label));
+            printf("Ship %s hit Planet %c\n", label, planet->name);
+
+            // Liberar trash coletado pela nave
+            universe_release_ship_trash(universe, ship);
+            return;
+        }
+    }
 
-void check_colision_ship(universe_data *universe, int index, float *x, float *y,
-                      int universe_width, int universe_height)
+    // Check trash
+    int trash_index = near
+        ? find_trash_hit_in(universe, near_trash, path->num_near_trash, x, y, ship->radius, CENTER_RADIUS)
+        : find_trash_hit(universe, x, y, ship->radius, CENTER_RADIUS);
+    if (trash_index != -1 && ship->num_trash < universe->ship_capacity) {
+        trash_handle *handle = &ship->cargo[ship->num_trash++];
+        handle->index = trash_index;
+        handle->generation = universe->trash[trash_index].generation;
+        universe->trash[trash_index].active = false;
+        if (!parallel) {
+            unindex_trash(universe, trash_index);
+            universe->num_trash--;  // Decrementar contador de trash ativo
+        }
+    }
+
+    if (parallel) {
+        ship->x = x;
+        ship->y = y;
+    } else {
+        set_ship_position(universe, ship, x, y);
+    }
+}
+
+void check_colision_ship(universe_data *universe, int index, float *x, float *y)
 {
     ship_structure * ship = universe_get_ship(universe, index);
     if (!ship) {
         return;  // Nave inválida
     }
-    
-    // Check collision with other ships (skip self)
-    /*
-    for (int i = 0; i < universe->num_ships; i++) {
-        if (i == index) continue;  // Pular a própria nave
-        
-        ship_structure *ship1 = universe_get_ship(universe, i);
-        if (!ship1) continue;  // Pular se nave for NULL
-        
-        if (do_circles_intersect(*x, *y, ship->radius,
-                                    ship1->x, ship1->y, CENTER_RADIUS)) {
-            printf("Ship %c hit Ship %c\n", ship->name, ship1->name);
-            return;
+
+    move_ship(universe, ship, *x, *y, NULL, NULL);
+}
+
+// ===== Tick Movement =====
+
+int move_batch_init(move_batch *batch, int max_ships) {
+    batch->max_ships = max_ships;
+    batch->paths = (ship_path*)calloc(max_ships > 0 ? max_ships : 1, sizeof(ship_path));
+    batch->near_capacity = 1024;
+    batch->near = (int*)malloc(sizeof(int) * batch->near_capacity);
+    batch->claims = NULL;
+    batch->num_claims = 0;
+    batch->parallel = (int*)malloc(sizeof(int) * (max_ships > 0 ? max_ships : 1));
+    batch->order_keys = (uint64_t*)malloc(sizeof(uint64_t) * (max_ships > 0 ? max_ships : 1));
+    batch->order = (int*)malloc(sizeof(int) * (max_ships > 0 ? max_ships : 1));
+    batch->workers = NULL;
+    if (!batch->paths || !batch->near || !batch->parallel || !batch->order_keys || !batch->order) {
+        fprintf(stderr, "Failed to allocate ship moves\n");
+        move_batch_destroy(batch);
+        return -1;
+    }
+    return 0;
+}
+
+void move_batch_destroy(move_batch *batch) {
+    if (batch->workers) {
+        worker_pool_destroy(batch->workers);
+        free(batch->workers);
+    }
+    if (batch->paths) {
+        for (int i = 0; i < batch->max_ships; i++) {
+            free(batch->paths[i].runs);
         }
     }
-    */
-    
-    // Check planets
-    for (int i = 0; i < universe->num_planets; i++) {
-        planet_structure *planet = universe_get_planet(universe, i);
-        if (!planet) continue;  // Pular se planeta for NULL
-        
-        
-        if (do_circles_intersect(*x, *y, ship->radius,
-                                    planet->x, planet->y, CENTER_RADIUS)) {
-            if (planet->is_recycling){
-
-                planet->num_trash += ship->num_trash;
-                
-                if (ship->num_trash != 0){
-                    printf("Ship %c hit Recycling Planet %c which collected %d trash\n ", ship->name, planet->name, planet->num_trash); 
-                }
-            
-                if (ship->trash_indexs) {
-                    free(ship->trash_indexs);
-                }
-                ship->trash_indexs = NULL;
-                ship->num_trash = 0;
-                break;
+    free(batch->paths);
+    free(batch->near);
+    free(batch->claims);
+    free(batch->parallel);
+    free(batch->order_keys);
+    free(batch->order);
+    batch->paths = NULL;
+    batch->near = NULL;
+    batch->claims = NULL;
+    batch->parallel = NULL;
+    batch->order_keys = NULL;
+    batch->order = NULL;
+    batch->workers = NULL;
+    batch->max_ships = 0;
+    batch->near_capacity = 0;
+    batch->num_claims = 0;
+}
 
+int move_batch_start_workers(move_batch *batch, int num_threads) {
+    if (batch->workers || num_threads <= 0) {
+        return 0;
+    }
+    batch->workers = (worker_pool*)malloc(sizeof(worker_pool));
+    if (!batch->workers || worker_pool_init(batch->workers, num_threads) != 0) {
+        fprintf(stderr, "Failed to start %d move workers\n", num_threads);
+        free(batch->workers);
+        batch->workers = NULL;
+        return -1;
+    }
+    return 0;
+}
 
-            }else{
-                ship->x = *x;
-                ship->y = *y;
-                if (ship->num_trash == 0){
-                    // No trash to release
-                    return;
-                }
-                printf("Ship %c hit Planet %c\n", ship->name, planet->name);
-                
-                // Liberar trash coletado pela nave
-                for (int j = 0; j < ship->num_trash; j++){
-                    int trash_idx = ship->trash_indexs[j];
-                    
-                    // Acessar diretamente o array para pegar lixo inativo
-                    if (universe && trash_idx >= 0 && trash_idx < universe->max_trash) {
-                        trash_structure *trash_released = &universe->trash[trash_idx];
-                        
-                        trash_released->active = true;
-                        float new_x, new_y;
-                        chose_position(universe, &new_x, &new_y, trash_released->radius, 
-                                     universe_width, universe_height);
-                        
-                        trash_released->x = new_x;
-                        trash_released->y = new_y;
-                        universe->num_trash++; // Importante: incrementar o contador de lixo ativo!
-                        printf("Trash %d released back into universe at (%.1f, %.1f)\n", trash_idx, new_x, new_y);
-                    }
+bool move_batch_add_step(move_batch *batch, int index, int dx, int dy) {
+    if (index < 0 || index >= batch->max_ships) {
+        return false;
+    }
+    ship_path *path = &batch->paths[index];
+    if (path->num_steps >= MAX_TICK_STEPS) {
+        return false;
+    }
+    path_run *last = path->num_runs > 0 ? &path->runs[path->num_runs - 1] : NULL;
+    if (last && last->dx == dx && last->dy == dy) {
+        last->count++;
+        path->num_steps++;
+        return true;
+    }
+    if (path->num_runs == path->max_runs) {
+        int max_runs = path->max_runs > 0 ? path->max_runs * 2 : 4;
+        path_run *runs = (path_run*)realloc(path->runs, sizeof(path_run) * max_runs);
+        if (!runs) {
+            return false;
+        }
+        path->runs = runs;
+        path->max_runs = max_runs;
+    }
+    path->runs[path->num_runs++] = (path_run){(signed char)dx, (signed char)dy, 1};
+    path->num_steps++;
+    return true;
+}
+
+// The path's next step in the lockstep. Returns false once it took them all
+static bool path_next_step(ship_path *path, int *dx, int *dy) {
+    while (path->next_run < path->num_runs && path->next_taken == path->runs[path->next_run].count) {
+        path->next_run++;
+        path->next_taken = 0;
+    }
+    if (path->next_run == path->num_runs) {
+        return false;
+    }
+    *dx = path->runs[path->next_run].dx;
+    *dy = path->runs[path->next_run].dy;
+    path->next_taken++;
+    return true;
+}
+
+// Empty the path for the next tick, keeping its runs array
+static void path_clear(ship_path *path) {
+    path->num_runs = 0;
+    path->num_steps = 0;
+    path->next_run = 0;
+    path->next_taken = 0;
+}
+
+// Append an index to batch->near. Returns false if it could not grow
+static bool add_near(move_batch *batch, int *count, int item) {
+    if (*count == batch->near_capacity) {
+        int *grown = (int*)realloc(batch->near, sizeof(int) * batch->near_capacity * 2);
+        if (!grown) {
+            return false;
+        }
+        batch->near = grown;
+        batch->near_capacity *= 2;
+    }
+    batch->near[(*count)++] = item;
+    return true;
+}
+
+// Append what a grid holds in the cells of the square to batch->near
+static int gather_near(move_batch *batch, int *count, const spatial_grid *grid,
+                       float x, float y, float half_side) {
+    int col_min, row_min, col_max, row_max;
+    spatial_grid_cell_range(grid, x, y, half_side, &col_min, &row_min, &col_max, &row_max);
+
+    int gathered = 0;
+    for (int row = row_min; row <= row_max; row++) {
+        for (int col = col_min; col <= col_max; col++) {
+            for (int i = grid->head[row * grid->cols + col]; i != -1; i = grid->next[i]) {
+                if (!add_near(batch, count, i)) {
+                    return -1;
                 }
-                
-                if (ship->trash_indexs) {
-                    free(ship->trash_indexs);
+                gathered++;
+            }
+        }
+    }
+    return gathered;
+}
+
+// Append the ships, other than skip, centered in the rectangle to batch->near
+static int gather_near_ships(universe_data *universe, move_batch *batch, int *count,
+                             float min_x, float min_y, float max_x, float max_y, int skip) {
+    int low = 0, high = universe->num_ships;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (universe->ships[universe->ship_sweep[mid]].x < min_x) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    int gathered = 0;
+    for (int slot = low; slot < universe->num_ships; slot++) {
+        int i = universe->ship_sweep[slot];
+        ship_structure *other = &universe->ships[i];
+        if (other->x > max_x) {
+            break;
+        }
+        if (i != skip && other->y >= min_y && other->y <= max_y) {
+            if (!add_near(batch, count, i)) {
+                return -1;
+            }
+            gathered++;
+        }
+    }
+    return gathered;
+}
+
+// Trash grid cells of the square, not clamped to the grid so they can wrap
+static void set_region(const universe_data *universe, ship_path *path, float x, float y, float half_side) {
+    const spatial_grid *grid = &universe->trash_grid;
+    path->region_col = (int)floorf((x - half_side) / grid->cell_size);
+    path->region_row = (int)floorf((y - half_side) / grid->cell_size);
+    path->region_cols = (int)floorf((x + half_side) / grid->cell_size) - path->region_col + 1;
+    path->region_rows = (int)floorf((y + half_side) / grid->cell_size) - path->region_row + 1;
+    if (path->region_cols > grid->cols) path->region_cols = grid->cols;
+    if (path->region_rows > grid->rows) path->region_rows = grid->rows;
+}
+
+// Collect the trash and planets the ship could reach along its whole path,
+// so its steps only test those instead of walking grid cells every time
+static void gather_path(universe_data *universe, move_batch *batch, int *count,
+                        const ship_structure *ship, ship_path *path) {
+    int x = 0, y = 0, min_x = 0, max_x = 0, min_y = 0, max_y = 0;
+    // Each run goes straight, so its ends are enough
+    for (int r = 0; r < path->num_runs; r++) {
+        x += path->runs[r].dx * path->runs[r].count;
+        y += path->runs[r].dy * path->runs[r].count;
+        if (x < min_x) min_x = x;
+        if (x > max_x) max_x = x;
+        if (y < min_y) min_y = y;
+        if (y > max_y) max_y = y;
+    }
+
+    // Anything closer than this to a point of the path can be hit
+    float reach = ship->radius + CENTER_RADIUS;
+    float center_x = ship->x + (min_x + max_x) / 2.0f;
+    float center_y = ship->y + (min_y + max_y) / 2.0f;
+    int side = (max_x - min_x) > (max_y - min_y) ? (max_x - min_x) : (max_y - min_y);
+    float half_side = side / 2.0f + reach;
+
+    // One pixel more, circles are tested on whole pixel distances
+    set_region(universe, path, center_x, center_y, half_side + 1);
+    path->parallel = false;
+    path->num_near_ships = 0;
+    path->has_near = false;
+    if (ship->x + min_x - reach < 0 || ship->x + max_x + reach >= universe->universe_width ||
+        ship->y + min_y - reach < 0 || ship->y + max_y + reach >= universe->universe_height) {
+        return;  // wraps around, the grids are used step by step
+    }
+
+    path->near_start = *count;
+    path->num_near_trash = gather_near(batch, count, &universe->trash_grid, center_x, center_y, half_side);
+    path->num_near_planets = gather_near(batch, count, &universe->planet_grid, center_x, center_y, half_side);
+    path->has_near = path->num_near_trash >= 0 && path->num_near_planets >= 0;
+}
+
+#define CLAIM_FREE -1
+#define CLAIM_CONTESTED -2
+
+// True if no other moving ship claimed any cell of the region of ship k
+static bool region_is_own(const move_batch *batch, const spatial_grid *grid, const ship_path *path, int k) {
+    for (int r = 0; r < path->region_rows; r++) {
+        int row = ((path->region_row + r) % grid->rows + grid->rows) % grid->rows;
+        for (int c = 0; c < path->region_cols; c++) {
+            int col = ((path->region_col + c) % grid->cols + grid->cols) % grid->cols;
+            if (batch->claims[row * grid->cols + col] != k) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Hitting a planet other than the recycling one with cargo releases it
+// anywhere in the universe, which only the caller may do
+static bool may_drop_cargo(const universe_data *universe, const move_batch *batch,
+                           const ship_structure *ship, const ship_path *path) {
+    if (ship->num_trash == 0 && path->num_near_trash == 0) {
+        return false;
+    }
+    const int *near_planets = batch->near + path->near_start + path->num_near_trash;
+    for (int i = 0; i < path->num_near_planets; i++) {
+        if (!universe->planets[near_planets[i]].is_recycling) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Every moving ship claims the cells of its region, a cell claimed twice is
+// contested. Ships with all their cells to themselves go to batch->parallel.
+// Returns how many did
+static int claim_regions(universe_data *universe, move_batch *batch, int *count,
+                         const int *order, int num_moving) {
+    const spatial_grid *grid = &universe->trash_grid;
+    int num_cells = grid->cols * grid->rows;
+    if (batch->num_claims < num_cells) {
+        int *grown = (int*)realloc(batch->claims, sizeof(int) * num_cells);
+        if (!grown) {
+            return 0;
+        }
+        batch->claims = grown;
+        batch->num_claims = num_cells;
+    }
+    for (int i = 0; i < num_cells; i++) {
+        batch->claims[i] = CLAIM_FREE;
+    }
+
+    for (int k = 0; k < num_moving; k++) {
+        ship_path *path = &batch->paths[order[k]];
+        for (int r = 0; r < path->region_rows; r++) {
+            int row = ((path->region_row + r) % grid->rows + grid->rows) % grid->rows;
+            for (int c = 0; c < path->region_cols; c++) {
+                int col = ((path->region_col + c) % grid->cols + grid->cols) % grid->cols;
+                int *claim = &batch->claims[row * grid->cols + col];
+                if (*claim == CLAIM_FREE) {
+                    *claim = k;
+                } else if (*claim != k) {
+                    *claim = CLAIM_CONTESTED;
                 }
-                ship->trash_indexs = NULL;
-                ship->num_trash = 0;
-                return;
             }
         }
     }
 
-    // Check trash
-    for (int i = 0; i < universe->max_trash; i++) {
-        trash_structure *trash = universe_get_trash(universe, i);
-        if (!trash) continue;  // Pular se trash for NULL ou inativo
-        
-        if (do_circles_intersect(*x, *y, ship->radius,
-                                    trash->x, trash->y, CENTER_RADIUS)) {
-
-            if(ship->num_trash < universe->ship_capacity){
-                ship->num_trash++;
-                ship->trash_indexs = (int*)realloc(ship->trash_indexs, sizeof(int) * ship->num_trash);
-                ship->trash_indexs[ship->num_trash - 1] = i;
-                trash->active = false;
-                universe->num_trash--;  // Decrementar contador de trash ativo
+    int num_parallel = 0;
+    for (int k = 0; k < num_moving; k++) {
+        ship_structure *ship = &universe->ships[order[k]];
+        ship_path *path = &batch->paths[order[k]];
+        if (!path->has_near || !region_is_own(batch, grid, path, k) ||
+            may_drop_cargo(universe, batch, ship, path)) {
+            continue;
+        }
+
+        // The other ships in the region stand still this tick
+        path->near_ship_start = *count;
+        path->num_near_ships = gather_near_ships(universe, batch, count,
+                                                 path->region_col * grid->cell_size,
+                                                 path->region_row * grid->cell_size,
+                                                 (path->region_col + path->region_cols) * grid->cell_size,
+                                                 (path->region_row + path->region_rows) * grid->cell_size,
+                                                 order[k]);
+        if (path->num_near_ships < 0) {
+            path->num_near_ships = 0;
+            continue;
+        }
+        path->parallel = true;
+        path->from_x = ship->x;
+        path->from_y = ship->y;
+        batch->parallel[num_parallel++] = order[k];
+    }
+    return num_parallel;
+}
+
+typedef struct {
+    universe_data *universe;
+    move_batch *batch;
+} move_job;
+
+// Worker task: every step of one parallel path
+static void resolve_parallel_path(void *arg, int item) {
+    move_job *job = (move_job*)arg;
+    int index = job->batch->parallel[item];
+    ship_structure *ship = &job->universe->ships[index];
+    ship_path *path = &job->batch->paths[index];
+
+    // has_near paths never cross an edge
+    int dx, dy;
+    while (path_next_step(path, &dx, &dy)) {
+        move_ship(job->universe, ship, ship->x + dx, ship->y + dy, job->batch, path);
+    }
+}
+
+// What the workers left for later because all ships share it: the free
+// space map, the ship sweep and the grids of the trash picked up
+static void finish_parallel(universe_data *universe, move_batch *batch, int num_parallel) {
+    for (int k = 0; k < num_parallel; k++) {
+        int index = batch->parallel[k];
+        ship_structure *ship = &universe->ships[index];
+        ship_path *path = &batch->paths[index];
+
+        free_space_release(&universe->free_space, path->from_x, path->from_y, ship->radius);
+        free_space_occupy(&universe->free_space, ship->x, ship->y, ship->radius);
+
+        const int *near_trash = batch->near + path->near_start;
+        for (int i = 0; i < path->num_near_trash; i++) {
+            int trash = near_trash[i];
+            if (!universe->trash[trash].active && universe->trash_grid.cell[trash] != -1) {
+                unindex_trash(universe, trash);
+                universe->num_trash--;
             }
-            break;
         }
+        path->parallel = false;
+        path_clear(path);  // done, the lockstep below skips it
+    }
+    sweep_sort(universe);
+}
+
+static int compare_order(const void *a, const void *b) {
+    uint64_t ka = *(const uint64_t*)a;
+    uint64_t kb = *(const uint64_t*)b;
+    return (ka > kb) - (ka < kb);
+}
+
+void universe_resolve_moves(universe_data *universe, move_batch *batch) {
+    // Ships with somewhere to go, in id order
+    int num_moving = 0;
+    int max_steps = 0;
+    for (int index = 0; index < universe->num_ships && index < batch->max_ships; index++) {
+        if (batch->paths[index].num_steps > 0) {
+            batch->order_keys[num_moving++] = ((uint64_t)universe->ships[index].id << 32) | (uint32_t)index;
+            if (batch->paths[index].num_steps > max_steps) {
+                max_steps = batch->paths[index].num_steps;
+            }
+        }
+    }
+    qsort(batch->order_keys, num_moving, sizeof(uint64_t), compare_order);
+    int *order = batch->order;
+    for (int k = 0; k < num_moving; k++) {
+        order[k] = (int)(batch->order_keys[k] & 0xFFFFFFFF);
+    }
+
+    int count = 0;
+    for (int k = 0; k < num_moving; k++) {
+        gather_path(universe, batch, &count, &universe->ships[order[k]], &batch->paths[order[k]]);
+    }
+
+    if (batch->workers && num_moving > 1) {
+        int num_parallel = claim_regions(universe, batch, &count, order, num_moving);
+        if (num_parallel > 0) {
+            move_job job = {universe, batch};
+            worker_pool_run(batch->workers, num_parallel, resolve_parallel_path, &job);
+            finish_parallel(universe, batch, num_parallel);
+        }
+    }
+
+    for (int s = 0; s < max_steps; s++) {
+        for (int k = 0; k < num_moving; k++) {
+            ship_path *path = &batch->paths[order[k]];
+            int dx, dy;
+            if (s >= path->num_steps || !path_next_step(path, &dx, &dy)) continue;
+
+            ship_structure *ship = &universe->ships[order[k]];
+            float x = ship->x + dx;
+            float y = ship->y + dy;
+            correct_position(&x, universe->universe_width);
+            correct_position(&y, universe->universe_height);
+            move_ship(universe, ship, x, y, batch, path);
+        }
+    }
+
+    for (int k = 0; k < num_moving; k++) {
+        path_clear(&batch->paths[order[k]]);
     }
-    
-    ship->x = *x;
-    ship->y = *y;
 }
 
 
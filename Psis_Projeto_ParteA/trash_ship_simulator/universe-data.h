@@ -3,6 +3,12 @@
 
 #include <stdbool.h>
 #include "config.h"
+#include "flow-field.h"
+#include "free-space.h"
+#include "id-map.h"
+#include "ship-id.h"
+#include "spatial-grid.h"
+#include "worker-pool.h"
 
 // Constants from project specification
 #define PLANET_MASS 10.0
@@ -13,8 +19,11 @@
 #define TRASH_FRICTION 0.99  // reduces velocity by 1% per time unit
 #define SHIP_RADIUS 15
 #define SHIP_CAPACITY 26
-#define MAX_SHIPS 26
 #define CENTER_RADIUS 1.0
+#define FREE_SPACE_CELL_SIZE 4
+#define PLACEMENT_ATTEMPTS 32  // random free cells tried before a full sweep
+#define INTEREST_CELL_SIZE 50  // cells of the grid clients' interest regions are made of
+#define FLOW_CELL_SIZE 8       // cells of the flow field leading to the recycling planet
 
 
 // Vector structure for physics calculations
@@ -43,16 +52,29 @@ typedef struct {
     vector velocity;      // velocity (amplitude + angle)
     vector acceleration;  // acceleration calculated by gravity
     bool active;          // true if this trash exists (not collected/destroyed)
+    unsigned int generation;  // bumped every time the slot gets new trash
 } trash_structure;
 
+// Reference to a piece of trash carried by a ship. Once picked up the trash
+// slot is free for new trash, so the handle only names the same piece while
+// the slot generation still matches. Index -1: picked up on another shard.
+typedef struct {
+    int index;
+    unsigned int generation;
+} trash_handle;
+
 // Ship structure
 typedef struct {
     float x;              // X position
     float y;              // Y position
     float radius;         // radiys (always 10.0)
-    char name;            // single letter identifier (A, B, C, ...)
-    int *trash_indexs;
+    ship_id id;           // see ship-id.h, shown as a letter
+    trash_handle *cargo;  // ship_capacity entries in universe->cargo_pool
     int num_trash;
+    unsigned int input_keys;  // direction keys held by the player (INPUT_* bits)
+    unsigned int input_seq;   // client number of the input that set input_keys
+    unsigned int input_ticks; // ticks run since that input was applied
+    int sweep_slot;           // position in universe->ship_sweep
 } ship_structure;
 
 // Universe structure - holds all universe data
@@ -65,15 +87,33 @@ typedef struct {
     int num_trash;
     int max_trash;
 
-    ship_structure *ships;
+    ship_structure *ships;   // ships[0..num_ships) are all connected
     int num_ships;
     int max_ships;
     int ship_capacity;
+    id_map ship_slots;             // ship id -> index in ships
+    trash_handle *cargo_pool;      // max_ships * ship_capacity, one slice per ship slot
+    int *ship_sweep;               // ship indices sorted by x, for ship-ship collisions
     
     int universe_width;
     int universe_height;
     
     int recycling_planet_index;  // index of current recycling planet
+
+    // Active trash and planets by position, cells are SHIP_RADIUS wide
+    spatial_grid trash_grid;
+    spatial_grid planet_grid;
+
+    // Active trash in coarse INTEREST_CELL_SIZE cells, for client updates
+    spatial_grid interest_grid;
+
+    // Cells not covered by any planet, trash or ship, for chose_position
+    free_space_map free_space;
+
+    // Steps toward the recycling planet around the others, rebuilt when
+    // the recycling planet changes
+    flow_field recycling_flow;
+    int flow_target;             // planet the field leads to, -1 if not built yet
 } universe_data;
 
 // ===== Universe Management =====
@@ -96,6 +136,11 @@ planet_structure* universe_get_planet(universe_data *universe, int index);
 // Set recycling planet (by index)
 void universe_set_recycling_planet(universe_data *universe, int index);
 
+// Step (-1, 0 or 1 per axis) from (x, y) toward the recycling planet that
+// keeps clear of every other planet. Returns false next to the recycling
+// planet, where it cannot be reached, or if there is none yet.
+bool universe_recycling_step(universe_data *universe, float x, float y, int *dx, int *dy);
+
 // Initialize planets in the universe with automatic positioning
 void universe_initialize_planets(universe_data *universe);
 
@@ -113,6 +158,9 @@ trash_structure* universe_get_trash(universe_data *universe, int index);
 // Remove/deactivate trash
 void universe_remove_trash(universe_data *universe, int index);
 
+// Move active trash to a new position (keeps the trash grid up to date)
+void universe_move_trash(universe_data *universe, int index, float x, float y);
+
 // Count active trash
 int universe_count_active_trash(universe_data *universe);
 
@@ -127,13 +175,27 @@ vector make_vector(float x, float y);
 // Add two vectors
 vector add_vectors(vector v1, vector v2);
 
-// ===== Planet Functions =====
+// ===== Ship Functions =====
 
-int universe_add_ship(universe_data *universe, float x, float y, char letter);
+int universe_add_ship(universe_data *universe, float x, float y, ship_id id);
 
 // Get ship by index
 ship_structure* universe_get_ship(universe_data *universe, int index);
 
+// Index of the ship with this id, or -1 if it is not connected
+int universe_find_ship(universe_data *universe, ship_id id);
+
+// Remove a ship, releasing its cargo back into the universe. The last ship
+// is moved into the freed slot so ships stay contiguous.
+void universe_remove_ship(universe_data *universe, int index);
+
+// Give a ship count pieces of trash picked up on another shard. They have
+// no slot here, new trash is made for them if the ship releases them.
+void universe_load_foreign_cargo(universe_data *universe, ship_structure *ship, int count);
+
+// Put every trash piece carried by the ship back at a free position
+void universe_release_ship_trash(universe_data *universe, ship_structure *ship);
+
 // ===== Utility Functions =====
 
 // Correct position for universe wraparound (teleportation at edges)
@@ -148,10 +210,95 @@ void universe_print_info(universe_data *universe);
 // Check if universe has collapsed (trash reached maximum)
 bool universe_has_collapsed(universe_data *universe);
 
-void chose_position(universe_data *universe, float *x, float *y, int radius, int universe_width, int universe_height);
+// Find a position where a circle of the given radius touches no planet,
+// trash or ship. Returns 0 on success, -1 if there is no room left.
+int chose_position(universe_data *universe, float *x, float *y, int radius, int universe_width, int universe_height);
+
+// Active trash closest to (x, y), -1 if there is none. Searches the trash
+// grid in rings of cells around the point and stops as soon as no farther
+// ring can hold anything closer, so the cost follows how far the nearest
+// piece is, not how much trash there is.
+int universe_nearest_trash(universe_data *universe, float x, float y);
+
+void check_colision_ship(universe_data *universe, int index, float *x, float *y);
+
+// ===== Tick Movement =====
 
-void check_colision_ship(universe_data *universe, int index, float *x, float *y,
-                    int universe_width, int universe_height);
+#define MAX_TICK_STEPS 1024  // steps one ship can take in a single tick
+
+// Steps in the same direction, one pixel at most per axis each
+typedef struct {
+    signed char dx;
+    signed char dy;
+    unsigned short count;
+} path_run;
+
+// Where one ship goes during a tick. A queued move or held keys give one
+// run of steps, so the runs only grow as far as a tick needs them (a bot
+// takes one) and are kept for the next ticks.
+typedef struct {
+    path_run *runs;
+    int num_runs;
+    int max_runs;
+    int num_steps;         // over all runs
+    int next_run;          // the lockstep's place along the runs
+    int next_taken;        //   and steps of that run already taken
+    int near_start;        // its trash then planets in move_batch.near
+    int num_near_trash;
+    int num_near_planets;
+    int near_ship_start;   // ships around a parallel path in move_batch.near
+    int num_near_ships;
+    bool has_near;         // false: the path wraps around an edge, use the grids
+    int region_col;        // trash grid cells around the path, the columns and
+    int region_row;        //   rows past an edge wrap around
+    int region_cols;
+    int region_rows;
+    bool parallel;         // resolved on a worker thread
+    float from_x;          // where a parallel path started
+    float from_y;
+} ship_path;
+
+// Moves of every ship for one tick. While inputs are drained ships only
+// record their steps, universe_resolve_moves then deals with what they run
+// into for all of them together, looking the grids up once per ship.
+typedef struct {
+    ship_path *paths;      // by ship index
+    int max_ships;
+    int *near;             // what lies around each path, gathered once per tick
+    int near_capacity;
+    int *claims;           // ship claiming each trash grid cell this tick
+    int num_claims;
+    int *parallel;         // ships resolved on the workers this tick
+    uint64_t *order_keys;  // moving ships of the tick as id << 32 | index, to sort them
+    int *order;            // their indices in id order
+    worker_pool *workers;  // NULL resolves every path on the calling thread
+} move_batch;
+
+// Returns 0 on success, -1 on error
+int move_batch_init(move_batch *batch, int max_ships);
+void move_batch_destroy(move_batch *batch);
+
+// Resolve paths on num_threads worker threads besides the caller (0 keeps
+// it all on the caller). Returns 0 on success, -1 on error
+int move_batch_start_workers(move_batch *batch, int num_threads);
+
+// Add a step to the path of the ship at index. Returns false if the path is full
+bool move_batch_add_step(move_batch *batch, int index, int dx, int dy);
+
+// Move every ship along its path and empty the paths. All ships take their
+// n-th step before any takes the next one, in ship id order, so when two
+// reach the same trash the one that got there in fewer steps takes it and
+// ties go to the lower id, whatever order their requests came in. Trash
+// released on a planet during the tick is collected from the next one on.
+//
+// With workers, every moving ship first claims the trash grid cells around
+// its path, in ship id order. A ship whose cells no other moving ship
+// claimed cannot meet any of them, so it takes all its steps at once on a
+// worker, the others in lockstep afterwards. The outcome is the same as
+// without workers. Paths that wrap around an edge, and ships that could
+// drop their cargo on a planet (it is placed anywhere in the universe),
+// always stay on the caller.
+void universe_resolve_moves(universe_data *universe, move_batch *batch);
 
 bool do_circles_intersect(float x1, float y1, float radius1,  float x2, float y2, float radius2);
 
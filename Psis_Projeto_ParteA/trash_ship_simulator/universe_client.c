@@ -6,6 +6,309 @@
 #include <stdlib.h>
 #include <time.h>
 
+#define INPUT_KEEPALIVE_MS 1000  // resend held keys this often when nothing changes
+#define VIEW_SIZE 300            // window side, centered on our ship
+#define REPLY_TIMEOUT_MS 2000    // server considered gone after this long without a reply
+#define PREDICTION_HISTORY 1024  // client ticks of sent keys kept for replay
+#define INPUT_HISTORY 256        // inputs that can be waiting for the server at once
+#define RTT_LOG_MS 5000          // round trip percentiles are printed this often
+#define FRAME_NS (1000000000ull / 60)  // 60 FPS, whatever the server's latency
+
+// Entities in our ship's interest region, kept up to date from the server's
+// world updates and sorted by id
+typedef struct {
+    entity_state *entities;
+    int count;
+    int capacity;
+    uint32_t seq;   // of the last update applied
+    int synced;     // 0 after a lost update until the next full one
+} local_view;
+
+static int compare_entities(const void *a, const void *b) {
+    uint64_t x = ((const entity_state*)a)->id;
+    uint64_t y = ((const entity_state*)b)->id;
+    return (x > y) - (x < y);
+}
+
+static entity_state *find_entity(local_view *view, uint64_t id) {
+    entity_state key = {.id = id};
+    return bsearch(&key, view->entities, view->count, sizeof(entity_state), compare_entities);
+}
+
+// Our own ship moves as soon as keys are pressed instead of a round trip
+// later, even while they wait for the request in flight to be answered.
+// Client and server both move it one pixel per held key per tick, so the
+// server position plus the ticks the client ran after the server's ack
+// (last input applied + ticks since) is where the server will have it.
+typedef struct {
+    session_info session;
+    uint32_t tick;                        // client ticks run since connecting
+    uint8_t keys_at[PREDICTION_HISTORY];  // keys held during each tick
+    uint32_t input_tick[INPUT_HISTORY];   // tick at which each input seq was sent
+    uint32_t next_seq;
+    int has_position;                     // a server position arrived
+    int32_t x;                            // predicted position
+    int32_t y;
+} prediction;
+
+// Round trips of our requests as the player sees them: from the client clock
+// echoed in each reply to the moment the loop reads that reply, so socket
+// queueing and the server's poll are included
+typedef struct {
+    latency_histogram window;  // since the last periodic line
+    latency_histogram total;
+    uint32_t stale;            // replies not echoing the request we wait for
+} rtt_stats;
+
+static void record_rtt(rtt_stats *rtt, const request_echo *echo, uint32_t seq) {
+    if (!echo->valid || echo->seq != seq) {
+        rtt->stale++;
+        return;
+    }
+    uint64_t elapsed = latency_now_ns() - echo->sent_ns;
+    latency_record(&rtt->window, elapsed);
+    latency_record(&rtt->total, elapsed);
+}
+
+static void log_rtt(rtt_stats *rtt) {
+    const latency_histogram *h = &rtt->window;
+    if (h->total_count == 0) {
+        return;
+    }
+    printf("RTT over %llu replies: p50 %.2f ms, p90 %.2f ms, p99 %.2f ms, max %.2f ms\n",
+           (unsigned long long)h->total_count,
+           latency_percentile(h, 50) / 1e6, latency_percentile(h, 90) / 1e6,
+           latency_percentile(h, 99) / 1e6, h->max / 1e6);
+    latency_reset(&rtt->window);
+}
+
+// The server as the loop sees it. Only key changes are sent, the server
+// keeps moving the ship while a key is held; the state is repeated now and
+// then so a long hold does not look like an idle client. Nothing here
+// blocks: the reply and world updates are handled whenever the loop polls,
+// so a slow server only delays what it sends, never the window.
+typedef struct {
+    void *requests;        // REQ socket, one request in flight at a time
+    void *updates;         // world updates for our ship
+    ship_id ship;
+    uint32_t token;        // proves to the server that the ship is ours
+    uint32_t keys;         // held by the player
+    uint32_t sent_keys;    // last sent to the server
+    Uint32 last_sent;
+    int awaiting_reply;
+    uint32_t sent_seq;
+    int resync;            // updates were lost, ask for the whole region
+    rtt_stats rtt;
+} server_link;
+
+static void wrap(int32_t *pos, int32_t size) {
+    if (*pos < 0) {
+        *pos += size;
+    } else if (*pos >= size) {
+        *pos -= size;
+    }
+}
+
+// Same steps as the server's advance_ships
+static void move_predicted(const prediction *pred, uint32_t keys, int32_t *x, int32_t *y) {
+    if (keys & INPUT_UP) { (*y)--; wrap(y, pred->session.universe_height); }
+    if (keys & INPUT_DOWN) { (*y)++; wrap(y, pred->session.universe_height); }
+    if (keys & INPUT_LEFT) { (*x)--; wrap(x, pred->session.universe_width); }
+    if (keys & INPUT_RIGHT) { (*x)++; wrap(x, pred->session.universe_width); }
+}
+
+static void predict_tick(prediction *pred, uint32_t keys) {
+    pred->keys_at[pred->tick % PREDICTION_HISTORY] = (uint8_t)keys;
+    move_predicted(pred, keys, &pred->x, &pred->y);
+    pred->tick++;
+}
+
+// Number the next input and remember when it was sent
+static uint32_t record_input(prediction *pred) {
+    uint32_t seq = ++pred->next_seq;
+    pred->input_tick[seq % INPUT_HISTORY] = pred->tick;
+    return seq;
+}
+
+// Start from the server's position and replay what it has not applied yet
+static void reconcile(prediction *pred, int32_t server_x, int32_t server_y,
+                      uint32_t ack_seq, uint32_t ack_ticks) {
+    pred->has_position = 1;
+    pred->x = server_x;
+    pred->y = server_y;
+    if (ack_seq == 0 || pred->next_seq - ack_seq >= INPUT_HISTORY) {
+        return;  // no input applied yet, or too old to replay
+    }
+
+    uint32_t from = pred->input_tick[ack_seq % INPUT_HISTORY] + ack_ticks;
+    if (from >= pred->tick || pred->tick - from > PREDICTION_HISTORY) {
+        return;  // the server is ahead of our clock, or too far behind
+    }
+    for (uint32_t t = from; t != pred->tick; t++) {
+        move_predicted(pred, pred->keys_at[t % PREDICTION_HISTORY], &pred->x, &pred->y);
+    }
+}
+
+// Apply one world update. Returns -1 if updates were lost or the view could
+// not hold them, and the server must send the whole region again, 0 otherwise.
+static int apply_update(local_view *view, const world_update *update) {
+    if (update->full) {
+        view->count = 0;
+        view->synced = 1;
+    } else if (!view->synced || update->seq != view->seq + 1) {
+        // Nothing applied until a full update: the first one can be missed
+        // while the subscription is still on its way to the server
+        view->synced = 0;
+        return -1;
+    }
+    view->seq = update->seq;
+
+    for (int i = 0; i < update->num_left; i++) {
+        entity_state *entity = find_entity(view, update->left[i]);
+        if (entity) {
+            entity->id = UINT64_MAX;  // removed below, keeps the array sorted meanwhile
+        }
+    }
+    if (update->num_left > 0) {
+        int kept = 0;
+        for (int i = 0; i < view->count; i++) {
+            if (view->entities[i].id != UINT64_MAX) {
+                view->entities[kept++] = view->entities[i];
+            }
+        }
+        view->count = kept;
+    }
+
+    for (int i = 0; i < update->num_moved; i++) {
+        entity_state *entity = find_entity(view, update->moved[i].id);
+        if (entity) {
+            entity->x = update->moved[i].x;
+            entity->y = update->moved[i].y;
+        }
+    }
+
+    if (update->num_entered > 0) {
+        if (view->count + update->num_entered > view->capacity) {
+            int capacity = (view->count + update->num_entered) * 2;
+            entity_state *grown = realloc(view->entities, sizeof(entity_state) * capacity);
+            if (!grown) {
+                // The view is dropped and rebuilt by the next full update
+                fprintf(stderr, "Failed to grow local view\n");
+                view->count = 0;
+                view->synced = 0;
+                return -1;
+            }
+            view->entities = grown;
+            view->capacity = capacity;
+        }
+        memcpy(view->entities + view->count, update->entered, sizeof(entity_state) * update->num_entered);
+        view->count += update->num_entered;
+        qsort(view->entities, view->count, sizeof(entity_state), compare_entities);
+    }
+    return 0;
+}
+
+static const entity_state *find_own_ship(const local_view *view, ship_id ship) {
+    for (int i = 0; i < view->count; i++) {
+        if (view->entities[i].kind == ENTITY_SHIP && view->entities[i].ship == ship) {
+            return &view->entities[i];
+        }
+    }
+    return NULL;
+}
+
+// Send the keys if they changed or are due again and no request is in
+// flight; keys changed meanwhile go out as soon as its reply is read
+static void send_keys(server_link *link, prediction *pred) {
+    if (!link->awaiting_reply &&
+        (link->keys != link->sent_keys || link->resync ||
+         SDL_GetTicks() - link->last_sent >= INPUT_KEEPALIVE_MS)) {
+        link->sent_seq = record_input(pred);
+        send_input_message(link->requests, link->ship, link->token, link->keys, link->sent_seq, link->resync);
+        link->resync = 0;
+        link->awaiting_reply = 1;
+        link->sent_keys = link->keys;
+        link->last_sent = SDL_GetTicks();
+    }
+}
+
+// Send the keys if due, then wait up to timeout_ms for the reply or world
+// updates and apply whatever came. Returns -1 once the ship is gone or the
+// server stopped answering.
+static int poll_server(server_link *link, prediction *pred, local_view *view,
+                       world_update *update, int timeout_ms) {
+    send_keys(link, pred);
+
+    // The request socket only has something to read while a reply is due
+    zmq_pollitem_t items[2] = {
+        {link->updates, 0, ZMQ_POLLIN, 0},
+        {link->requests, 0, ZMQ_POLLIN, 0},
+    };
+    if (zmq_poll(items, link->awaiting_reply ? 2 : 1, timeout_ms) < 0) {
+        return 0;  // interrupted, polled again right away
+    }
+
+    if (items[1].revents & ZMQ_POLLIN) {
+        char message[100];
+        request_echo echo;
+        receive_response(link->requests, message, &echo);
+        record_rtt(&link->rtt, &echo, link->sent_seq);
+        link->awaiting_reply = 0;
+        if (strcmp(message, "OK") != 0) {
+            char label[SHIP_LABEL_LEN];
+            printf("Ship %s is no longer in the universe (%s)\n",
+                   ship_id_label(link->ship, label, sizeof(label)), message);
+            return -1;
+        }
+        send_keys(link, pred);
+    } else if (link->awaiting_reply && SDL_GetTicks() - link->last_sent >= REPLY_TIMEOUT_MS) {
+        printf("No answer from the server\n");
+        return -1;
+    }
+
+    while (receive_world_update(link->updates, update) > 0) {
+        if (apply_update(view, update) != 0) {
+            link->resync = 1;
+            continue;
+        }
+        const entity_state *own = find_own_ship(view, link->ship);
+        if (own) {
+            reconcile(pred, own->x, own->y, update->ack_seq, update->ack_ticks);
+        }
+    }
+    return 0;
+}
+
+// Draw what our ship can see, centered on its predicted position
+static void render_view(SDL_Renderer *rend, const local_view *view, const prediction *pred, ship_id ship) {
+    if (!pred->has_position) return;
+
+    for (int i = 0; i < view->count; i++) {
+        const entity_state *entity = &view->entities[i];
+        int32_t x = entity->x;
+        int32_t y = entity->y;
+        int size;
+        if (entity->kind == ENTITY_PLANET) {
+            SDL_SetRenderDrawColor(rend, 40, 90, 200, 255);
+            size = 16;
+        } else if (entity->kind == ENTITY_SHIP && entity->ship == ship) {
+            SDL_SetRenderDrawColor(rend, 0, 160, 40, 255);
+            size = 12;
+            x = pred->x;
+            y = pred->y;
+        } else if (entity->kind == ENTITY_SHIP) {
+            SDL_SetRenderDrawColor(rend, 200, 40, 40, 255);
+            size = 12;
+        } else {
+            SDL_SetRenderDrawColor(rend, 0, 0, 0, 255);
+            size = 4;
+        }
+        SDL_Rect rect = {x - pred->x + VIEW_SIZE / 2 - size / 2,
+                         y - pred->y + VIEW_SIZE / 2 - size / 2, size, size};
+        SDL_RenderFillRect(rend, &rect);
+    }
+}
+
 SDL_Renderer* render_window(SDL_Window* win){
     Uint32 render_flags = SDL_RENDERER_ACCELERATED;
     SDL_Renderer* rend = SDL_CreateRenderer(win, -1, render_flags);
@@ -22,31 +325,73 @@ SDL_Renderer* render_window(SDL_Window* win){
 int main(int argc, char** argv){
     void * fd;
     if (argc >= 2){
-        fd = create_client_channel(argv[1]); // ./universe_client 172.29.160.1
+        // ./universe_client 172.29.160.1  or  ./universe_client ipc:///tmp/universe-server.ipc
+        fd = create_client_channel(argv[1]);
     }else{
         fd = create_client_channel("127.0.0.1");  // localhost para conexão local
     }
+    int timeout = REPLY_TIMEOUT_MS;
+    zmq_setsockopt(fd, ZMQ_RCVTIMEO, &timeout, sizeof(timeout));
 
-    char ch;
+    // World updates: same host on port 5556, or the endpoint given after
+    // the server address (needed when that is a full endpoint)
+    char *update_addr = "127.0.0.1";
+    if (argc >= 3) {
+        update_addr = argv[2];
+    } else if (argc >= 2 && strstr(argv[1], "://") == NULL) {
+        update_addr = argv[1];
+    }
+
+    // A letter is ship 1..26, past those ships are asked for by number
+    ship_id ship = SHIP_ID_NONE;
+    char answer[16];
     do{
-        printf("what is your character(A..Z)?: ");
-        ch = getchar();
-        ch = toupper(ch);  
-    }while(!isalpha(ch));
+        printf("what is your character(A..Z) or ship number?: ");
+        if (scanf("%15s", answer) != 1) {
+            exit(-1);
+        }
+        if (isdigit((unsigned char)answer[0])) {
+            unsigned long number = strtoul(answer, NULL, 10);
+            ship = number < SHIP_ID_FIRST_BOT ? (ship_id)number : SHIP_ID_NONE;
+        } else {
+            ship = ship_id_from_letter((char)toupper((unsigned char)answer[0]));
+        }
+    }while(ship == SHIP_ID_NONE);
+    char label[SHIP_LABEL_LEN];
+    ship_id_label(ship, label, sizeof(label));
+
+    // Subscribe before connecting so the first, full update is not missed
+    server_link link = {0};
+    link.requests = fd;
+    link.updates = create_update_subscriber(update_addr, ship);
+    link.ship = ship;
+    local_view view = {0};
+    world_update update = {0};
 
-    send_connection_message(fd, ch);
+    latency_reset(&link.rtt.window);
+    latency_reset(&link.rtt.total);
+    link.rtt.stale = 0;
+    request_echo echo;
+
+    send_connection_message(fd, ship, 0);
     char message[100];
-    receive_response(fd, message);
+    prediction pred = {0};
+    receive_connect_response(fd, message, &pred.session, &echo);
+    link.token = pred.session.token;
     if (strcmp(message, "OK") == 0) {
-        printf("Connected to the Universe with ship %c!\n", ch);
+        record_rtt(&link.rtt, &echo, 0);
+        printf("Connected to the Universe with ship %s!\n", label);
         printf("\n");
         printf("╔════════════════════════════════════════════╗\n");
         printf("║  CLICK ON THE CLIENT WINDOW TO ACTIVATE!  ║\n");
-        printf("║  Then use ARROW KEYS to move your ship    ║\n");
+        printf("║  Then hold ARROW KEYS to move your ship   ║\n");
         printf("╚════════════════════════════════════════════╝\n");
         printf("\n");
     }else if((strcmp(message, "NOT OK") == 0)){
-        printf("Ship %c already connected!\n", ch);
+        printf("Ship %s already connected!\n", label);
+        exit(-1);
+    }else{
+        printf("No answer from the server\n");
         exit(-1);
     }
 
@@ -58,7 +403,7 @@ int main(int argc, char** argv){
     SDL_Window* win = SDL_CreateWindow("Client - Click to Control",
                                        520,  // Left of server (820 - 300 = 520)
                                        250,  // Centered vertically with server
-                                       300, 300, 0);  // 300x300 pixels
+                                       VIEW_SIZE, VIEW_SIZE, 0);  // 300x300 pixels
 
     // Raise window to bring it to the front
     SDL_RaiseWindow(win);
@@ -67,6 +412,17 @@ int main(int argc, char** argv){
     
     direction_t last_direction = -1;  // Nenhuma seta pressionada inicialmente
     int has_direction = 0;
+
+    link.last_sent = SDL_GetTicks();
+    Uint32 start = SDL_GetTicks();
+    Uint32 last_rtt_log = start;
+
+    // Frames are due every FRAME_NS from the start, not FRAME_NS after the
+    // previous one was drawn, so the time spent drawing does not add up
+    uint64_t first_frame = latency_now_ns();
+    uint64_t next_frame = first_frame;
+    uint32_t frames = 0;
+    uint32_t late_frames = 0;
     
     int close = 0;
 
@@ -79,61 +435,70 @@ int main(int argc, char** argv){
                     break;
                     
                 case SDL_KEYDOWN:
+                case SDL_KEYUP:
                     {
+                        if (event.key.repeat) {
+                            break;  // auto-repeat, the key is already held
+                        }
+
                         direction_t direction;
-                        int valid_key = 1;
+                        uint32_t key = 0;
                         
                         switch (event.key.keysym.sym) {
                             case SDLK_LEFT:
                                 direction = LEFT;
-                                printf("LEFT\n");
+                                key = INPUT_LEFT;
                                 break;
                             case SDLK_RIGHT:
                                 direction = RIGHT;
-                                printf("RIGHT\n");
+                                key = INPUT_RIGHT;
                                 break;
                             case SDLK_UP:
                                 direction = UP;
-                                printf("UP\n");
+                                key = INPUT_UP;
                                 break;
                             case SDLK_DOWN:
                                 direction = DOWN;
-                                printf("DOWN\n");
+                                key = INPUT_DOWN;
                                 break;
                             case SDLK_ESCAPE:                                                       
                                 close = 1;
-                                valid_key = 0;
                                 break;
                             default:
-                                valid_key = 0;
                                 break;
                         }
                         
-                        if (valid_key && !close) {
-                            // Always update the arrow direction, even if movement is blocked
+                        if (key != 0 && event.type == SDL_KEYDOWN) {
+                            link.keys |= key;
                             last_direction = direction;
                             has_direction = 1;
-                            
-                            send_movement_message(fd, ch, direction);
-                            receive_response(fd, message);
-                            
-                            if (strcmp(message, "BAD MOVEMENT") == 0) {
-                                printf("You hit a something!\n");
-                            }
+                        } else if (key != 0) {
+                            link.keys &= ~key;
                         }
                     }
                     break;
             }
         }
 
+        // New keys go out before the ship is moved with them
+        if (!close && poll_server(&link, &pred, &view, &update, 0) != 0) {
+            close = 1;
+        }
+
+        // Move our ship right away with the keys held, sent or not yet
+        uint32_t target_tick = (uint32_t)((uint64_t)(SDL_GetTicks() - start) * pred.session.tick_rate / 1000);
+        while (pred.tick != target_tick) {
+            predict_tick(&pred, link.keys);
+        }
+
         // Render - clear to white background
         SDL_SetRenderDrawColor(rend, 255, 255, 255, 255);
         SDL_RenderClear(rend);
 
-        // Draw large black arrow occupying entire window
+        // Draw large light arrow occupying entire window, behind the view
         if (has_direction) {
-            // Set black color for all drawing operations
-            SDL_SetRenderDrawColor(rend, 0, 0, 0, 255);
+            // Set light grey color for all drawing operations
+            SDL_SetRenderDrawColor(rend, 225, 225, 225, 255);
             
             // Draw a simple, large filled arrow using rectangles and triangles
             switch (last_direction) {
@@ -199,11 +564,55 @@ int main(int argc, char** argv){
             }
         }
 
+        render_view(rend, &view, &pred, ship);
+
         SDL_RenderPresent(rend);
-        
-        SDL_Delay(16);  // ~60 FPS
+
+        if (SDL_GetTicks() - last_rtt_log >= RTT_LOG_MS) {
+            log_rtt(&link.rtt);
+            last_rtt_log = SDL_GetTicks();
+        }
+
+        // Until the next frame is due, wait on the sockets rather than
+        // sleeping, so replies and updates are handled as they arrive
+        frames++;
+        next_frame += FRAME_NS;
+        uint64_t now = latency_now_ns();
+        if (now > next_frame) {
+            // This frame took too long, start counting again from now
+            late_frames++;
+            next_frame = now;
+        }
+        while (!close && now < next_frame) {
+            int timeout_ms = (int)((next_frame - now + 999999) / 1000000);
+            if (poll_server(&link, &pred, &view, &update, timeout_ms) != 0) {
+                close = 1;
+            }
+            now = latency_now_ns();
+        }
     }
     
+    // Free the ship (and drop its trash) right away instead of waiting
+    // for the server's idle timeout
+    if (link.awaiting_reply) {
+        receive_response(fd, message, &echo);
+        record_rtt(&link.rtt, &echo, link.sent_seq);
+    }
+    send_disconnect_message(fd, ship, link.token);
+    receive_response(fd, message, NULL);
+
+    // Round trips of the whole session
+    latency_summary summary;
+    latency_summarize(&link.rtt.total, "CLIENT", "rtt", &summary);
+    printf("\nRound trips seen by this client (%u stale replies):\n", link.rtt.stale);
+    latency_print_summaries(&summary, 1);
+    double seconds = (latency_now_ns() - first_frame) / 1e9;
+    printf("%u frames at %.1f FPS, %u late\n", frames, seconds > 0 ? frames / seconds : 0.0, late_frames);
+
+    zmq_close(link.updates);
+    free(view.entities);
+    world_update_free(&update);
+
     SDL_DestroyRenderer(rend);
     SDL_DestroyWindow(win);
     SDL_Quit();
@@ -0,0 +1,296 @@
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "config.h"
+#include "id-map.h"
+#include "shard-map.h"
+#include "zmq-comm.h"
+
+// Front-end of a sharded universe: clients connect here exactly as to a
+// single universe_server. Requests go to the shard running the strip their
+// ship is in, as the shards report on the notice endpoint, and the world
+// updates of every shard are published again on the config endpoints.
+
+#define MAX_ENVELOPE_FRAMES 4   // routing frames before the request
+#define POLL_TIMEOUT_MS 1000
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void handle_stop_signal(int signum) {
+    (void)signum;
+    stop_requested = 1;
+}
+
+typedef struct {
+    universe_config config;
+    void *router;                 // clients (REQ)
+    void *dealers[MAX_SHARDS];    // one per shard (REP)
+    void *xpub;                   // client subscriptions
+    void *xsub;                   // updates of every shard
+    void *notices;
+
+    id_map owner;                 // ship id -> shard its requests go to
+    id_map present;               // ship id -> shard a player's ship is in
+    int players;
+    int next_shard;               // round robin for new ships and stats
+
+    unsigned long long routed;
+    unsigned long long refused;
+    unsigned long long notices_read;
+} frontend;
+
+// Client request waiting to be routed, with the envelope to answer it
+typedef struct {
+    zmq_msg_t frames[MAX_ENVELOPE_FRAMES + 1];
+    int num_frames;               // envelope frames, the request is the last one
+} routed_request;
+
+// Read one client request from the router, envelope included
+// Returns 0 on success, -1 if it is malformed (it is then dropped)
+static int read_routed(void *router, routed_request *request) {
+    request->num_frames = 0;
+    int more = 1;
+    while (more) {
+        zmq_msg_t *frame = &request->frames[request->num_frames];
+        zmq_msg_init(frame);
+        if (zmq_msg_recv(frame, router, 0) < 0) {
+            zmq_msg_close(frame);
+            break;
+        }
+        more = zmq_msg_more(frame);
+        if (request->num_frames == MAX_ENVELOPE_FRAMES && more) {
+            zmq_msg_close(frame);   // too many frames, drain the rest
+            continue;
+        }
+        request->num_frames++;
+    }
+    if (more || request->num_frames < 3) {
+        for (int i = 0; i < request->num_frames; i++) {
+            zmq_msg_close(&request->frames[i]);
+        }
+        return -1;
+    }
+    request->num_frames--;
+    return 0;
+}
+
+// Send the request, envelope first, and close its frames
+static void send_routed(void *to, routed_request *request) {
+    for (int i = 0; i <= request->num_frames; i++) {
+        zmq_msg_send(&request->frames[i], to, i < request->num_frames ? ZMQ_SNDMORE : 0);
+        zmq_msg_close(&request->frames[i]);
+    }
+}
+
+// Answer a request here instead of a shard, with a failure
+static void refuse(frontend *front, routed_request *routed, const client_request *request) {
+    for (int i = 0; i < routed->num_frames; i++) {
+        zmq_msg_send(&routed->frames[i], front->router, ZMQ_SNDMORE);
+        zmq_msg_close(&routed->frames[i]);
+    }
+    zmq_msg_close(&routed->frames[routed->num_frames]);
+
+    if (request->type == MSG_CONNECT) {
+        send_connect_response(front->router, request, 0, NULL);
+    } else {
+        send_response(front->router, request, 0);
+    }
+    front->refused++;
+}
+
+static void route_request(frontend *front) {
+    routed_request routed;
+    if (read_routed(front->router, &routed) != 0) {
+        return;
+    }
+
+    zmq_msg_t *payload = &routed.frames[routed.num_frames];
+    client_request request;
+    decode_message(zmq_msg_data(payload), zmq_msg_size(payload), &request);
+    ship_id id = request.ship;
+
+    int shard = -1;
+    if (request.type == MSG_STATS) {
+        shard = front->next_shard;
+        front->next_shard = (front->next_shard + 1) % front->config.shards;
+    } else if (request.type == MSG_UNKNOWN || id == SHIP_ID_NONE) {
+        shard = -1;
+    } else if (request.type == MSG_CONNECT) {
+        if (id_map_get(&front->present, id) != -1) {
+            shard = id_map_get(&front->owner, id);   // it answers that the ship is already there
+        } else if (front->players + front->config.bots < front->config.max_ships) {
+            // New ships start in some strip, the shard places them
+            shard = front->next_shard;
+            if (id_map_put(&front->owner, id, shard) == 0) {
+                front->next_shard = (front->next_shard + 1) % front->config.shards;
+            } else {
+                shard = -1;
+            }
+        }
+    } else {
+        shard = id_map_get(&front->owner, id);
+    }
+
+    if (shard == -1) {
+        refuse(front, &routed, &request);
+    } else {
+        send_routed(front->dealers[shard], &routed);
+        front->routed++;
+    }
+}
+
+static void read_notices(frontend *front) {
+    ship_id id;
+    int shard;
+    while (receive_shard_notice(front->notices, &id, &shard) > 0) {
+        front->notices_read++;
+        bool present = id_map_get(&front->present, id) != -1;
+        if (shard >= 0 && shard < front->config.shards) {
+            if (id_map_put(&front->present, id, shard) != 0 ||
+                id_map_put(&front->owner, id, shard) != 0) {
+                continue;  // out of memory, its requests are refused
+            }
+            front->players += present ? 0 : 1;
+        } else {
+            front->players -= present ? 1 : 0;
+            id_map_remove(&front->present, id);
+            id_map_remove(&front->owner, id);
+        }
+    }
+}
+
+static int open_sockets(frontend *front) {
+    void *context = get_comm_context();
+    char endpoint[ENDPOINT_LEN];
+
+    front->router = zmq_socket(context, ZMQ_ROUTER);
+    front->xpub = zmq_socket(context, ZMQ_XPUB);
+    front->xsub = zmq_socket(context, ZMQ_XSUB);
+    front->notices = create_shard_inbox(SHARD_NOTICE_ENDPOINT);
+    if (!front->notices) {
+        return -1;
+    }
+
+    for (int i = 0; i < front->config.num_server_endpoints; i++) {
+        if (zmq_bind(front->router, front->config.server_endpoints[i]) != 0) {
+            fprintf(stderr, "Failed to bind %s: %s\n", front->config.server_endpoints[i], zmq_strerror(zmq_errno()));
+            return -1;
+        }
+        printf("Front-end listening on %s\n", front->config.server_endpoints[i]);
+    }
+    for (int i = 0; i < front->config.num_update_endpoints; i++) {
+        if (zmq_bind(front->xpub, front->config.update_endpoints[i]) != 0) {
+            fprintf(stderr, "Failed to bind %s: %s\n", front->config.update_endpoints[i], zmq_strerror(zmq_errno()));
+            return -1;
+        }
+        printf("Publishing world updates on %s\n", front->config.update_endpoints[i]);
+    }
+
+    for (int i = 0; i < front->config.shards; i++) {
+        front->dealers[i] = zmq_socket(context, ZMQ_DEALER);
+        shard_endpoint(endpoint, sizeof(endpoint), SHARD_REQUEST_ENDPOINT, i);
+        if (zmq_connect(front->dealers[i], endpoint) != 0) {
+            fprintf(stderr, "Failed to connect %s: %s\n", endpoint, zmq_strerror(zmq_errno()));
+            return -1;
+        }
+        shard_endpoint(endpoint, sizeof(endpoint), SHARD_UPDATE_ENDPOINT, i);
+        if (zmq_connect(front->xsub, endpoint) != 0) {
+            fprintf(stderr, "Failed to connect %s: %s\n", endpoint, zmq_strerror(zmq_errno()));
+            return -1;
+        }
+    }
+    printf("Routing to %d shards on %s\n", front->config.shards, SHARD_REQUEST_ENDPOINT);
+    return 0;
+}
+
+static void close_sockets(frontend *front) {
+    int linger = 0;
+    void *sockets[] = {front->router, front->xpub, front->xsub, front->notices};
+    for (int i = 0; i < 4; i++) {
+        if (sockets[i]) {
+            zmq_setsockopt(sockets[i], ZMQ_LINGER, &linger, sizeof(linger));
+            zmq_close(sockets[i]);
+        }
+    }
+    for (int i = 0; i < MAX_SHARDS; i++) {
+        if (front->dealers[i]) {
+            zmq_setsockopt(front->dealers[i], ZMQ_LINGER, &linger, sizeof(linger));
+            zmq_close(front->dealers[i]);
+        }
+    }
+}
+
+static void run(frontend *front) {
+    int shards = front->config.shards;
+    zmq_pollitem_t items[4 + MAX_SHARDS];
+    items[0] = (zmq_pollitem_t){front->router, 0, ZMQ_POLLIN, 0};
+    items[1] = (zmq_pollitem_t){front->notices, 0, ZMQ_POLLIN, 0};
+    items[2] = (zmq_pollitem_t){front->xsub, 0, ZMQ_POLLIN, 0};
+    items[3] = (zmq_pollitem_t){front->xpub, 0, ZMQ_POLLIN, 0};
+    for (int i = 0; i < shards; i++) {
+        items[4 + i] = (zmq_pollitem_t){front->dealers[i], 0, ZMQ_POLLIN, 0};
+    }
+
+    while (!stop_requested) {
+        if (zmq_poll(items, 4 + shards, POLL_TIMEOUT_MS) < 0) {
+            continue;   // interrupted by a signal
+        }
+        // Notices first, so requests go where the ship is now
+        if (items[1].revents & ZMQ_POLLIN) read_notices(front);
+        if (items[0].revents & ZMQ_POLLIN) route_request(front);
+        if (items[2].revents & ZMQ_POLLIN) forward_message(front->xsub, front->xpub);
+        if (items[3].revents & ZMQ_POLLIN) forward_message(front->xpub, front->xsub);
+        for (int i = 0; i < shards; i++) {
+            if (items[4 + i].revents & ZMQ_POLLIN) forward_message(front->dealers[i], front->router);
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    const char *config_file = argc > 1 ? argv[1] : "universe.conf";
+
+    // Usage: universe_frontend [config_file]
+    printf("=== Space Trash - Universe Front-end ===\n");
+    printf("Loading configuration from: %s\n\n", config_file);
+
+    frontend *front = (frontend*)calloc(1, sizeof(frontend));
+    if (!front) {
+        fprintf(stderr, "Failed to allocate front-end\n");
+        return 1;
+    }
+    if (load_config(config_file, &front->config) != 0) {
+        fprintf(stderr, "Failed to load configuration\n");
+        free(front);
+        return 1;
+    }
+    print_config(&front->config);
+    if (id_map_init(&front->owner, front->config.max_ships) != 0 ||
+        id_map_init(&front->present, front->config.max_ships) != 0) {
+        id_map_destroy(&front->owner);
+        free(front);
+        return 1;
+    }
+
+    signal(SIGINT, handle_stop_signal);
+    signal(SIGTERM, handle_stop_signal);
+
+    if (open_sockets(front) != 0) {
+        close_sockets(front);
+        id_map_destroy(&front->owner);
+        id_map_destroy(&front->present);
+        free(front);
+        return 1;
+    }
+    run(front);
+    close_sockets(front);
+
+    printf("\n%llu requests routed, %llu refused, %llu ship notices, %d players left\n",
+           front->routed, front->refused, front->notices_read, front->players);
+    printf("Universe front-end terminated cleanly.\n");
+    id_map_destroy(&front->owner);
+    id_map_destroy(&front->present);
+    free(front);
+    return 0;
+}
@@ -0,0 +1,365 @@
+#include <ctype.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "zmq-comm.h"
+
+// Headless bot swarm: every session is a ship on its own thread and socket,
+// driving a movement pattern at a target rate and timing each round trip.
+
+#define MAX_SESSIONS 1024       // a thread each
+#define RESPONSE_TIMEOUT_MS 1000
+
+typedef enum {
+    PATTERN_RANDOM,   // random direction on every move
+    PATTERN_SQUARE,   // 20 moves per side, clockwise
+    PATTERN_ZIGZAG,   // alternate right/down
+    PATTERN_HOLD      // always the same direction (key held down)
+} move_pattern;
+
+typedef struct {
+    char *server_addr;
+    int num_sessions;
+    double rate;          // target moves per second per session, 0 = unpaced
+    int duration;         // seconds
+    move_pattern pattern;
+    ship_id first_ship;   // the sessions fly this ship and the ones after it
+    bool stats_only;      // just print the server's latency histograms
+} loadgen_options;
+
+typedef struct {
+    const loadgen_options *options;
+    ship_id ship;
+    char label[SHIP_LABEL_LEN];
+    pthread_t thread;
+
+    bool connected;
+    long moves_sent;
+    long moves_ok;
+    long bad_moves;       // server answered with a failure
+    long timeouts;        // no answer within RESPONSE_TIMEOUT_MS
+    double elapsed;       // seconds spent in the move loop
+
+    uint32_t *rtt_us;     // one sample per answered move
+    long num_rtt;
+    long max_rtt;
+    long lost_rtt;        // answered moves not sampled, rtt_us could not grow
+} session;
+
+static double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void sleep_until(double deadline) {
+    double remaining = deadline - now_seconds();
+    if (remaining <= 0) return;
+
+    struct timespec ts;
+    ts.tv_sec = (time_t)remaining;
+    ts.tv_nsec = (long)((remaining - ts.tv_sec) * 1e9);
+    nanosleep(&ts, NULL);
+}
+
+static direction_t next_direction(move_pattern pattern, long step, unsigned int *seed) {
+    static const direction_t clockwise[] = {RIGHT, DOWN, LEFT, UP};
+
+    switch (pattern) {
+    case PATTERN_SQUARE:
+        return clockwise[(step / 20) % 4];
+    case PATTERN_ZIGZAG:
+        return (step % 2 == 0) ? RIGHT : DOWN;
+    case PATTERN_HOLD:
+        return RIGHT;
+    case PATTERN_RANDOM:
+    default:
+        return clockwise[rand_r(seed) % 4];
+    }
+}
+
+// Once the samples cannot grow, the session keeps the ones it has and counts
+// the rest as errors
+static void record_rtt(session *s, double rtt_seconds) {
+    if (s->lost_rtt > 0) {
+        s->lost_rtt++;
+        return;
+    }
+    if (s->num_rtt == s->max_rtt) {
+        long max_rtt = s->max_rtt ? s->max_rtt * 2 : 1024;
+        uint32_t *grown = (uint32_t*)realloc(s->rtt_us, sizeof(uint32_t) * max_rtt);
+        if (!grown) {
+            fprintf(stderr, "Session %s: no memory for more samples, not recording any more\n", s->label);
+            s->lost_rtt++;
+            return;
+        }
+        s->rtt_us = grown;
+        s->max_rtt = max_rtt;
+    }
+    s->rtt_us[s->num_rtt++] = (uint32_t)(rtt_seconds * 1e6);
+}
+
+static void *session_run(void *arg) {
+    session *s = (session*)arg;
+    const loadgen_options *options = s->options;
+    char message[100];
+    unsigned int seed = (unsigned int)time(NULL) ^ (unsigned int)s->ship;
+
+    void *fd = create_client_channel(options->server_addr);
+
+    // A lost reply must not wedge the REQ socket: allow a new request after
+    // a timeout and drop late replies that belong to an older one
+    int timeout = RESPONSE_TIMEOUT_MS;
+    int enable = 1;
+    zmq_setsockopt(fd, ZMQ_RCVTIMEO, &timeout, sizeof(timeout));
+    zmq_setsockopt(fd, ZMQ_REQ_RELAXED, &enable, sizeof(enable));
+    zmq_setsockopt(fd, ZMQ_REQ_CORRELATE, &enable, sizeof(enable));
+
+    session_info info;
+    send_connection_message(fd, s->ship, 0);
+    receive_connect_response(fd, message, &info, NULL);
+    uint32_t token = info.token;
+    if (strcmp(message, "OK") != 0) {
+        fprintf(stderr, "Session %s: connect failed (%s)\n", s->label, message);
+        zmq_close(fd);
+        return NULL;
+    }
+    s->connected = true;
+
+    double period = options->rate > 0 ? 1.0 / options->rate : 0;
+    double start = now_seconds();
+    double end = start + options->duration;
+
+    for (long step = 0; now_seconds() < end; step++) {
+        if (period > 0) {
+            sleep_until(start + step * period);
+        }
+
+        direction_t direction = next_direction(options->pattern, step, &seed);
+        double sent_at = now_seconds();
+        send_movement_message(fd, s->ship, token, direction, (uint32_t)step);
+        receive_response(fd, message, NULL);
+        double rtt = now_seconds() - sent_at;
+        s->moves_sent++;
+
+        if (strcmp(message, "OK") == 0) {
+            s->moves_ok++;
+            record_rtt(s, rtt);
+        } else if (strcmp(message, "ERROR") == 0) {
+            s->timeouts++;
+        } else {
+            s->bad_moves++;
+            record_rtt(s, rtt);
+        }
+    }
+    s->elapsed = now_seconds() - start;
+
+    send_disconnect_message(fd, s->ship, token);
+    receive_response(fd, message, NULL);
+    zmq_close(fd);
+    return NULL;
+}
+
+static int compare_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of a sorted sample array
+static uint32_t percentile(const uint32_t *sorted, long n, double p) {
+    if (n == 0) return 0;
+    long rank = (long)(p / 100.0 * n + 0.5);
+    if (rank < 1) rank = 1;
+    if (rank > n) rank = n;
+    return sorted[rank - 1];
+}
+
+static void print_report(session *sessions, int num_sessions) {
+    long total_sent = 0, total_errors = 0, total_rtt = 0;
+    double total_rate = 0;
+
+    printf("\n%-7s %9s %10s %8s %8s %9s %9s %9s %9s\n",
+           "ship", "moves", "moves/s", "bad", "timeout", "p50(us)", "p90(us)", "p99(us)", "max(us)");
+
+    for (int i = 0; i < num_sessions; i++) {
+        session *s = &sessions[i];
+        if (!s->connected) {
+            printf("%-7s %9s\n", s->label, "no connection");
+            total_errors++;
+            continue;
+        }
+
+        qsort(s->rtt_us, s->num_rtt, sizeof(uint32_t), compare_u32);
+        double rate = s->elapsed > 0 ? s->moves_ok / s->elapsed : 0;
+
+        printf("%-7s %9ld %10.1f %8ld %8ld %9u %9u %9u %9u\n",
+               s->label, s->moves_sent, rate, s->bad_moves, s->timeouts,
+               percentile(s->rtt_us, s->num_rtt, 50),
+               percentile(s->rtt_us, s->num_rtt, 90),
+               percentile(s->rtt_us, s->num_rtt, 99),
+               s->num_rtt ? s->rtt_us[s->num_rtt - 1] : 0);
+
+        total_sent += s->moves_sent;
+        total_errors += s->bad_moves + s->timeouts + s->lost_rtt;
+        total_rtt += s->num_rtt;
+        total_rate += rate;
+    }
+
+    // Aggregate percentiles over every sample of every session
+    uint32_t *all = (uint32_t*)malloc(sizeof(uint32_t) * (total_rtt > 0 ? total_rtt : 1));
+    long n = 0;
+    if (!all) {
+        fprintf(stderr, "No memory for the aggregate percentiles\n");
+    }
+    for (int i = 0; all && i < num_sessions; i++) {
+        memcpy(all + n, sessions[i].rtt_us, sizeof(uint32_t) * sessions[i].num_rtt);
+        n += sessions[i].num_rtt;
+    }
+    qsort(all, n, sizeof(uint32_t), compare_u32);
+
+    printf("%-7s %9ld %10.1f %8s %8s %9u %9u %9u %9u\n",
+           "total", total_sent, total_rate, "", "",
+           percentile(all, n, 50), percentile(all, n, 90), percentile(all, n, 99),
+           n ? all[n - 1] : 0);
+    printf("Error rate: %.2f%% (%ld of %ld requests)\n",
+           total_sent ? 100.0 * total_errors / total_sent : 0.0, total_errors, total_sent);
+    free(all);
+}
+
+// Print the latency histograms kept by the server
+static int query_server_stats(char *server_addr) {
+    latency_summary summaries[64];
+    void *fd = create_client_channel(server_addr);
+
+    int timeout = RESPONSE_TIMEOUT_MS;
+    zmq_setsockopt(fd, ZMQ_RCVTIMEO, &timeout, sizeof(timeout));
+
+    send_stats_request(fd);
+    int count = receive_stats(fd, summaries, 64);
+    zmq_close(fd);
+
+    if (count < 0) {
+        fprintf(stderr, "No stats response from %s\n", server_addr);
+        return -1;
+    }
+    printf("Server latency on %s\n", server_addr);
+    latency_print_summaries(summaries, count);
+    return 0;
+}
+
+static void usage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s [-n sessions] [-r moves_per_second] [-d seconds]\n"
+            "          [-p random|square|zigzag|hold] [-l first_ship] [server_address]\n"
+            "       %s -s [server_address]   (print the server's latency histograms)\n"
+            "  server_address is a host name/IP (port 5555) or a full zmq endpoint\n"
+            "  -r 0 sends as fast as the server answers\n"
+            "  first_ship is a letter (A is ship 1) or a ship number\n",
+            program, program);
+}
+
+int main(int argc, char *argv[]) {
+    loadgen_options options = {
+        .server_addr = "127.0.0.1",
+        .num_sessions = 4,
+        .rate = 50,
+        .duration = 10,
+        .pattern = PATTERN_RANDOM,
+        .first_ship = 1,
+        .stats_only = false
+    };
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:r:d:p:l:sh")) != -1) {
+        switch (opt) {
+        case 'n':
+            options.num_sessions = atoi(optarg);
+            break;
+        case 'r':
+            options.rate = atof(optarg);
+            break;
+        case 'd':
+            options.duration = atoi(optarg);
+            break;
+        case 'p':
+            if (strcmp(optarg, "random") == 0) options.pattern = PATTERN_RANDOM;
+            else if (strcmp(optarg, "square") == 0) options.pattern = PATTERN_SQUARE;
+            else if (strcmp(optarg, "zigzag") == 0) options.pattern = PATTERN_ZIGZAG;
+            else if (strcmp(optarg, "hold") == 0) options.pattern = PATTERN_HOLD;
+            else {
+                usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'l':
+            options.first_ship = isdigit((unsigned char)optarg[0])
+                ? (ship_id)strtoul(optarg, NULL, 10)
+                : ship_id_from_letter((char)toupper((unsigned char)optarg[0]));
+            break;
+        case 's':
+            options.stats_only = true;
+            break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (optind < argc) {
+        options.server_addr = argv[optind];
+    }
+
+    if (options.stats_only) {
+        int result = query_server_stats(options.server_addr);
+        zmq_ctx_term(get_comm_context());
+        return result == 0 ? 0 : 1;
+    }
+
+    // Every session needs a player id, below the bots' ones
+    bool ids_fit = options.first_ship != SHIP_ID_NONE &&
+                   options.first_ship < SHIP_ID_FIRST_BOT - (ship_id)options.num_sessions;
+    if (!ids_fit || options.num_sessions < 1 || options.num_sessions > MAX_SESSIONS ||
+        options.rate < 0 || options.duration < 1) {
+        fprintf(stderr, "Invalid options: sessions must be 1..%d from a player ship, rate >= 0, duration >= 1\n",
+                MAX_SESSIONS);
+        return 1;
+    }
+
+    printf("Load generator: %d sessions, %.1f moves/s each, %d s against %s\n",
+           options.num_sessions, options.rate, options.duration, options.server_addr);
+
+    session *sessions = (session*)calloc(options.num_sessions, sizeof(session));
+    if (!sessions) {
+        fprintf(stderr, "Failed to allocate %d sessions\n", options.num_sessions);
+        return 1;
+    }
+
+    int started = 0;
+    for (int i = 0; i < options.num_sessions; i++) {
+        sessions[i].options = &options;
+        sessions[i].ship = options.first_ship + (ship_id)i;
+        ship_id_label(sessions[i].ship, sessions[i].label, sizeof(sessions[i].label));
+        if (pthread_create(&sessions[i].thread, NULL, session_run, &sessions[i]) != 0) {
+            fprintf(stderr, "Failed to start session %s, running %d sessions\n", sessions[i].label, i);
+            break;
+        }
+        started++;
+    }
+    options.num_sessions = started;
+    for (int i = 0; i < options.num_sessions; i++) {
+        pthread_join(sessions[i].thread, NULL);
+    }
+
+    print_report(sessions, options.num_sessions);
+
+    for (int i = 0; i < options.num_sessions; i++) {
+        free(sessions[i].rtt_us);
+    }
+    free(sessions);
+    zmq_ctx_term(get_comm_context());
+    return 0;
+}
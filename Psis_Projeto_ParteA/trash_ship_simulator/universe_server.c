@@ -1,37 +1,253 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <signal.h>
+#include <string.h>
 #include <time.h>
+#include "autopilot.h"
 #include "config.h"
 #include "display.h"
+#include "input-queue.h"
+#include "interest-region.h"
+#include "latency-stats.h"
+#include "physics-rules.h"
+#include "pipeline.h"
+#include "session-registry.h"
+#include "shard-map.h"
 #include "universe-data.h"
 #include "zmq-comm.h"
 
+// Ships move along their held keys and trash physics advance once per tick
+// (tick_rate in the config), whatever the message rate
+#define MAX_CATCHUP_TICKS 5  // further behind than this, missed ticks are dropped
+#define FRAME_MS 10          // render period (100 FPS)
+#define INPUTS_PER_TICK 64   // queued moves applied per tick, over all ships
+
+// A ship's steps of one tick must fit its path: every move drained plus the held keys
+_Static_assert(INPUTS_PER_TICK * MAX_COALESCED_STEPS + 1 <= MAX_TICK_STEPS,
+               "a tick can move a ship more steps than its path holds");
+#define MAX_REQUESTS_PER_WAKE 256  // requests served before looking at the clock again
+#define HEADLESS_STATS_SECONDS 5   // throughput log period without a window
+#define SHARD_PLACEMENT_ATTEMPTS 64  // free spots drawn to find one inside the shard's strip
+#define SHARD_HANDOFF_RETRIES 100    // ticks a handoff the next shard does not take is kept
+
+// Commands and processing stages timed by the server
+typedef enum {
+    TIMED_CONNECT,
+    TIMED_MOVE,
+    TIMED_INPUT,
+    NUM_TIMED_COMMANDS
+} timed_command;
+
+typedef enum {
+    STAGE_WAIT,       // socket not being read (render, events, frame delay)
+    STAGE_RECEIVE,    // inside zmq_recv, once the request is ready
+    STAGE_DECODE,
+    STAGE_APPLY,      // placement for CONNECT, queueing for MOVE and INPUT; their
+                      // collision checks are timed with the tick ("moves")
+    STAGE_REPLY,
+    STAGE_TOTAL,      // receive start to reply sent
+    NUM_TIMED_STAGES
+} timed_stage;
+
+static const char *timed_command_names[NUM_TIMED_COMMANDS] = {"CONNECT", "MOVE", "INPUT"};
+static const char *timed_stage_names[NUM_TIMED_STAGES] = {
+    "wait", "receive", "decode", "apply", "reply", "total"
+};
+
+// Tick measurements: time spent running a tick, how late it started and how
+// long the world updates that follow it took
+typedef enum {
+    TICK_RUN,
+    TICK_LATE,
+    TICK_PUBLISH,     // building and sending the world updates after a tick
+    TICK_QUEUED,      // time a move waited in its ship's input queue
+    TICK_MOVES,       // resolving the collisions of all ships' moves of a tick
+    NUM_TICK_STAGES
+} tick_stage;
+
+static const char *tick_stage_names[NUM_TICK_STAGES] = {"run", "late", "publish", "queued", "moves"};
+
+#define NUM_LATENCY_ROWS (NUM_TIMED_COMMANDS * NUM_TIMED_STAGES + NUM_TICK_STAGES)
+_Static_assert(NUM_LATENCY_ROWS <= PIPELINE_MAX_STATS, "stats replies do not fit the pipeline");
+
+// Stage boundaries of one command, in latency_now_ns() time
+typedef struct {
+    uint64_t wait_start;     // previous receive finished
+    uint64_t receive_start;
+    uint64_t decode_start;
+    uint64_t apply_start;
+    uint64_t reply_start;
+} command_timing;
+
+// Set from signal handlers and acted on by the main loop
+static volatile sig_atomic_t dump_latency_requested = 0;  // SIGUSR1
+static volatile sig_atomic_t stop_requested = 0;          // SIGINT, SIGTERM
+
 // Game state structure
 typedef struct {
     bool running;
     bool game_over;       // Universe has collapsed
     bool paused;
+    bool headless;        // no window: no rendering, no SDL at all
     display_context *display;
     universe_config config;
     universe_data *universe;
     int collision_count;  // Track number of collisions
+    session_registry sessions;
+    interest_view *views;     // by session slot: what each ship's client was last sent
+    interest_scratch interest;
+    input_queue *queues;      // by session slot: inputs of each ship waiting for a tick
+    input_queue_stats input_stats;
+    int input_turn;           // ship that drains first on the next tick
+    move_batch moves;         // steps of every ship during the current tick
+    autopilot pilot;          // ships flown by the server
+    uint64_t update_bytes;    // world update payload published
+    latency_histogram latency[NUM_TIMED_COMMANDS][NUM_TIMED_STAGES];
+    latency_histogram tick_latency[NUM_TICK_STAGES];
+    uint64_t ticks;           // ticks run
+    uint64_t tick_overruns;   // ticks that took longer than the tick period
+    uint64_t ticks_dropped;   // ticks skipped because the loop fell too far behind
+    uint64_t requests;        // client requests served
+    pipeline *pipeline;       // decode and encode stages, NULL when serving inline
+
+    // One strip of a sharded universe (see shard-map.h), unused otherwise
+    bool sharded;
+    shard_map shard;
+    void *inbox;                         // handoffs from the other shards
+    void *outboxes[MAX_SHARDS];          // to each other shard, NULL for this one
+    void *notices;                       // where players' ships are, to the front-end
+    shard_handoff outgoing[MAX_SHARDS];  // filled during a tick, sent at its end
+    int handoff_retries[MAX_SHARDS];     // ticks the outgoing handoff could not be sent
+    shard_handoff incoming;
+    id_map moved_to;                     // ship id -> shard it was last handed to
+    uint64_t ships_handed_off;
+    uint64_t trash_handed_off;
 } game_state;
 
+static void handle_sigusr1(int signum) {
+    (void)signum;
+    dump_latency_requested = 1;
+}
+
+static void handle_stop_signal(int signum) {
+    (void)signum;
+    stop_requested = 1;
+}
+
+void record_latency(game_state *state, timed_command command, const command_timing *timing) {
+    uint64_t reply_end = latency_now_ns();
+    latency_histogram *h = state->latency[command];
+
+    latency_record(&h[STAGE_WAIT], timing->receive_start - timing->wait_start);
+    latency_record(&h[STAGE_RECEIVE], timing->decode_start - timing->receive_start);
+    latency_record(&h[STAGE_DECODE], timing->apply_start - timing->decode_start);
+    latency_record(&h[STAGE_APPLY], timing->reply_start - timing->apply_start);
+    latency_record(&h[STAGE_REPLY], reply_end - timing->reply_start);
+    latency_record(&h[STAGE_TOTAL], reply_end - timing->receive_start);
+}
+
+// Fills one row per command and stage, returns the number of rows
+int summarize_latency(game_state *state, latency_summary *summaries) {
+    int count = 0;
+    for (int c = 0; c < NUM_TIMED_COMMANDS; c++) {
+        for (int s = 0; s < NUM_TIMED_STAGES; s++) {
+            latency_summarize(&state->latency[c][s], timed_command_names[c],
+                              timed_stage_names[s], &summaries[count++]);
+        }
+    }
+    for (int s = 0; s < NUM_TICK_STAGES; s++) {
+        latency_summarize(&state->tick_latency[s], "TICK", tick_stage_names[s], &summaries[count++]);
+    }
+    return count;
+}
+
+void print_latency(game_state *state) {
+    latency_summary summaries[NUM_LATENCY_ROWS];
+    int count = summarize_latency(state, summaries);
+
+    printf("\n=== Command latency ===\n");
+    latency_print_summaries(summaries, count);
+    printf("Ticks: %llu at %d Hz, %llu overran the tick period, %llu dropped\n",
+           (unsigned long long)state->ticks, state->config.tick_rate,
+           (unsigned long long)state->tick_overruns, (unsigned long long)state->ticks_dropped);
+    printf("World updates: %llu bytes published\n", (unsigned long long)state->update_bytes);
+    printf("Queued moves: %llu accepted, %llu coalesced, %llu dropped (queue full), %llu dropped (stale), "
+           "%llu key states replaced\n",
+           (unsigned long long)state->input_stats.moves, (unsigned long long)state->input_stats.coalesced,
+           (unsigned long long)state->input_stats.dropped_full, (unsigned long long)state->input_stats.dropped_stale,
+           (unsigned long long)state->input_stats.keys_replaced);
+    fflush(stdout);
+}
+
+// What the server keeps for the client of a ship, NULL if it has no session
+interest_view *ship_view(game_state *state, ship_id id) {
+    int slot = session_slot(&state->sessions, id);
+    return slot >= 0 ? &state->views[slot] : NULL;
+}
+
+input_queue *ship_queue(game_state *state, ship_id id) {
+    int slot = session_slot(&state->sessions, id);
+    return slot >= 0 ? &state->queues[slot] : NULL;
+}
 
-int find_ship_info(universe_data *universe, int n_char, int ch) {
+// Close the session of a ship, leaving its slot clean for the next one
+void close_session(game_state *state, ship_id id) {
+    int slot = session_slot(&state->sessions, id);
+    if (slot >= 0) {
+        interest_view_reset(&state->views[slot]);
+        input_queue_clear(&state->queues[slot]);
+        session_close(&state->sessions, id);
+    }
+}
 
-  for (int i = 0; i < n_char; i++) {
-    ship_structure *ship = universe_get_ship(universe, i);
-    if (ch == ship->name) {
-      return i;
+// Remove a ship and its session, its trash goes back into the universe
+void disconnect_ship(game_state *state, ship_id id, const char *reason) {
+    int index = universe_find_ship(state->universe, id);
+    if (index != -1) {
+        universe_remove_ship(state->universe, index);
+        autopilot_forget(&state->pilot, id);
+    }
+    close_session(state, id);
+    if (state->sharded && !autopilot_is_bot(&state->pilot, id)) {
+        send_shard_notice(state->notices, id, -1);
     }
-  }
-  return -1;
+    char label[SHIP_LABEL_LEN];
+    printf("Ship %s disconnected (%s)\n", ship_id_label(id, label, sizeof(label)), reason);
 }
 
-// Initialize game state
-game_state* game_init(const char *config_file) {
+// Disconnect every ship whose client stopped sending requests
+void evict_idle_ships(game_state *state, uint64_t now) {
+    // Backwards, removing a ship moves the last one into its slot
+    for (int i = state->universe->num_ships - 1; i >= 0; i--) {
+        ship_id id = state->universe->ships[i].id;
+        if (session_is_idle(&state->sessions, id, now)) {
+            disconnect_ship(state, id, "idle timeout");
+        }
+    }
+}
+
+void game_destroy(game_state *state);
+
+// Every shard built the same universe, each keeps what lies in its strip
+void keep_own_strip(game_state *state) {
+    universe_data *universe = state->universe;
+    for (int i = 0; i < universe->max_trash; i++) {
+        if (universe->trash[i].active && !shard_owns(&state->shard, universe->trash[i].x, 0)) {
+            universe_remove_trash(universe, i);
+        }
+    }
+    for (int i = universe->num_ships - 1; i >= 0; i--) {
+        ship_structure *ship = &universe->ships[i];
+        if (!shard_owns(&state->shard, ship->x, 0)) {
+            autopilot_forget(&state->pilot, ship->id);
+            universe_remove_ship(universe, i);
+        }
+    }
+}
+
+// Initialize game state, shard is the strip to run or -1 for the whole universe
+game_state* game_init(const char *config_file, bool headless, int shard) {
     game_state *state = (game_state*)malloc(sizeof(game_state));
     if (!state) {
         fprintf(stderr, "Failed to allocate game state\n");
@@ -40,10 +256,45 @@ game_state* game_init(const char *config_file) {
 
     state->running = true;
     state->paused = false;
+    state->headless = headless;
     state->game_over = false;
     state->display = NULL;
     state->universe = NULL;
     state->collision_count = 0;
+    for (int c = 0; c < NUM_TIMED_COMMANDS; c++) {
+        for (int s = 0; s < NUM_TIMED_STAGES; s++) {
+            latency_reset(&state->latency[c][s]);
+        }
+    }
+    for (int s = 0; s < NUM_TICK_STAGES; s++) {
+        latency_reset(&state->tick_latency[s]);
+    }
+    state->ticks = 0;
+    state->tick_overruns = 0;
+    state->ticks_dropped = 0;
+    state->requests = 0;
+    state->update_bytes = 0;
+    state->pipeline = NULL;
+    state->views = NULL;
+    state->queues = NULL;
+    memset(&state->sessions, 0, sizeof(state->sessions));
+    memset(&state->moved_to, 0, sizeof(state->moved_to));
+    memset(&state->interest, 0, sizeof(state->interest));
+    memset(&state->input_stats, 0, sizeof(state->input_stats));
+    memset(&state->moves, 0, sizeof(state->moves));
+    autopilot_init(&state->pilot);
+    state->input_turn = 0;
+    state->sharded = shard >= 0;
+    state->inbox = NULL;
+    state->notices = NULL;
+    for (int i = 0; i < MAX_SHARDS; i++) {
+        state->outboxes[i] = NULL;
+    }
+    memset(state->outgoing, 0, sizeof(state->outgoing));
+    memset(state->handoff_retries, 0, sizeof(state->handoff_retries));
+    memset(&state->incoming, 0, sizeof(state->incoming));
+    state->ships_handed_off = 0;
+    state->trash_handed_off = 0;
 
     // Load configuration
     if (load_config(config_file, &state->config) != 0) {
@@ -54,6 +305,22 @@ game_state* game_init(const char *config_file) {
 
     print_config(&state->config);
 
+    if (state->sharded) {
+        if (shard >= state->config.shards) {
+            fprintf(stderr, "Shard %d does not exist, the universe has %d shards\n", shard, state->config.shards);
+            free(state);
+            return NULL;
+        }
+        shard_map_init(&state->shard, shard, state->config.shards, state->config.universe_width);
+        printf("Shard %d of %d: strip %d <= x < %d\n", shard, state->config.shards,
+               shard_left(&state->shard, shard), shard_left(&state->shard, shard + 1));
+    } else {
+        shard_map_init(&state->shard, 0, 1, state->config.universe_width);
+    }
+    if (state->config.seed != 0) {
+        srand(state->config.seed);
+    }
+
     // Create universe
     state->universe = universe_create(&state->config);
     if (!state->universe) {
@@ -61,17 +328,53 @@ game_state* game_init(const char *config_file) {
         free(state);
         return NULL;
     }
+    // Players' ships are never more than max_ships, so neither are sessions
+    int max_ships = state->universe->max_ships;
+    state->views = (interest_view*)malloc(sizeof(interest_view) * max_ships);
+    state->queues = (input_queue*)malloc(sizeof(input_queue) * max_ships);
+    if (!state->views || !state->queues) {
+        fprintf(stderr, "Failed to allocate client state of %d ships\n", max_ships);
+        free(state->views);
+        free(state->queues);
+        state->views = NULL;
+        state->queues = NULL;
+        game_destroy(state);
+        return NULL;
+    }
+    for (int i = 0; i < max_ships; i++) {
+        interest_view_init(&state->views[i]);
+        input_queue_clear(&state->queues[i]);
+    }
+    if (session_registry_init(&state->sessions, max_ships, state->config.ship_idle_timeout) != 0 ||
+        id_map_init(&state->moved_to, state->sharded ? max_ships : 0) != 0 ||
+        interest_scratch_init(&state->interest, state->universe) != 0 ||
+        move_batch_init(&state->moves, state->universe->max_ships) != 0 ||
+        move_batch_start_workers(&state->moves, state->config.move_threads) != 0) {
+        game_destroy(state);
+        return NULL;
+    }
 
 
     // Initialize display
-    state->display = display_init("Space Trash - Universe Simulator", 
-                                  state->config.universe_width, 
-                                  state->config.universe_height);
+    if (!headless) {
+        state->display = display_init("Space Trash - Universe Simulator", 
+                                      state->config.universe_width, 
+                                      state->config.universe_height);
+        if (!state->display) {
+            fprintf(stderr, "Failed to initialize display\n");
+            game_destroy(state);
+            return NULL;
+        }
+    }
 
     //create planets at random locations
     float x, y;
     for (int i=0 ; i < state->config.num_planets; i++){
-        chose_position(state->universe,&x, &y, (float)PLANET_RADIUS, state->config.universe_width, state->config.universe_height);
+        if (chose_position(state->universe,&x, &y, (float)PLANET_RADIUS, state->config.universe_width, state->config.universe_height) != 0) {
+            fprintf(stderr, "No room for planet %c, the universe is too small\n", (char)(i+65));
+            game_destroy(state);
+            return NULL;
+        }
         universe_add_planet(state->universe, x, y, (char)(i+65));
     }
 
@@ -79,14 +382,24 @@ game_state* game_init(const char *config_file) {
     
     ////create trash at random locations 
     for (int i=0 ; i < state->config.initial_trash; i++){
-        chose_position(state->universe, &x, &y,(float)TRASH_RADIUS, state->config.universe_width, state->config.universe_height);
+        if (chose_position(state->universe, &x, &y,(float)TRASH_RADIUS, state->config.universe_width, state->config.universe_height) != 0) {
+            fprintf(stderr, "No room left, created %d of %d initial trash\n", i, state->config.initial_trash);
+            break;
+        }
         universe_add_trash(state->universe, x, y, (float) 0,(float) 0);
     }
-    
-    if (!state->display) {
-        fprintf(stderr, "Failed to initialize display\n");
-        free(state);
-        return NULL;
+
+    for (int i = 0; i < state->config.bots; i++) {
+        if (autopilot_spawn(&state->pilot, state->universe) == -1) {
+            fprintf(stderr, "No room left, spawned %d of %d bots\n", i, state->config.bots);
+            break;
+        }
+    }
+
+    if (state->sharded) {
+        keep_own_strip(state);
+        // From here on each shard draws its own numbers
+        srand((unsigned int)time(NULL) ^ ((unsigned int)shard << 16));
     }
 
     return state;
@@ -104,6 +417,22 @@ void game_destroy(game_state *state) {
         universe_destroy(state->universe);
     }
 
+    interest_scratch_destroy(&state->interest);
+    move_batch_destroy(&state->moves);
+    for (int i = 0; i < MAX_SHARDS; i++) {
+        shard_handoff_free(&state->outgoing[i]);
+    }
+    shard_handoff_free(&state->incoming);
+    if (state->views) {
+        for (int i = 0; i < state->sessions.capacity; i++) {
+            interest_view_destroy(&state->views[i]);
+        }
+    }
+    free(state->views);
+    free(state->queues);
+    session_registry_destroy(&state->sessions);
+    id_map_destroy(&state->moved_to);
+
     free(state);
 }
 
@@ -150,57 +479,40 @@ void handle_events(game_state *state) {
 
 }
 
-// Update game logic (physics, collisions, etc.)
-void update_game(game_state *state, int ch_pos, float * pos_x, float * pos_y, int universe_width, int universe_height) {
-    if (state->paused) {
-        return; // Skip updates when paused
-    }
-
-    //Check ships colisions
-    check_colision_ship(state->universe, ch_pos, pos_x, pos_y, universe_width, universe_height);
-
-    
-    /*// - Update trash positions
-    // - Check collisions
-    check_trash_planet_collisions(state->universe);*/
-
-    // Check if universe has collapsed
-    if (universe_has_collapsed(state->universe)) {
-        state->game_over = true;
-        printf("\n");
-        printf("═══════════════════════════════════════════\n");
-        printf("  THE UNIVERSE HAS COLLAPSED!\n");
-        printf("  Maximum trash reached: %d/%d\n", 
-               universe_count_active_trash(state->universe),
-               state->universe->max_trash);
-        printf("  Humanity is doomed!\n");
-        printf("═══════════════════════════════════════════\n");
-        printf("\nPress ESC or Q to exit.\n");
+// Game over once the universe is full of trash
+void check_collapse(game_state *state) {
+    if (state->game_over || !universe_has_collapsed(state->universe)) {
+        return;
     }
 
-    // TODO: Update physics (will be implemented in later steps) partB
-    // - Calculate gravitational forces partB
+    state->game_over = true;
+    printf("\n");
+    printf("═══════════════════════════════════════════\n");
+    printf("  THE UNIVERSE HAS COLLAPSED!\n");
+    printf("  Maximum trash reached: %d/%d\n", 
+           universe_count_active_trash(state->universe),
+           state->universe->max_trash);
+    printf("  Humanity is doomed!\n");
+    printf("═══════════════════════════════════════════\n");
+    printf(state->headless ? "\nStop the server with Ctrl+C.\n" : "\nPress ESC or Q to exit.\n");
 }
 
-
-void update_position(game_state * state, direction_t direction, float * x, float * y){
-
+// Pixels one move in this direction takes a ship
+void direction_step(direction_t direction, int *dx, int *dy) {
+    *dx = 0;
+    *dy = 0;
     switch (direction) {
     case UP:
-        (*y)--;
-        correct_position(y, state->config.universe_height);
+        *dy = -1;
         return;
     case DOWN:
-        (*y)++;
-        correct_position(y, state->config.universe_height);
+        *dy = 1;
         return;
     case LEFT:
-        (*x)--;
-        correct_position(x, state->config.universe_width);
+        *dx = -1;
         return;
     case RIGHT:
-        (*x)++;
-        correct_position(x, state->config.universe_width);
+        *dx = 1;
         return;
     default:
         printf("no direction");
@@ -208,9 +520,351 @@ void update_position(game_state * state, direction_t direction, float * x, float
     }
 }
 
+// One queued move, a step at a time so nothing on the way is skipped. The
+// steps are only recorded, resolve_moves applies them at the end of the drain
+void apply_move(game_state *state, int index, const queued_move *move) {
+    int dx, dy;
+    direction_step(move->direction, &dx, &dy);
+    for (int step = 0; step < move->steps; step++) {
+        move_batch_add_step(&state->moves, index, dx, dy);
+    }
+}
+
+// Apply queued inputs: held keys first, then moves one per ship in turn
+// until the queues are empty or INPUTS_PER_TICK moves were applied. The
+// first ship rotates every tick so none is always the one cut off.
+void drain_inputs(game_state *state) {
+    universe_data *universe = state->universe;
+    int num_ships = universe->num_ships;
+    if (num_ships == 0) {
+        return;
+    }
+    uint64_t now = latency_now_ns();
+    int first = state->input_turn % num_ships;
+
+    for (int i = 0; i < num_ships; i++) {
+        ship_structure *ship = &universe->ships[i];
+        input_queue *queue = ship_queue(state, ship->id);
+        if (queue && queue->has_keys) {
+            ship->input_keys = queue->keys;
+            ship->input_seq = queue->seq;
+            ship->input_ticks = 0;
+            queue->has_keys = false;
+        }
+    }
+
+    int budget = INPUTS_PER_TICK;
+    bool applied = true;
+    while (budget > 0 && applied) {
+        applied = false;
+        for (int j = 0; j < num_ships && budget > 0; j++) {
+            int index = (first + j) % num_ships;
+            input_queue *queue = ship_queue(state, universe->ships[index].id);
+            queued_move move;
+            if (queue && input_queue_pop_move(queue, now, &move, &state->input_stats)) {
+                latency_record(&state->tick_latency[TICK_QUEUED], now - move.enqueued_ns);
+                apply_move(state, index, &move);
+                budget--;
+                applied = true;
+            }
+        }
+    }
+    state->input_turn = first + 1;
+}
+
+// One tick of ship movement: one pixel along every held direction
+void advance_ships(game_state *state) {
+    universe_data *universe = state->universe;
+
+    for (int i = 0; i < universe->num_ships; i++) {
+        ship_structure *ship = &universe->ships[i];
+        unsigned int keys = ship->input_keys;
+        ship->input_ticks++;  // the client replays its prediction from here
+        if (keys == 0) continue;
+
+        int dx = 0, dy = 0;
+        if (keys & INPUT_UP) dy--;
+        if (keys & INPUT_DOWN) dy++;
+        if (keys & INPUT_LEFT) dx--;
+        if (keys & INPUT_RIGHT) dx++;
+        move_batch_add_step(&state->moves, i, dx, dy);
+    }
+}
+
+// Everything the ships run into this tick, for all of them in one pass
+void resolve_moves(game_state *state) {
+    uint64_t start = latency_now_ns();
+    universe_resolve_moves(state->universe, &state->moves);
+    latency_record(&state->tick_latency[TICK_MOVES], latency_now_ns() - start);
+}
+
+// ===== Shards =====
+
+// Free place for a connecting ship, inside this shard's strip if it can be
+// found in a few tries, otherwise the ship is handed off after the next tick
+// Returns 0 on success, -1 if the universe has no free place
+int choose_ship_position(game_state *state, float *x, float *y) {
+    int attempts = state->sharded ? SHARD_PLACEMENT_ATTEMPTS : 1;
+    int found = -1;
+    for (int i = 0; i < attempts; i++) {
+        if (chose_position(state->universe, x, y, SHIP_RADIUS,
+                           state->config.universe_width, state->config.universe_height) != 0) {
+            break;
+        }
+        found = 0;
+        if (!state->sharded || shard_owns(&state->shard, *x, 0)) {
+            break;
+        }
+    }
+    return found;
+}
+
+// Queue a MOVE or INPUT for the next tick
+// Returns false if the ship is not here or the token does not match
+bool queue_ship_request(game_state *state, const client_request *request, uint64_t now) {
+    ship_id id = request->ship;
+    if (universe_find_ship(state->universe, id) == -1 ||
+        !session_touch(&state->sessions, id, request->token, now)) {
+        return false;
+    }
+
+    if (request->type == MSG_MOVE) {
+        // Applied by the next tick, in turn with the other ships
+        input_queue_push_move(ship_queue(state, id), request->direction, now, &state->input_stats);
+    } else {
+        // The ship moves on the next ticks, not here
+        input_queue_push_keys(ship_queue(state, id), request->keys & INPUT_ALL,
+                              request->seq, now, &state->input_stats);
+        if (request->resync) {
+            interest_view_reset(ship_view(state, id));
+        }
+    }
+    return true;
+}
+
+// Until the front-end hears where a ship went, its requests still come here
+// and are passed on to the shard that has it now, which checks the token.
+// Returns false if the ship was not handed off.
+bool relay_request(game_state *state, const client_request *request, const uint8_t *frame, int size) {
+    int to = state->sharded ? id_map_get(&state->moved_to, request->ship) : -1;
+    if (to == -1 || universe_find_ship(state->universe, request->ship) != -1) {
+        return false;
+    }
+    return shard_handoff_add_relayed(&state->outgoing[to], frame, size) == 0;
+}
+
+// A request relayed by another shard, its client already has the answer
+void apply_relayed(game_state *state, const uint8_t *frame, int size) {
+    client_request request;
+    decode_message(frame, size, &request);
+    uint64_t now = latency_now_ns();
+
+    if (request.type == MSG_DISCONNECT) {
+        if (session_touch(&state->sessions, request.ship, request.token, now)) {
+            disconnect_ship(state, request.ship, "client left");
+            return;
+        }
+    } else if (request.type == MSG_MOVE || request.type == MSG_INPUT) {
+        if (queue_ship_request(state, &request, now)) {
+            return;
+        }
+    }
+    relay_request(state, &request, frame, size);  // it moved on again
+}
+
+// A ship crossing in from another shard's strip, with its session and cargo
+void adopt_ship(game_state *state, const handoff_ship *arriving) {
+    ship_id id = arriving->id;
+    int index = universe_find_ship(state->universe, id) == -1
+        ? universe_add_ship(state->universe, arriving->x, arriving->y, id) : -1;
+    if (index >= 0 && !arriving->bot &&
+        !session_adopt(&state->sessions, id, arriving->token, latency_now_ns())) {
+        universe_remove_ship(state->universe, index);
+        index = -1;
+    }
+    if (index < 0) {
+        char label[SHIP_LABEL_LEN];
+        fprintf(stderr, "Ship %s handed over but there is no place for it, it is lost\n",
+                ship_id_label(id, label, sizeof(label)));
+        if (!arriving->bot) {
+            send_shard_notice(state->notices, id, -1);
+        }
+        return;
+    }
+
+    ship_structure *ship = &state->universe->ships[index];
+    ship->input_keys = arriving->input_keys;
+    ship->input_seq = arriving->input_seq;
+    ship->input_ticks = arriving->input_ticks;
+    universe_load_foreign_cargo(state->universe, ship, (int)arriving->cargo);
+    id_map_remove(&state->moved_to, id);
+
+    // A new session slot is clean: the client starts over with a full update
+    if (arriving->bot) {
+        autopilot_adopt(&state->pilot, id);
+    } else {
+        send_shard_notice(state->notices, id, state->shard.index);
+    }
+}
+
+// Take in what the other shards handed over since the previous tick
+void adopt_handoffs(game_state *state) {
+    shard_handoff *handoff = &state->incoming;
+    while (receive_shard_handoff(state->inbox, handoff) > 0) {
+        for (int i = 0; i < handoff->num_trash; i++) {
+            handoff_trash *trash = &handoff->trash[i];
+            universe_add_trash(state->universe, trash->x, trash->y, trash->speed, trash->angle);
+        }
+        for (int i = 0; i < handoff->num_ships; i++) {
+            adopt_ship(state, &handoff->ships[i]);
+        }
+        int offset = 0;
+        for (int i = 0; i < handoff->num_relayed; i++) {
+            apply_relayed(state, handoff->relayed + offset, handoff->relayed_sizes[i]);
+            offset += handoff->relayed_sizes[i];
+        }
+    }
+}
+
+// A handoff shard to never took: its ships are gone, their clients are told
+// so through the front-end instead of being routed to a shard without them
+void drop_handoff(game_state *state, int to) {
+    shard_handoff *handoff = &state->outgoing[to];
+    fprintf(stderr, "Handoff to shard %d dropped: %d ships, %d trash\n",
+            to, handoff->num_ships, handoff->num_trash);
+    for (int i = 0; i < handoff->num_ships; i++) {
+        if (handoff->ships[i].bot) continue;
+        id_map_remove(&state->moved_to, handoff->ships[i].id);
+        send_shard_notice(state->notices, handoff->ships[i].id, -1);
+    }
+}
+
+// Hand ships and trash that left this shard's strip to the shard of the
+// strip they are in now, then send every shard what it was handed
+void hand_off_strays(game_state *state) {
+    universe_data *universe = state->universe;
+
+    // Backwards, removing a ship moves the last one into its slot
+    for (int i = universe->num_ships - 1; i >= 0; i--) {
+        ship_structure *ship = &universe->ships[i];
+        if (shard_owns(&state->shard, ship->x, SHARD_HANDOFF_MARGIN)) continue;
+
+        int to = shard_of(&state->shard, ship->x);
+        ship_id id = ship->id;
+        int slot = session_slot(&state->sessions, id);
+        handoff_ship leaving = {
+            .id = id,
+            .bot = autopilot_is_bot(&state->pilot, id),
+            .x = ship->x,
+            .y = ship->y,
+            .token = slot >= 0 ? state->sessions.sessions[slot].token : 0,
+            .cargo = (uint32_t)ship->num_trash,
+            .input_keys = ship->input_keys,
+            .input_seq = ship->input_seq,
+            .input_ticks = ship->input_ticks
+        };
+        if (shard_handoff_add_ship(&state->outgoing[to], &leaving) != 0) continue;
+
+        ship->num_trash = 0;  // the cargo goes along, it is not released here
+        universe_remove_ship(universe, i);
+        close_session(state, id);
+        autopilot_forget(&state->pilot, id);
+        if (!leaving.bot) {
+            id_map_put(&state->moved_to, id, to);
+        }
+        state->ships_handed_off++;
+        char label[SHIP_LABEL_LEN];
+        printf("Ship %s handed to shard %d\n", ship_id_label(id, label, sizeof(label)), to);
+    }
+
+    for (int i = 0; i < universe->max_trash; i++) {
+        trash_structure *trash = &universe->trash[i];
+        if (!trash->active || shard_owns(&state->shard, trash->x, SHARD_HANDOFF_MARGIN)) continue;
+
+        handoff_trash leaving = {trash->x, trash->y, trash->velocity.amplitude, trash->velocity.angle};
+        if (shard_handoff_add_trash(&state->outgoing[shard_of(&state->shard, trash->x)], &leaving) == 0) {
+            universe_remove_trash(universe, i);
+            state->trash_handed_off++;
+        }
+    }
 
+    for (int i = 0; i < state->shard.count; i++) {
+        if (i == state->shard.index || shard_handoff_is_empty(&state->outgoing[i])) continue;
+        if (send_shard_handoff(state->outboxes[i], &state->outgoing[i]) < 0 &&
+            ++state->handoff_retries[i] < SHARD_HANDOFF_RETRIES) {
+            continue;  // kept, and sent with what the next tick adds to it
+        }
+        if (state->handoff_retries[i] >= SHARD_HANDOFF_RETRIES) {
+            drop_handoff(state, i);
+        }
+        state->handoff_retries[i] = 0;
+        shard_handoff_clear(&state->outgoing[i]);
+    }
+}
 
+// Sockets to the other shards and the front-end
+// Returns 0 on success, -1 on error
+int shard_connect(game_state *state) {
+    char endpoint[ENDPOINT_LEN];
+    shard_endpoint(endpoint, sizeof(endpoint), SHARD_HANDOFF_ENDPOINT, state->shard.index);
+    state->inbox = create_shard_inbox(endpoint);
+    state->notices = create_shard_outbox(SHARD_NOTICE_ENDPOINT);
+    if (!state->inbox || !state->notices) {
+        return -1;
+    }
+    for (int i = 0; i < state->shard.count; i++) {
+        if (i == state->shard.index) continue;
+        shard_endpoint(endpoint, sizeof(endpoint), SHARD_HANDOFF_ENDPOINT, i);
+        state->outboxes[i] = create_shard_outbox(endpoint);
+        if (!state->outboxes[i]) {
+            return -1;
+        }
+    }
+    printf("Shard %d handing off through %s\n", state->shard.index, SHARD_HANDOFF_ENDPOINT);
 
+    // Players this shard starts with are none, bots are not reported
+    return 0;
+}
+
+void shard_disconnect(game_state *state) {
+    for (int i = 0; i < MAX_SHARDS; i++) {
+        if (state->outboxes[i]) {
+            zmq_close(state->outboxes[i]);
+            state->outboxes[i] = NULL;
+        }
+    }
+    if (state->inbox) zmq_close(state->inbox);
+    if (state->notices) zmq_close(state->notices);
+    state->inbox = NULL;
+    state->notices = NULL;
+}
+
+// One simulation step: ships along their held keys, then trash physics
+void tick_game(game_state *state) {
+    if (state->paused || state->game_over) {
+        return;
+    }
+
+    if (state->sharded) {
+        adopt_handoffs(state);
+    }
+
+    // Moves are collected first and resolved together
+    drain_inputs(state);
+    advance_ships(state);
+    autopilot_steer(&state->pilot, state->universe, &state->moves);
+    resolve_moves(state);
+
+    // Gravity, friction and wraparound, then trash hitting planets
+    update_physics(state->universe);
+    check_trash_planet_collisions(state->universe);
+
+    if (state->sharded) {
+        hand_off_strays(state);
+    }
+
+    check_collapse(state);
+}
 
 // Render the universe
 void render_game(game_state *state) {
@@ -248,10 +902,10 @@ void render_game(game_state *state) {
     }
     
     // Draw ships
-    for (int i = 0; i < state->universe->max_ships; i++) {
+    for (int i = 0; i < state->universe->num_ships; i++) {
         ship_structure *ship = universe_get_ship(state->universe, i);
         if (ship) {
-            display_draw_ship(state->display, ship->x, ship->y, ship->name, ship->num_trash, ship->radius);
+            display_draw_ship(state->display, ship->x, ship->y, ship_id_letter(ship->id), ship->num_trash, ship->radius);
         }
     }
     
@@ -272,127 +926,437 @@ void render_game(game_state *state) {
     display_present(state->display);
 }
 
-// Main game loop
-void game_loop(game_state *state) {
-    //Uint32 last_time = SDL_GetTicks();
-    Uint32 current_time;
-    //Uint32 delta_time;
-    const Uint32 TARGET_DELTA = 10; // 10ms per frame (100 FPS)
+// Apply one decoded request and decide its reply, stats rows go in stats
+// frame and size are the request as received, to relay it to another shard
+// Returns the command it is timed as, or -1 if it is not timed
+int apply_request(game_state *state, const client_request *request, const uint8_t *frame, int size,
+                  uint64_t now, server_reply *reply, latency_summary *stats) {
+    int ch_pos;
+    float pos_x, pos_y;
+    ship_id id = request->ship;
+    char label[SHIP_LABEL_LEN];
+    ship_id_label(id, label, sizeof(label));
+
+    memset(reply, 0, sizeof(*reply));
+    reply->kind = REPLY_RESULT;
+    reply->request = *request;
+
+    if (request->type == MSG_CONNECT) {
+        reply->kind = REPLY_CONNECT;
+        // Bot ids are the server's own
+        if (id == SHIP_ID_NONE || autopilot_is_bot(&state->pilot, id)) {
+            printf("Ship %s refused, not a player id\n", label);
+            return TIMED_CONNECT;
+        }
+        ch_pos = universe_find_ship(state->universe, id);
+        // Players come first: a bot leaves when the universe is full
+        if (ch_pos == -1 && !state->sharded && state->universe->num_ships >= state->universe->max_ships) {
+            ship_id bot = autopilot_pick_bot(&state->pilot, state->universe);
+            if (bot != SHIP_ID_NONE) {
+                disconnect_ship(state, bot, "making room for a player");
+            }
+        }
+        // Escolher posição antes de adicionar a nave
+        if (ch_pos == -1 && state->universe->num_ships < state->universe->max_ships &&
+            choose_ship_position(state, &pos_x, &pos_y) == 0) {
+            ch_pos = universe_add_ship(state->universe, pos_x, pos_y, id);
+            if (state->sharded) {
+                id_map_remove(&state->moved_to, id);
+                send_shard_notice(state->notices, id, state->shard.index);
+            }
+            reply->success = 1;
+            reply->info.token = session_open(&state->sessions, id, now);
+            reply->info.tick_rate = state->config.tick_rate;
+            reply->info.universe_width = state->config.universe_width;
+            reply->info.universe_height = state->config.universe_height;
+            printf("Ship %s connected\n", label);
+        } else {
+            printf("Ship %s %s\n", label, ch_pos == -1 ? "refused, universe is full" : "already connected");
+        }
+        return TIMED_CONNECT;
 
-    printf("\n=== Universe Simulator Running ===\n");
-    printf("Controls:\n");
-    printf("  ESC or Q     - Quit\n");
-    printf("  SPACE        - Pause/Resume\n");
-    printf("  Close Window - Quit\n");
-    printf("==================================\n\n");
+    } else if (request->type == MSG_MOVE || request->type == MSG_INPUT) {
+        reply->success = queue_ship_request(state, request, now) ||
+                         relay_request(state, request, frame, size);
+        if (!reply->success) {
+            printf("Ship %s not found\n", label);
+        }
+        return request->type == MSG_MOVE ? TIMED_MOVE : TIMED_INPUT;
+
+    } else if (request->type == MSG_DISCONNECT) {
+        if (session_touch(&state->sessions, id, request->token, now)) {
+            disconnect_ship(state, id, "client left");
+            reply->success = 1;
+        } else {
+            reply->success = relay_request(state, request, frame, size);
+        }
 
+    } else if (request->type == MSG_STATS) {
+        reply->kind = REPLY_STATS;
+        reply->stats = stats;
+        reply->num_stats = summarize_latency(state, stats);
+    }
+    // MSG_UNKNOWN is answered with a failure: REP sockets must answer every
+    // request before receiving again
+    return -1;
+}
 
-    void *fd = create_server_channel();
+// Receive, apply and answer one client request
+void serve_request(game_state *state, void *fd, command_timing *timing) {
+    zmq_msg_t frame;
+    client_request request;
+    server_reply reply;
+    latency_summary stats[NUM_LATENCY_ROWS];
+
+    timing->receive_start = latency_now_ns();
+    int size = receive_message(fd, &frame);
+    state->requests++;
+    timing->decode_start = latency_now_ns();
+    decode_message(zmq_msg_data(&frame), size, &request);
+    timing->apply_start = latency_now_ns();
+
+    if (request.type != MSG_ERROR) {
+        int command = apply_request(state, &request, zmq_msg_data(&frame), size, timing->apply_start,
+                                    &reply, stats);
+        timing->reply_start = latency_now_ns();
+        send_server_reply(fd, &reply);
+        if (command >= 0) {
+            record_latency(state, command, timing);
+        }
+    }
+    zmq_msg_close(&frame);
+    timing->wait_start = latency_now_ns();
+}
 
-    int ch_pos = -1;  // Declare at function scope
+// serve_request for a request the decode stage of the pipeline queued: the
+// reply is handed to the encode stage. The wait stage is 0 (the decode stage
+// is always reading), decode includes the time queued, reply is the handoff.
+void serve_queued_request(game_state *state, const pipeline_request *queued, command_timing *timing) {
+    server_reply reply;
+    latency_summary stats[NUM_LATENCY_ROWS];
+
+    state->requests++;
+    timing->wait_start = queued->receive_start;
+    timing->receive_start = queued->receive_start;
+    timing->decode_start = queued->decode_start;
+    timing->apply_start = latency_now_ns();
+
+    int command = apply_request(state, &queued->request, queued->frame, queued->size, timing->apply_start,
+                                &reply, stats);
+    timing->reply_start = latency_now_ns();
+    pipeline_send_reply(state->pipeline, queued, &reply);
+    if (command >= 0) {
+        record_latency(state, command, timing);
+    }
+}
 
-    float pos_x = 0.0;
-    float pos_y = 0.0;
+// Send every connected ship what changed in its interest region
+void publish_updates(game_state *state, void *publisher) {
+    uint64_t start = latency_now_ns();
+    world_update update;
+    update.tick = (uint32_t)state->ticks;
+
+    for (int i = 0; i < state->universe->num_ships; i++) {
+        ship_structure *ship = &state->universe->ships[i];
+        interest_view *view = ship_view(state, ship->id);
+        if (!view) continue;  // a bot, nobody to send it to
+
+        int result = interest_view_update(view, state->universe, ship->x, ship->y,
+                                          state->config.interest_radius, &state->interest, &update);
+        if (result < 0) {
+            interest_view_reset(view);  // start over with a full update next tick
+        } else if (result > 0) {
+            update.ack_seq = ship->input_seq;
+            update.ack_ticks = ship->input_ticks;
+            if (state->pipeline) {
+                pipeline_send_update(state->pipeline, ship->id, &update);
+                continue;
+            }
+            int size = send_world_update(publisher, ship->id, &update);
+            if (size > 0) {
+                state->update_bytes += size;
+            }
+        }
+    }
+    // The encode stage sends them and counts their bytes
+    if (state->pipeline) {
+        pipeline_flush(state->pipeline);
+        state->update_bytes = pipeline_update_bytes(state->pipeline);
+    }
+    latency_record(&state->tick_latency[TICK_PUBLISH], latency_now_ns() - start);
+}
+
+// Run the ticks that are due at now, never more than MAX_CATCHUP_TICKS + 1
+// Returns the number of ticks run
+int run_ticks(game_state *state, uint64_t now, uint64_t tick_ns, uint64_t *next_tick) {
+    if (now > *next_tick + MAX_CATCHUP_TICKS * tick_ns) {
+        uint64_t missed = (now - *next_tick) / tick_ns;
+        state->ticks_dropped += missed;
+        *next_tick += missed * tick_ns;
+    }
 
-    char message_type[100];
-    char c;
-    direction_t direction;
+    int ran = 0;
+    while (now >= *next_tick) {
+        uint64_t tick_start = latency_now_ns();
+        tick_game(state);
+        uint64_t tick_time = latency_now_ns() - tick_start;
 
-    while (state->running) {
-        current_time = SDL_GetTicks();
-        //delta_time = current_time - last_time;
-        
-    /*
-        // Update game logic (only if enough time has passed)
-        if (delta_time >= TARGET_DELTA) {
-            update_game(state, ch_pos, &pos_x, &pos_y, state->config.universe_width, state->config.universe_height);
-            last_time = current_time;
+        latency_record(&state->tick_latency[TICK_RUN], tick_time);
+        latency_record(&state->tick_latency[TICK_LATE], tick_start - *next_tick);
+        if (tick_time > tick_ns) {
+            state->tick_overruns++;
         }
-        */
+        state->ticks++;
+        *next_tick += tick_ns;
+        ran++;
+    }
+    return ran;
+}
 
-        // Render
-        render_game(state);
+// Counters at the previous throughput log
+typedef struct {
+    uint64_t at_ns;
+    uint64_t requests;
+    uint64_t ticks;
+    uint64_t moves;
+    uint64_t update_bytes;
+} throughput_mark;
+
+// One line of throughput since the previous mark
+void log_throughput(game_state *state, throughput_mark *mark, uint64_t now) {
+    double seconds = (now - mark->at_ns) / 1e9;
+
+    printf("[stats] %.0f req/s, %.0f ticks/s, %.0f moves/s, %.1f KB/s updates, %d ships (%d bots), %d trash, "
+           "%llu ticks overran, %llu dropped\n",
+           (state->requests - mark->requests) / seconds,
+           (state->ticks - mark->ticks) / seconds,
+           (state->input_stats.moves - mark->moves) / seconds,
+           (state->update_bytes - mark->update_bytes) / seconds / 1024.0,
+           state->universe->num_ships, state->pilot.count, state->universe->num_trash,
+           (unsigned long long)state->tick_overruns, (unsigned long long)state->ticks_dropped);
+    if (state->sharded) {
+        printf("[stats] shard %d: %llu ships and %llu trash handed off\n", state->shard.index,
+               (unsigned long long)state->ships_handed_off, (unsigned long long)state->trash_handed_off);
+    }
+    fflush(stdout);
 
-        // Sleep to maintain frame rate and not consume 100% CPU
-        // If we processed frame too fast, sleep for remaining time
-        Uint32 frame_time = SDL_GetTicks() - current_time;
-        if (frame_time < TARGET_DELTA) {
-            SDL_Delay(TARGET_DELTA - frame_time);
-        }
+    mark->at_ns = now;
+    mark->requests = state->requests;
+    mark->ticks = state->ticks;
+    mark->moves = state->input_stats.moves;
+    mark->update_bytes = state->update_bytes;
+}
+
+// Main game loop
+void game_loop(game_state *state) {
+    printf("\n=== Universe Simulator Running ===\n");
+    if (state->headless) {
+        printf("Headless: stop with Ctrl+C or SIGTERM, SIGUSR1 prints latency\n");
+    } else {
+        printf("Controls:\n");
+        printf("  ESC or Q     - Quit\n");
+        printf("  SPACE        - Pause/Resume\n");
+        printf("  Close Window - Quit\n");
+    }
+    printf("==================================\n\n");
+
+
+    const char *endpoints[MAX_ENDPOINTS];
+    for (int i = 0; i < state->config.num_server_endpoints; i++) {
+        endpoints[i] = state->config.server_endpoints[i];
+    }
+    // The pipeline answers requests out of turn, which takes a ROUTER
+    void *fd = state->config.pipeline ? create_server_router(endpoints, state->config.num_server_endpoints)
+                                      : create_server_channel(endpoints, state->config.num_server_endpoints);
+    if (!fd) {
+        fprintf(stderr, "Failed to create server channel\n");
+        return;
+    }
+
+    for (int i = 0; i < state->config.num_update_endpoints; i++) {
+        endpoints[i] = state->config.update_endpoints[i];
+    }
+    void *publisher = create_update_publisher(endpoints, state->config.num_update_endpoints);
+    if (!publisher) {
+        fprintf(stderr, "Failed to create update channel\n");
+        zmq_close(fd);
+        return;
+    }
 
-        // Handle input events of the server
-        if (state->running) {
-            handle_events(state);
+    if (state->sharded && shard_connect(state) != 0) {
+        fprintf(stderr, "Failed to connect to the other shards\n");
+        shard_disconnect(state);
+        zmq_close(publisher);
+        zmq_close(fd);
+        return;
+    }
+
+    pipeline stages;
+    if (state->config.pipeline) {
+        if (pipeline_start(&stages, fd, publisher, state->config.pipeline_core) != 0) {
+            fprintf(stderr, "Failed to start the server pipeline\n");
+            shard_disconnect(state);
+            zmq_close(publisher);
+            zmq_close(fd);
+            return;
         }
+        state->pipeline = &stages;
+    }
 
-        // Handle input events of the client
+    const uint64_t tick_ns = 1000000000ull / state->config.tick_rate;
+    // Without a window there are no frames, only ticks and stats lines
+    const uint64_t frame_ns = state->headless ? HEADLESS_STATS_SECONDS * 1000000000ull
+                                              : FRAME_MS * 1000000ull;
 
-        read_message(fd, message_type, &c, &direction);
+    command_timing timing = {0};
+    timing.wait_start = latency_now_ns();
+    uint64_t last_idle_check = timing.wait_start;
+    uint64_t next_tick = timing.wait_start + tick_ns;
+    uint64_t next_frame = timing.wait_start + (state->headless ? frame_ns : 0);
+    throughput_mark mark = {timing.wait_start, 0, 0, 0, 0};
 
-        if (strcmp(message_type, "CONNECT") == 0) {
+    while (state->running) {
+        uint64_t now = latency_now_ns();
+
+        // The world advances on its own clock, not when messages arrive
+        if (run_ticks(state, now, tick_ns, &next_tick) > 0) {
+            publish_updates(state, publisher);
+        }
 
-            ch_pos = find_ship_info(state->universe, state->universe->num_ships, c);
-            if (ch_pos == -1) {
-                send_response(fd, message_type, "OK");
-                printf("Ship %c connected\n", c);
+        // Render and handle input events of the server
+        if (now >= next_frame) {
+            if (state->headless) {
+                log_throughput(state, &mark, now);
             } else {
-                send_response(fd, message_type, "NOT OK");
-                printf("Ship %c already connected\n", c);
-                continue;
+                render_game(state);
+                handle_events(state);
             }
-            // Escolher posição antes de adicionar a nave
-            chose_position(state->universe, &pos_x, &pos_y, 
-                SHIP_RADIUS, state->config.universe_width, state->config.universe_height);
-            universe_add_ship(state->universe, pos_x, pos_y, c);
-            ch_pos = state->universe->num_ships - 1;  // Atualizar ch_pos com índice da nova nave
-
-        }
-        if (strcmp(message_type, "MOVE") == 0) {
-            ch_pos = find_ship_info(state->universe, state->universe->num_ships, c);
-            
-            if (ch_pos == -1) {
-                send_response(fd, message_type, "NOT OK");
-                printf("Ship %c not found\n", c);
-                continue;
+            next_frame = now + frame_ns;
+        }
+
+        // Serve clients until the next tick or frame is due
+        now = latency_now_ns();
+        uint64_t deadline = next_tick < next_frame ? next_tick : next_frame;
+        int timeout_ms = deadline > now ? (int)((deadline - now + 999999) / 1000000) : 0;
+        // Everything waiting is taken in one go: requests only go into the
+        // queues here, the tick decides what gets applied
+        if (state->pipeline) {
+            if (pipeline_wait(state->pipeline, timeout_ms) > 0) {
+                pipeline_request *queued;
+                int served = 0;
+                while (served++ < MAX_REQUESTS_PER_WAKE &&
+                       (queued = pipeline_next_request(state->pipeline)) != NULL) {
+                    serve_queued_request(state, queued, &timing);
+                    pipeline_request_done(state->pipeline);
+                }
+                pipeline_flush(state->pipeline);
             }
-            /* claculates new mark position */
-            ship_structure * ship = universe_get_ship(state->universe, ch_pos);
-            send_response(fd, message_type, "OK");
-            pos_x = ship->x;    
-            pos_y = ship->y;
+        } else if (wait_message(fd, timeout_ms) > 0) {
+            int served = 0;
+            do {
+                serve_request(state, fd, &timing);
+            } while (++served < MAX_REQUESTS_PER_WAKE && wait_message(fd, 0) > 0);
+        }
 
-            update_position(state, direction, &pos_x, &pos_y);
+        now = latency_now_ns();
+        if (now - last_idle_check >= 1000000000ull) {
+            evict_idle_ships(state, now);
+            last_idle_check = now;
+        }
 
-            update_game(state, ch_pos, &pos_x, &pos_y, state->config.universe_width, state->config.universe_height);
-            
-        }        
+        if (dump_latency_requested) {
+            dump_latency_requested = 0;
+            print_latency(state);
+        }
+        if (stop_requested) {
+            state->running = false;
+        }
+    }
+
+    if (state->pipeline) {
+        pipeline_stop(state->pipeline);
+        if (stages.dropped > 0) {
+            printf("Pipeline: %llu requests dropped, their envelope was too long\n",
+                   (unsigned long long)stages.dropped);
+        }
+        state->pipeline = NULL;
     }
+    shard_disconnect(state);
+    zmq_close(publisher);
+    zmq_close(fd);
 
+    print_latency(state);
     printf("\n=== Universe Simulator Stopped ===\n");
 }
 
 int main(int argc, char *argv[]) {
     
     const char *config_file = "universe.conf";
+    const char *bind_endpoints[MAX_ENDPOINTS];
+    int num_bind_endpoints = 0;
+    bool headless = false;
+    int shard = -1;
     // Inicializar gerador de números aleatórios
     srand(time(NULL));
 
-    // Allow custom config file via command line
-    if (argc > 1) {
-        config_file = argv[1];
+    // Usage: universe_server [config_file] [--headless] [--bind endpoint]... [--shard N]
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--bind") == 0) {
+            if (i + 1 >= argc || num_bind_endpoints >= MAX_ENDPOINTS ||
+                strlen(argv[i + 1]) >= ENDPOINT_LEN) {
+                fprintf(stderr, "Usage: %s [config_file] [--headless] [--bind endpoint]... [--shard N] "
+                        "(max %d endpoints)\n", argv[0], MAX_ENDPOINTS);
+                return 1;
+            }
+            bind_endpoints[num_bind_endpoints++] = argv[++i];
+        } else if (strcmp(argv[i], "--shard") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Usage: %s [config_file] [--headless] [--bind endpoint]... [--shard N]\n", argv[0]);
+                return 1;
+            }
+            shard = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--headless") == 0) {
+            headless = true;
+        } else {
+            config_file = argv[i];
+        }
     }
 
     printf("=== Space Trash - Universe Simulator ===\n");
     printf("Loading configuration from: %s\n\n", config_file);
 
     // Initialize game
-    game_state *state = game_init(config_file);
+    game_state *state = game_init(config_file, headless, shard);
     if (!state) {
         fprintf(stderr, "Failed to initialize game. Exiting.\n");
         return 1;
     }
 
-    
+    // Endpoints given on the command line replace the ones from the config file
+    if (num_bind_endpoints > 0) {
+        for (int i = 0; i < num_bind_endpoints; i++) {
+            strcpy(state->config.server_endpoints[i], bind_endpoints[i]);
+        }
+        state->config.num_server_endpoints = num_bind_endpoints;
+    }
+
+    // A shard only talks to the front-end, which binds the config endpoints.
+    // Its own endpoints win over --bind, or the front-end could not reach it.
+    if (state->sharded) {
+        if (num_bind_endpoints > 0) {
+            fprintf(stderr, "Shard %d ignores --bind, it is reached through the front-end\n", shard);
+        }
+        shard_endpoint(state->config.server_endpoints[0], ENDPOINT_LEN, SHARD_REQUEST_ENDPOINT, shard);
+        shard_endpoint(state->config.update_endpoints[0], ENDPOINT_LEN, SHARD_UPDATE_ENDPOINT, shard);
+        state->config.num_server_endpoints = 1;
+        state->config.num_update_endpoints = 1;
+    }
+
+    // kill -USR1 <pid> prints the command latency histograms, which are
+    // also printed when the server stops (including on Ctrl+C / SIGTERM)
+    signal(SIGUSR1, handle_sigusr1);
+    signal(SIGINT, handle_stop_signal);
+    signal(SIGTERM, handle_stop_signal);
 
     printf("\nInitialization successful!\n");
 
@@ -0,0 +1,95 @@
+#include "worker-pool.h"
+#include <stdio.h>
+#include <string.h>
+
+static void take_items(worker_pool *pool) {
+    int item;
+    while ((item = atomic_fetch_add(&pool->next_item, 1)) < pool->num_items) {
+        pool->task(pool->arg, item);
+    }
+}
+
+static void *worker_main(void *data) {
+    worker_pool *pool = (worker_pool*)data;
+    unsigned int seen = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    while (true) {
+        while (pool->run == seen && !pool->stopping) {
+            pthread_cond_wait(&pool->start, &pool->lock);
+        }
+        if (pool->stopping) break;
+        seen = pool->run;
+        pthread_mutex_unlock(&pool->lock);
+
+        take_items(pool);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->running == 0) {
+            pthread_cond_signal(&pool->done);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+int worker_pool_init(worker_pool *pool, int num_threads) {
+    memset(pool, 0, sizeof(*pool));
+    if (num_threads < 0 || num_threads > MAX_WORKERS) {
+        fprintf(stderr, "Worker pool of %d threads, at most %d\n", num_threads, MAX_WORKERS);
+        return -1;
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    for (int i = 0; i < num_threads; i++) {
+        if (pthread_create(&pool->threads[i], NULL, worker_main, pool) != 0) {
+            fprintf(stderr, "Failed to start worker thread %d\n", i);
+            worker_pool_destroy(pool);
+            return -1;
+        }
+        pool->num_threads++;
+    }
+    return 0;
+}
+
+void worker_pool_destroy(worker_pool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 0; i < pool->num_threads; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    pool->num_threads = 0;
+    pthread_cond_destroy(&pool->start);
+    pthread_cond_destroy(&pool->done);
+    pthread_mutex_destroy(&pool->lock);
+}
+
+void worker_pool_run(worker_pool *pool, int num_items, worker_task task, void *arg) {
+    pool->task = task;
+    pool->arg = arg;
+    pool->num_items = num_items;
+    atomic_store(&pool->next_item, 0);
+
+    if (pool->num_threads > 0 && num_items > 1) {
+        pthread_mutex_lock(&pool->lock);
+        pool->running = pool->num_threads;
+        pool->run++;
+        pthread_cond_broadcast(&pool->start);
+        pthread_mutex_unlock(&pool->lock);
+
+        take_items(pool);
+
+        pthread_mutex_lock(&pool->lock);
+        while (pool->running > 0) {
+            pthread_cond_wait(&pool->done, &pool->lock);
+        }
+        pthread_mutex_unlock(&pool->lock);
+    } else {
+        take_items(pool);
+    }
+}
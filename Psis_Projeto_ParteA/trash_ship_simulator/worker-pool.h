@@ -0,0 +1,43 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+
+#define MAX_WORKERS 16
+
+// Work of one item, called from any thread of the pool
+typedef void (*worker_task)(void *arg, int item);
+
+// Threads kept waiting between runs, so handing them work costs a wakeup
+// instead of a thread creation. The caller works too: a pool of n threads
+// runs items on n + 1 threads.
+typedef struct {
+    pthread_t threads[MAX_WORKERS];
+    int num_threads;
+    pthread_mutex_t lock;
+    pthread_cond_t start;
+    pthread_cond_t done;
+    unsigned int run;           // bumped for every run, workers wait for a new one
+    int running;                // workers not finished with the current run
+    bool stopping;
+
+    worker_task task;
+    void *arg;
+    int num_items;
+    atomic_int next_item;       // next item to take, shared by all threads
+} worker_pool;
+
+// Start num_threads threads (0 runs everything on the caller)
+// Returns 0 on success, -1 on error
+int worker_pool_init(worker_pool *pool, int num_threads);
+
+// Stop and join the threads
+void worker_pool_destroy(worker_pool *pool);
+
+// Call task for items 0..num_items-1, in no particular order and thread,
+// and return once all are done
+void worker_pool_run(worker_pool *pool, int num_items, worker_task task, void *arg);
+
+#endif // WORKER_POOL_H
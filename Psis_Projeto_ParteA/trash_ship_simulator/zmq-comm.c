@@ -1,6 +1,9 @@
 #include "zmq-comm.h"
 #include "letter-movements.pb-c.h"
+#include <errno.h>
 #include <fcntl.h>
+#include <pthread.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -13,120 +16,478 @@
 
 
 
-void *create_server_channel() {
-  void *context = zmq_ctx_new();
-  void *responder = zmq_socket(context, ZMQ_REP);
+// One context per process so inproc:// endpoints are reachable from every
+// socket created here. Threads of the load generator and the server ask for
+// it concurrently, so it is created exactly once.
+static void *comm_context = NULL;
+static pthread_once_t comm_context_once = PTHREAD_ONCE_INIT;
+
+static void create_comm_context(void) {
+  comm_context = zmq_ctx_new();
+}
+
+void *get_comm_context() {
+  pthread_once(&comm_context_once, create_comm_context);
+  return comm_context;
+}
+
+void *create_server_channel(const char **endpoints, int num_endpoints) {
+  void *responder = zmq_socket(get_comm_context(), ZMQ_REP);
   
   // Set receive timeout to make socket non-blocking (10ms timeout)
   int timeout = 10;
   zmq_setsockopt(responder, ZMQ_RCVTIMEO, &timeout, sizeof(timeout));
   
-  int response = zmq_bind(responder, "tcp://*:5555");
-  (void)response;
+  for (int i = 0; i < num_endpoints; i++) {
+    if (zmq_bind(responder, endpoints[i]) != 0) {
+      fprintf(stderr, "Failed to bind %s: %s\n", endpoints[i], zmq_strerror(zmq_errno()));
+      zmq_close(responder);
+      return NULL;
+    }
+    printf("Server listening on %s\n", endpoints[i]);
+  }
   return responder;
 }
 
-void read_message(void *fd, char *message_type, char *c, direction_t *direction) {
-  uint8_t buffer[1024];
-  int size = zmq_recv(fd, buffer, sizeof(buffer), 0);
+void *create_server_router(const char **endpoints, int num_endpoints) {
+  void *router = zmq_socket(get_comm_context(), ZMQ_ROUTER);
+
+  for (int i = 0; i < num_endpoints; i++) {
+    if (zmq_bind(router, endpoints[i]) != 0) {
+      fprintf(stderr, "Failed to bind %s: %s\n", endpoints[i], zmq_strerror(zmq_errno()));
+      zmq_close(router);
+      return NULL;
+    }
+    printf("Server listening on %s\n", endpoints[i]);
+  }
+  return router;
+}
+
+// Per-thread bump arena backing protobuf-c decoding. Requests are tiny, so
+// every allocation of an unpack fits here and the arena is simply rewound
+// before the next message instead of freeing each field.
+#define DECODE_ARENA_SIZE 4096
+
+static _Thread_local struct {
+  _Alignas(max_align_t) uint8_t data[DECODE_ARENA_SIZE];
+  size_t used;
+} decode_arena;
+
+static void *arena_alloc(void *allocator_data, size_t size) {
+  (void)allocator_data;
+  size_t align = _Alignof(max_align_t);
+  size_t offset = (decode_arena.used + align - 1) & ~(align - 1);
+
+  if (offset + size > DECODE_ARENA_SIZE) {
+    return NULL;  // protobuf-c turns this into a failed unpack
+  }
+  decode_arena.used = offset + size;
+  return decode_arena.data + offset;
+}
+
+static void arena_free(void *allocator_data, void *pointer) {
+  (void)allocator_data;
+  (void)pointer;  // released all at once by the next reset
+}
+
+static ProtobufCAllocator arena_allocator = {arena_alloc, arena_free, NULL};
+
+// Send buffers. A frame small enough to live inside the zmq_msg_t itself is
+// packed straight into it. Anything bigger is packed into a pooled buffer
+// that zmq takes over with zmq_msg_init_data, without copying it, and hands
+// back through release_buffer once the I/O thread has written it. Buffers
+// come in power of two size classes and are recycled, so once the pool is
+// warm sending a world update or a stats table allocates nothing.
+#define INLINE_FRAME_SIZE 32     // libzmq keeps messages up to 33 bytes inline
+#define MIN_POOLED_SIZE 256
+#define NUM_POOL_CLASSES 13      // 256 B up to 1 MB
+#define MAX_POOLED_BUFFERS 16    // kept per class, the rest goes back to malloc
+
+typedef union pooled_buffer {
+  struct {
+    union pooled_buffer *next;
+    int size_class;              // -1 = too big for the pool, freed after use
+  } header;
+  max_align_t align;             // the frame starts right after the header
+} pooled_buffer;
+
+// Buffers are returned from the zmq I/O thread, hence the lock
+static struct {
+  pthread_mutex_t lock;
+  pooled_buffer *free_list[NUM_POOL_CLASSES];
+  int num_free[NUM_POOL_CLASSES];
+} buffer_pool = {PTHREAD_MUTEX_INITIALIZER, {NULL}, {0}};
+
+static uint8_t *buffer_data(pooled_buffer *buffer) {
+  return (uint8_t *)(buffer + 1);
+}
+
+static pooled_buffer *acquire_buffer(size_t size) {
+  int size_class = 0;
+  while (size_class < NUM_POOL_CLASSES && ((size_t)MIN_POOLED_SIZE << size_class) < size) {
+    size_class++;
+  }
+
+  pooled_buffer *buffer = NULL;
+  if (size_class < NUM_POOL_CLASSES) {
+    pthread_mutex_lock(&buffer_pool.lock);
+    buffer = buffer_pool.free_list[size_class];
+    if (buffer) {
+      buffer_pool.free_list[size_class] = buffer->header.next;
+      buffer_pool.num_free[size_class]--;
+    }
+    pthread_mutex_unlock(&buffer_pool.lock);
+    if (buffer) {
+      return buffer;
+    }
+    size = (size_t)MIN_POOLED_SIZE << size_class;
+  } else {
+    size_class = -1;
+  }
+
+  buffer = malloc(sizeof(pooled_buffer) + size);
+  if (buffer) {
+    buffer->header.size_class = size_class;
+  }
+  return buffer;
+}
+
+// zmq_free_fn: called by zmq when the last reference to the frame is gone
+static void release_buffer(void *data, void *hint) {
+  (void)data;
+  pooled_buffer *buffer = hint;
+  int size_class = buffer->header.size_class;
+
+  if (size_class >= 0) {
+    pthread_mutex_lock(&buffer_pool.lock);
+    if (buffer_pool.num_free[size_class] < MAX_POOLED_BUFFERS) {
+      buffer->header.next = buffer_pool.free_list[size_class];
+      buffer_pool.free_list[size_class] = buffer;
+      buffer_pool.num_free[size_class]++;
+      buffer = NULL;
+    }
+    pthread_mutex_unlock(&buffer_pool.lock);
+  }
+  free(buffer);
+}
+
+// Pack message into the memory of a new frame and send it.
+// Returns the frame size in bytes, or -1 on error
+static int send_packed(void *fd, const ProtobufCMessage *message, int flags) {
+  size_t size = protobuf_c_message_get_packed_size(message);
+  zmq_msg_t frame;
+
+  if (size <= INLINE_FRAME_SIZE) {
+    if (zmq_msg_init_size(&frame, size) != 0) {
+      return -1;
+    }
+    protobuf_c_message_pack(message, zmq_msg_data(&frame));
+  } else {
+    pooled_buffer *buffer = acquire_buffer(size);
+    if (!buffer) {
+      fprintf(stderr, "Failed to allocate a %zu byte frame\n", size);
+      return -1;
+    }
+    protobuf_c_message_pack(message, buffer_data(buffer));
+    if (zmq_msg_init_data(&frame, buffer_data(buffer), size, release_buffer, buffer) != 0) {
+      release_buffer(NULL, buffer);
+      return -1;
+    }
+  }
+
+  if (zmq_msg_send(&frame, fd, flags) < 0) {
+    zmq_msg_close(&frame);
+    return -1;
+  }
+  return (int)size;
+}
+
+// Receive one whole frame, whatever its size. frame must be closed with
+// zmq_msg_close afterwards, also when this fails
+static int receive_frame(void *fd, zmq_msg_t *frame, int flags) {
+  zmq_msg_init(frame);
+  return zmq_msg_recv(frame, fd, flags);
+}
+
+int wait_message(void *fd, int timeout_ms) {
+  zmq_pollitem_t item = {fd, 0, ZMQ_POLLIN, 0};
+  int ready = zmq_poll(&item, 1, timeout_ms);
+  if (ready < 0) {
+    return -1;
+  }
+  return (item.revents & ZMQ_POLLIN) ? 1 : 0;
+}
+
+int receive_message(void *fd, zmq_msg_t *frame) {
+  return receive_frame(fd, frame, 0);
+}
 
+void decode_message(const uint8_t *buffer, int size, client_request *request) {
+  memset(request, 0, sizeof(*request));
   if (size < 0) {
-    strcpy(message_type, "ERROR");
+    request->type = MSG_ERROR;
     return;
   }
 
-  MovementRequest *move_req = movement_request__unpack(NULL, size, buffer);
-  if (move_req != NULL && move_req->direction.len > 0) { 
-    strcpy(message_type, "MOVE");
-    *c = (move_req->letter.len > 0) ? move_req->letter.data[0] : '\0';
-    *direction = (direction_t)move_req->direction.data[0];
-    movement_request__free_unpacked(move_req, NULL);
+  decode_arena.used = 0;
+  ClientMessage *msg = client_message__unpack(&arena_allocator, size, buffer);
+  if (msg == NULL) {
+    request->type = MSG_UNKNOWN;
     return;
   }
-  if (move_req != NULL) {
-    movement_request__free_unpacked(move_req, NULL);
-  }
 
-  ConnectRequest *conn_req = connect_request__unpack(NULL, size, buffer);
-  if (conn_req != NULL) {
-    strcpy(message_type, "CONNECT");
-    *c = (conn_req->letter.len > 0) ? conn_req->letter.data[0] : '\0'; 
-    connect_request__free_unpacked(conn_req, NULL);
-    return;
+  switch (msg->payload_case) {
+  case CLIENT_MESSAGE__PAYLOAD_CONNECT:
+    request->type = MSG_CONNECT;
+    request->ship = msg->connect->ship_id;
+    request->seq = msg->connect->seq;
+    request->sent_ns = msg->connect->sent_ns;
+    break;
+  case CLIENT_MESSAGE__PAYLOAD_MOVE:
+    request->type = MSG_MOVE;
+    request->ship = msg->move->ship_id;
+    request->direction = (msg->move->direction.len > 0) ? (direction_t)msg->move->direction.data[0] : '\0';
+    request->token = msg->move->token;
+    request->seq = msg->move->seq;
+    request->sent_ns = msg->move->sent_ns;
+    break;
+  case CLIENT_MESSAGE__PAYLOAD_STATS:
+    request->type = MSG_STATS;
+    break;
+  case CLIENT_MESSAGE__PAYLOAD_DISCONNECT:
+    request->type = MSG_DISCONNECT;
+    request->ship = msg->disconnect->ship_id;
+    request->token = msg->disconnect->token;
+    break;
+  case CLIENT_MESSAGE__PAYLOAD_INPUT:
+    request->type = MSG_INPUT;
+    request->ship = msg->input->ship_id;
+    request->token = msg->input->token;
+    request->keys = msg->input->keys;
+    request->resync = msg->input->has_resync && msg->input->resync;
+    request->seq = msg->input->seq;
+    request->sent_ns = msg->input->sent_ns;
+    break;
+  default:
+    request->type = MSG_UNKNOWN;
+    break;
   }
+}
 
-  strcpy(message_type, "UNKNOWN");
+void read_message(void *fd, client_request *request) {
+  zmq_msg_t frame;
+  int size = receive_message(fd, &frame);
+  decode_message(zmq_msg_data(&frame), size, request);
+  zmq_msg_close(&frame);
 }
 
-void send_response(void *fd, char *message_type, char *message) {
-  uint8_t buffer[1024];
-  size_t packed_size;
+// Copy seq and sent_ns of the request being answered into its reply
+static void set_echo(ServerResponse *resp, const client_request *request) {
+  if (request->sent_ns != 0) {
+    resp->has_echo_seq = 1;
+    resp->echo_seq = request->seq;
+    resp->has_echo_sent_ns = 1;
+    resp->echo_sent_ns = request->sent_ns;
+  }
+}
 
+void send_response(void *fd, const client_request *request, int success) {
+  message_type_t message_type = request->type;
   ServerResponse resp = SERVER_RESPONSE__INIT;
+  set_echo(&resp, request);
 
-  if (strcmp(message_type, "CONNECT") == 0) {
+  if (message_type == MSG_CONNECT) {
     resp.type = SERVER_RESPONSE__RESPONSE_TYPE__CONNECT;
-    resp.success = (strcmp(message, "OK") == 0) ? 1 : 0;
-  } else if (strcmp(message_type, "MOVE") == 0) {
+    resp.success = success;
+  } else if (message_type == MSG_MOVE) {
     resp.type = SERVER_RESPONSE__RESPONSE_TYPE__MOVEMENT;
-    resp.success = (strcmp(message, "OK") == 0) ? 1 : 0;
+    resp.success = success;
+  } else if (message_type == MSG_DISCONNECT) {
+    resp.type = SERVER_RESPONSE__RESPONSE_TYPE__DISCONNECT;
+    resp.success = success;
+  } else if (message_type == MSG_INPUT) {
+    resp.type = SERVER_RESPONSE__RESPONSE_TYPE__INPUT;
+    resp.success = success;
   } else {
+    // Frames that could not be decoded are always refused
     resp.type = SERVER_RESPONSE__RESPONSE_TYPE__CONNECT;
-    resp.success = 1;
+    resp.success = 0;
+  }
+
+  send_packed(fd, &resp.base, 0);
+}
+
+void send_connect_response(void *fd, const client_request *request, int success, const session_info *info) {
+  ServerResponse resp = SERVER_RESPONSE__INIT;
+  set_echo(&resp, request);
+  resp.type = SERVER_RESPONSE__RESPONSE_TYPE__CONNECT;
+  resp.success = success;
+  if (success) {
+    resp.has_token = 1;
+    resp.token = info->token;
+    resp.has_tick_rate = 1;
+    resp.tick_rate = info->tick_rate;
+    resp.has_universe_width = 1;
+    resp.universe_width = info->universe_width;
+    resp.has_universe_height = 1;
+    resp.universe_height = info->universe_height;
+  }
+
+  send_packed(fd, &resp.base, 0);
+}
+
+void send_stats_response(void *fd, const latency_summary *summaries, int count) {
+  StageLatency rows[count > 0 ? count : 1];
+  StageLatency *row_ptrs[count > 0 ? count : 1];
+
+  for (int i = 0; i < count; i++) {
+    stage_latency__init(&rows[i]);
+    rows[i].command = (char *)summaries[i].command;
+    rows[i].stage = (char *)summaries[i].stage;
+    rows[i].count = summaries[i].count;
+    rows[i].p50_ns = summaries[i].p50_ns;
+    rows[i].p90_ns = summaries[i].p90_ns;
+    rows[i].p99_ns = summaries[i].p99_ns;
+    rows[i].max_ns = summaries[i].max_ns;
+    row_ptrs[i] = &rows[i];
   }
 
-  packed_size = server_response__pack(&resp, buffer);
-  zmq_send(fd, buffer, packed_size, 0);
+  ServerResponse resp = SERVER_RESPONSE__INIT;
+  resp.type = SERVER_RESPONSE__RESPONSE_TYPE__STATS;
+  resp.success = 1;
+  resp.n_stats = count;
+  resp.stats = row_ptrs;
+
+  send_packed(fd, &resp.base, 0);
+}
+
+void send_server_reply(void *fd, const server_reply *reply) {
+  if (reply->kind == REPLY_CONNECT) {
+    send_connect_response(fd, &reply->request, reply->success, &reply->info);
+  } else if (reply->kind == REPLY_STATS) {
+    send_stats_response(fd, reply->stats, reply->num_stats);
+  } else {
+    send_response(fd, &reply->request, reply->success);
+  }
 }
 
-void *create_client_channel(char *server_ip_addr) {
-  void *context = zmq_ctx_new();
-  void *requester = zmq_socket(context, ZMQ_REQ);
+void *create_client_channel(char *server_addr) {
+  void *requester = zmq_socket(get_comm_context(), ZMQ_REQ);
 
-  char server_zmq_addr[100];
-  sprintf(server_zmq_addr, "tcp://%s:5555", server_ip_addr);
+  // Full endpoints (tcp://, ipc://, inproc://) are used as given, a bare
+  // host name or IP address means the default TCP port
+  char server_zmq_addr[256];
+  if (strstr(server_addr, "://") != NULL) {
+    snprintf(server_zmq_addr, sizeof(server_zmq_addr), "%s", server_addr);
+  } else {
+    snprintf(server_zmq_addr, sizeof(server_zmq_addr), "tcp://%s:5555", server_addr);
+  }
 
   zmq_connect(requester, server_zmq_addr);
 
   return requester;
 }
 
-void send_connection_message(void *fd, char ch) {
+void send_connection_message(void *fd, ship_id ship, uint32_t seq) {
   ConnectRequest req = CONNECT_REQUEST__INIT;
-  req.letter.data = (uint8_t *)&ch;
-  req.letter.len = 1;
-  uint8_t buffer[1024];
-  size_t packed_size = connect_request__pack(&req, buffer);
-  zmq_send(fd, buffer, packed_size, 0);
+  req.ship_id = ship;
+  req.has_seq = 1;
+  req.seq = seq;
+
+  ClientMessage msg = CLIENT_MESSAGE__INIT;
+  msg.payload_case = CLIENT_MESSAGE__PAYLOAD_CONNECT;
+  msg.connect = &req;
+  // Stamped last, the round trip starts when the request is packed
+  req.has_sent_ns = 1;
+  req.sent_ns = latency_now_ns();
+
+  send_packed(fd, &msg.base, 0);
 }
 
-void send_movement_message(void *fd, char ch, direction_t direction) {
+void send_movement_message(void *fd, ship_id ship, uint32_t token, direction_t direction, uint32_t seq) {
   MovementRequest req = MOVEMENT_REQUEST__INIT;
-  req.letter.data = (uint8_t *)&ch;
-  req.letter.len = 1;
+  req.ship_id = ship;
   req.direction.data = (uint8_t *)&direction;
   req.direction.len = 1;
+  req.token = token;
+  req.has_seq = 1;
+  req.seq = seq;
+
+  ClientMessage msg = CLIENT_MESSAGE__INIT;
+  msg.payload_case = CLIENT_MESSAGE__PAYLOAD_MOVE;
+  msg.move = &req;
+  req.has_sent_ns = 1;
+  req.sent_ns = latency_now_ns();
+
+  send_packed(fd, &msg.base, 0);
+}
+
+void send_disconnect_message(void *fd, ship_id ship, uint32_t token) {
+  DisconnectRequest req = DISCONNECT_REQUEST__INIT;
+  req.ship_id = ship;
+  req.token = token;
+
+  ClientMessage msg = CLIENT_MESSAGE__INIT;
+  msg.payload_case = CLIENT_MESSAGE__PAYLOAD_DISCONNECT;
+  msg.disconnect = &req;
+
+  send_packed(fd, &msg.base, 0);
+}
+
+void send_input_message(void *fd, ship_id ship, uint32_t token, uint32_t keys, uint32_t seq, int resync) {
+  InputRequest req = INPUT_REQUEST__INIT;
+  req.ship_id = ship;
+  req.token = token;
+  req.keys = keys;
+  req.has_seq = 1;
+  req.seq = seq;
+  if (resync) {
+    req.has_resync = 1;
+    req.resync = 1;
+  }
 
-  uint8_t buffer[1024];
-  size_t packed_size = movement_request__pack(&req, buffer);
-  zmq_send(fd, buffer, packed_size, 0);
+  ClientMessage msg = CLIENT_MESSAGE__INIT;
+  msg.payload_case = CLIENT_MESSAGE__PAYLOAD_INPUT;
+  msg.input = &req;
+  req.has_sent_ns = 1;
+  req.sent_ns = latency_now_ns();
+
+  send_packed(fd, &msg.base, 0);
 }
 
-void receive_response(void *fd, char *message) {
-  uint8_t buffer[1024];
-  int size = zmq_recv(fd, buffer, sizeof(buffer), 0);
+static void read_echo(const ServerResponse *resp, request_echo *echo) {
+  if (echo == NULL) {
+    return;
+  }
+  echo->valid = resp->has_echo_sent_ns;
+  echo->seq = resp->echo_seq;
+  echo->sent_ns = resp->echo_sent_ns;
+}
+
+void receive_response(void *fd, char *message, request_echo *echo) {
+  if (echo) {
+    memset(echo, 0, sizeof(*echo));
+  }
+  zmq_msg_t frame;
+  int size = receive_frame(fd, &frame, 0);
 
   if (size < 0) {
+    zmq_msg_close(&frame);
     strcpy(message, "ERROR");
     return;
   }
 
-  ServerResponse *resp = server_response__unpack(NULL, size, buffer);
+  ServerResponse *resp = server_response__unpack(NULL, size, zmq_msg_data(&frame));
+  zmq_msg_close(&frame);
   if (resp != NULL) {
+    read_echo(resp, echo);
     if (resp->type == SERVER_RESPONSE__RESPONSE_TYPE__CONNECT) {
       strcpy(message, resp->success ? "OK" : "NOT OK");
     }else if(resp->type == SERVER_RESPONSE__RESPONSE_TYPE__MOVEMENT){
       strcpy(message, resp->success ? "OK" : "BAD MOVEMENT");
+    }else if(resp->type == SERVER_RESPONSE__RESPONSE_TYPE__DISCONNECT ||
+             resp->type == SERVER_RESPONSE__RESPONSE_TYPE__INPUT){
+      strcpy(message, resp->success ? "OK" : "NOT OK");
     }else {
       strcpy(message, "UNKNOWN");
     }
@@ -135,4 +496,507 @@ void receive_response(void *fd, char *message) {
   }
 
   strcpy(message, "UNKNOWN");
-}
\ No newline at end of file
+}
+
+void receive_connect_response(void *fd, char *message, session_info *info, request_echo *echo) {
+  zmq_msg_t frame;
+  int size = receive_frame(fd, &frame, 0);
+  memset(info, 0, sizeof(*info));
+  if (echo) {
+    memset(echo, 0, sizeof(*echo));
+  }
+
+  if (size < 0) {
+    zmq_msg_close(&frame);
+    strcpy(message, "ERROR");
+    return;
+  }
+
+  ServerResponse *resp = server_response__unpack(NULL, size, zmq_msg_data(&frame));
+  zmq_msg_close(&frame);
+  if (resp == NULL || resp->type != SERVER_RESPONSE__RESPONSE_TYPE__CONNECT) {
+    server_response__free_unpacked(resp, NULL);
+    strcpy(message, "UNKNOWN");
+    return;
+  }
+
+  read_echo(resp, echo);
+  if (resp->success && resp->has_token) {
+    info->token = resp->token;
+    info->tick_rate = resp->tick_rate;
+    info->universe_width = resp->universe_width;
+    info->universe_height = resp->universe_height;
+    strcpy(message, "OK");
+  } else {
+    strcpy(message, "NOT OK");
+  }
+  server_response__free_unpacked(resp, NULL);
+}
+
+void send_stats_request(void *fd) {
+  StatsRequest req = STATS_REQUEST__INIT;
+
+  ClientMessage msg = CLIENT_MESSAGE__INIT;
+  msg.payload_case = CLIENT_MESSAGE__PAYLOAD_STATS;
+  msg.stats = &req;
+
+  send_packed(fd, &msg.base, 0);
+}
+
+int receive_stats(void *fd, latency_summary *summaries, int max_summaries) {
+  zmq_msg_t frame;
+  int size = receive_frame(fd, &frame, 0);
+  ServerResponse *resp = size < 0 ? NULL : server_response__unpack(NULL, size, zmq_msg_data(&frame));
+  zmq_msg_close(&frame);
+  if (resp == NULL || resp->type != SERVER_RESPONSE__RESPONSE_TYPE__STATS) {
+    server_response__free_unpacked(resp, NULL);
+    return -1;
+  }
+
+  int count = 0;
+  for (size_t i = 0; i < resp->n_stats && count < max_summaries; i++) {
+    StageLatency *row = resp->stats[i];
+    latency_summary *s = &summaries[count++];
+    snprintf(s->command, sizeof(s->command), "%s", row->command);
+    snprintf(s->stage, sizeof(s->stage), "%s", row->stage);
+    s->count = row->count;
+    s->p50_ns = row->p50_ns;
+    s->p90_ns = row->p90_ns;
+    s->p99_ns = row->p99_ns;
+    s->max_ns = row->max_ns;
+  }
+  server_response__free_unpacked(resp, NULL);
+  return count;
+}
+
+void *create_update_publisher(const char **endpoints, int num_endpoints) {
+  void *publisher = zmq_socket(get_comm_context(), ZMQ_PUB);
+
+  for (int i = 0; i < num_endpoints; i++) {
+    if (zmq_bind(publisher, endpoints[i]) != 0) {
+      fprintf(stderr, "Failed to bind %s: %s\n", endpoints[i], zmq_strerror(zmq_errno()));
+      zmq_close(publisher);
+      return NULL;
+    }
+    printf("Publishing world updates on %s\n", endpoints[i]);
+  }
+  return publisher;
+}
+
+// Topic frame of the updates of a ship
+static void ship_topic(ship_id ship, uint8_t topic[4]) {
+  topic[0] = (uint8_t)(ship >> 24);
+  topic[1] = (uint8_t)(ship >> 16);
+  topic[2] = (uint8_t)(ship >> 8);
+  topic[3] = (uint8_t)ship;
+}
+
+void *create_update_subscriber(char *update_addr, ship_id ship) {
+  void *subscriber = zmq_socket(get_comm_context(), ZMQ_SUB);
+
+  char update_zmq_addr[256];
+  if (strstr(update_addr, "://") != NULL) {
+    snprintf(update_zmq_addr, sizeof(update_zmq_addr), "%s", update_addr);
+  } else {
+    snprintf(update_zmq_addr, sizeof(update_zmq_addr), "tcp://%s:5556", update_addr);
+  }
+
+  // Only the updates of our own ship, filtered by the publisher
+  uint8_t topic[4];
+  ship_topic(ship, topic);
+  zmq_setsockopt(subscriber, ZMQ_SUBSCRIBE, topic, sizeof(topic));
+  zmq_connect(subscriber, update_zmq_addr);
+
+  return subscriber;
+}
+
+// Entity arrays are converted into one block of protobuf structs that is
+// kept between calls, so publishing does not allocate once it has grown
+static EntityState *entity_rows = NULL;
+static EntityState **entity_row_ptrs = NULL;
+static size_t max_entity_rows = 0;
+
+static void fill_entity_rows(EntityState *rows, EntityState **ptrs, const entity_state *entities, int count) {
+  for (int i = 0; i < count; i++) {
+    entity_state__init(&rows[i]);
+    rows[i].id = entities[i].id;
+    rows[i].kind = entities[i].kind;
+    rows[i].x = entities[i].x;
+    rows[i].y = entities[i].y;
+    if (entities[i].name != 0) {
+      rows[i].has_name = 1;
+      rows[i].name.data = (uint8_t *)&entities[i].name;
+      rows[i].name.len = 1;
+    }
+    if (entities[i].ship != SHIP_ID_NONE) {
+      rows[i].has_ship_id = 1;
+      rows[i].ship_id = entities[i].ship;
+    }
+    ptrs[i] = &rows[i];
+  }
+}
+
+int send_world_update(void *fd, ship_id ship, const world_update *update) {
+  size_t rows = (size_t)update->num_entered + update->num_moved;
+  if (rows > max_entity_rows) {
+    EntityState *new_rows = realloc(entity_rows, sizeof(EntityState) * rows);
+    EntityState **new_ptrs = realloc(entity_row_ptrs, sizeof(EntityState *) * rows);
+    if (new_rows) entity_rows = new_rows;
+    if (new_ptrs) entity_row_ptrs = new_ptrs;
+    if (!new_rows || !new_ptrs) {
+      fprintf(stderr, "Failed to allocate world update\n");
+      return -1;
+    }
+    max_entity_rows = rows;
+  }
+  fill_entity_rows(entity_rows, entity_row_ptrs, update->entered, update->num_entered);
+  fill_entity_rows(entity_rows + update->num_entered, entity_row_ptrs + update->num_entered,
+                   update->moved, update->num_moved);
+
+  WorldUpdate msg = WORLD_UPDATE__INIT;
+  msg.tick = update->tick;
+  msg.seq = update->seq;
+  msg.has_ack_seq = 1;
+  msg.ack_seq = update->ack_seq;
+  msg.has_ack_ticks = 1;
+  msg.ack_ticks = update->ack_ticks;
+  msg.full = update->full;
+  msg.n_entered = update->num_entered;
+  msg.entered = entity_row_ptrs;
+  msg.n_moved = update->num_moved;
+  msg.moved = entity_row_ptrs + update->num_entered;
+  msg.n_left = update->num_left;
+  msg.left = update->left;
+
+  // PUB never blocks, updates for a subscriber that falls behind are dropped
+  // and show up on its side as a gap in seq
+  uint8_t topic[4];
+  ship_topic(ship, topic);
+  zmq_send(fd, topic, sizeof(topic), ZMQ_SNDMORE);
+  return send_packed(fd, &msg.base, 0);
+}
+
+// Make room for count entries in one of the receive arrays
+static int reserve(void **array, int *capacity, int count, size_t size) {
+  if (count <= *capacity) {
+    return 0;
+  }
+  void *grown = realloc(*array, size * count);
+  if (!grown) {
+    fprintf(stderr, "Failed to allocate world update\n");
+    return -1;
+  }
+  *array = grown;
+  *capacity = count;
+  return 0;
+}
+
+static void read_entity_rows(entity_state *entities, EntityState **rows, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    entities[i].id = rows[i]->id;
+    entities[i].kind = (uint8_t)rows[i]->kind;
+    entities[i].name = (rows[i]->has_name && rows[i]->name.len > 0) ? (char)rows[i]->name.data[0] : 0;
+    entities[i].ship = rows[i]->has_ship_id ? rows[i]->ship_id : SHIP_ID_NONE;
+    entities[i].x = rows[i]->x;
+    entities[i].y = rows[i]->y;
+  }
+}
+
+int receive_world_update(void *fd, world_update *update) {
+  uint8_t topic[4];
+  if (zmq_recv(fd, topic, sizeof(topic), ZMQ_DONTWAIT) < 0) {
+    return zmq_errno() == EAGAIN ? 0 : -1;
+  }
+
+  zmq_msg_t frame;
+  if (receive_frame(fd, &frame, 0) < 0) {
+    zmq_msg_close(&frame);
+    return -1;
+  }
+  WorldUpdate *msg = world_update__unpack(NULL, zmq_msg_size(&frame), zmq_msg_data(&frame));
+  zmq_msg_close(&frame);
+  if (msg == NULL) {
+    return -1;
+  }
+
+  int result = -1;
+  if (reserve((void **)&update->entered, &update->max_entered, msg->n_entered, sizeof(entity_state)) == 0 &&
+      reserve((void **)&update->moved, &update->max_moved, msg->n_moved, sizeof(entity_state)) == 0 &&
+      reserve((void **)&update->left, &update->max_left, msg->n_left, sizeof(uint64_t)) == 0) {
+    update->tick = msg->tick;
+    update->seq = msg->seq;
+    update->full = msg->full;
+    update->ack_seq = msg->ack_seq;
+    update->ack_ticks = msg->ack_ticks;
+    update->num_entered = msg->n_entered;
+    update->num_moved = msg->n_moved;
+    update->num_left = msg->n_left;
+    read_entity_rows(update->entered, msg->entered, msg->n_entered);
+    read_entity_rows(update->moved, msg->moved, msg->n_moved);
+    if (msg->n_left > 0) {
+      memcpy(update->left, msg->left, sizeof(uint64_t) * msg->n_left);
+    }
+    result = 1;
+  }
+  world_update__free_unpacked(msg, NULL);
+  return result;
+}
+
+void world_update_free(world_update *update) {
+  free(update->entered);
+  free(update->moved);
+  free(update->left);
+  memset(update, 0, sizeof(*update));
+}
+
+int world_update_copy(world_update *to, const world_update *from) {
+  if (reserve((void **)&to->entered, &to->max_entered, from->num_entered, sizeof(entity_state)) != 0 ||
+      reserve((void **)&to->moved, &to->max_moved, from->num_moved, sizeof(entity_state)) != 0 ||
+      reserve((void **)&to->left, &to->max_left, from->num_left, sizeof(uint64_t)) != 0) {
+    return -1;
+  }
+  to->tick = from->tick;
+  to->seq = from->seq;
+  to->full = from->full;
+  to->ack_seq = from->ack_seq;
+  to->ack_ticks = from->ack_ticks;
+  to->num_entered = from->num_entered;
+  to->num_moved = from->num_moved;
+  to->num_left = from->num_left;
+  if (from->num_entered > 0) {
+    memcpy(to->entered, from->entered, sizeof(entity_state) * from->num_entered);
+  }
+  if (from->num_moved > 0) {
+    memcpy(to->moved, from->moved, sizeof(entity_state) * from->num_moved);
+  }
+  if (from->num_left > 0) {
+    memcpy(to->left, from->left, sizeof(uint64_t) * from->num_left);
+  }
+  return 0;
+}
+
+// ===== Shards =====
+
+void *create_shard_inbox(const char *endpoint) {
+  void *inbox = zmq_socket(get_comm_context(), ZMQ_PULL);
+  if (zmq_bind(inbox, endpoint) != 0) {
+    fprintf(stderr, "Failed to bind %s: %s\n", endpoint, zmq_strerror(zmq_errno()));
+    zmq_close(inbox);
+    return NULL;
+  }
+  return inbox;
+}
+
+void *create_shard_outbox(const char *endpoint) {
+  void *outbox = zmq_socket(get_comm_context(), ZMQ_PUSH);
+  // Whatever is still queued for a peer that went away is dropped on close
+  int linger = 0;
+  zmq_setsockopt(outbox, ZMQ_LINGER, &linger, sizeof(linger));
+  if (zmq_connect(outbox, endpoint) != 0) {
+    fprintf(stderr, "Failed to connect %s: %s\n", endpoint, zmq_strerror(zmq_errno()));
+    zmq_close(outbox);
+    return NULL;
+  }
+  return outbox;
+}
+
+int shard_handoff_add_ship(shard_handoff *handoff, const handoff_ship *ship) {
+  if (handoff->num_ships == handoff->max_ships &&
+      reserve((void **)&handoff->ships, &handoff->max_ships,
+              handoff->max_ships > 0 ? handoff->max_ships * 2 : 16, sizeof(handoff_ship)) != 0) {
+    return -1;
+  }
+  handoff->ships[handoff->num_ships++] = *ship;
+  return 0;
+}
+
+int shard_handoff_add_trash(shard_handoff *handoff, const handoff_trash *trash) {
+  if (handoff->num_trash == handoff->max_trash &&
+      reserve((void **)&handoff->trash, &handoff->max_trash,
+              handoff->max_trash > 0 ? handoff->max_trash * 2 : 64, sizeof(handoff_trash)) != 0) {
+    return -1;
+  }
+  handoff->trash[handoff->num_trash++] = *trash;
+  return 0;
+}
+
+int shard_handoff_add_relayed(shard_handoff *handoff, const uint8_t *frame, int size) {
+  int bytes = handoff->relayed_bytes + size;
+  if ((bytes > handoff->max_relayed_bytes &&
+       reserve((void **)&handoff->relayed, &handoff->max_relayed_bytes,
+               bytes > 512 ? bytes * 2 : 1024, 1) != 0) ||
+      (handoff->num_relayed == handoff->max_relayed &&
+       reserve((void **)&handoff->relayed_sizes, &handoff->max_relayed,
+               handoff->max_relayed > 0 ? handoff->max_relayed * 2 : 16, sizeof(int)) != 0)) {
+    return -1;
+  }
+  memcpy(handoff->relayed + handoff->relayed_bytes, frame, size);
+  handoff->relayed_bytes = bytes;
+  handoff->relayed_sizes[handoff->num_relayed++] = size;
+  return 0;
+}
+
+int shard_handoff_is_empty(const shard_handoff *handoff) {
+  return handoff->num_ships == 0 && handoff->num_trash == 0 && handoff->num_relayed == 0;
+}
+
+void shard_handoff_clear(shard_handoff *handoff) {
+  handoff->num_ships = 0;
+  handoff->num_trash = 0;
+  handoff->num_relayed = 0;
+  handoff->relayed_bytes = 0;
+}
+
+void shard_handoff_free(shard_handoff *handoff) {
+  free(handoff->ships);
+  free(handoff->trash);
+  free(handoff->relayed);
+  free(handoff->relayed_sizes);
+  free(handoff->ship_rows);
+  free(handoff->trash_rows);
+  free(handoff->row_ptrs);
+  free(handoff->relayed_rows);
+  memset(handoff, 0, sizeof(*handoff));
+}
+
+int send_shard_handoff(void *fd, shard_handoff *handoff) {
+  int num_rows = handoff->num_ships + handoff->num_trash;
+  if (reserve(&handoff->ship_rows, &handoff->max_ship_rows, handoff->num_ships, sizeof(ShardShip)) != 0 ||
+      reserve(&handoff->trash_rows, &handoff->max_trash_rows, handoff->num_trash, sizeof(ShardTrash)) != 0 ||
+      reserve((void **)&handoff->row_ptrs, &handoff->max_row_ptrs, num_rows, sizeof(void *)) != 0 ||
+      reserve(&handoff->relayed_rows, &handoff->max_relayed_rows, handoff->num_relayed,
+              sizeof(ProtobufCBinaryData)) != 0) {
+    return -1;
+  }
+  ShardShip *ships = handoff->ship_rows;
+  ShardTrash *trash = handoff->trash_rows;
+  void **rows = handoff->row_ptrs;
+  ProtobufCBinaryData *relayed = handoff->relayed_rows;
+
+  for (int i = 0; i < handoff->num_ships; i++) {
+    const handoff_ship *ship = &handoff->ships[i];
+    shard_ship__init(&ships[i]);
+    ships[i].ship_id = ship->id;
+    ships[i].x = ship->x;
+    ships[i].y = ship->y;
+    ships[i].has_token = 1;
+    ships[i].token = ship->token;
+    ships[i].has_bot = 1;
+    ships[i].bot = ship->bot;
+    ships[i].has_cargo = 1;
+    ships[i].cargo = ship->cargo;
+    ships[i].has_input_keys = 1;
+    ships[i].input_keys = ship->input_keys;
+    ships[i].has_input_seq = 1;
+    ships[i].input_seq = ship->input_seq;
+    ships[i].has_input_ticks = 1;
+    ships[i].input_ticks = ship->input_ticks;
+    rows[i] = &ships[i];
+  }
+  for (int i = 0; i < handoff->num_trash; i++) {
+    shard_trash__init(&trash[i]);
+    trash[i].x = handoff->trash[i].x;
+    trash[i].y = handoff->trash[i].y;
+    trash[i].speed = handoff->trash[i].speed;
+    trash[i].angle = handoff->trash[i].angle;
+    rows[handoff->num_ships + i] = &trash[i];
+  }
+  int offset = 0;
+  for (int i = 0; i < handoff->num_relayed; i++) {
+    relayed[i].data = handoff->relayed + offset;
+    relayed[i].len = handoff->relayed_sizes[i];
+    offset += handoff->relayed_sizes[i];
+  }
+
+  ShardHandoff msg = SHARD_HANDOFF__INIT;
+  msg.n_ships = handoff->num_ships;
+  msg.ships = (ShardShip **)rows;
+  msg.n_trash = handoff->num_trash;
+  msg.trash = (ShardTrash **)(rows + handoff->num_ships);
+  msg.n_relayed = handoff->num_relayed;
+  msg.relayed = relayed;
+
+  // A shard that is not up yet gets its handoffs queued, never wait for it
+  return send_packed(fd, &msg.base, ZMQ_DONTWAIT);
+}
+
+int receive_shard_handoff(void *fd, shard_handoff *handoff) {
+  zmq_msg_t frame;
+  if (receive_frame(fd, &frame, ZMQ_DONTWAIT) < 0) {
+    zmq_msg_close(&frame);
+    return zmq_errno() == EAGAIN ? 0 : -1;
+  }
+  ShardHandoff *msg = shard_handoff__unpack(NULL, zmq_msg_size(&frame), zmq_msg_data(&frame));
+  zmq_msg_close(&frame);
+  if (msg == NULL) {
+    return -1;
+  }
+
+  int result = 1;
+  shard_handoff_clear(handoff);
+  for (size_t i = 0; i < msg->n_ships && result == 1; i++) {
+    ShardShip *row = msg->ships[i];
+    handoff_ship ship = {
+      .id = row->ship_id,
+      .bot = row->bot,
+      .x = row->x,
+      .y = row->y,
+      .token = row->token,
+      .cargo = row->cargo,
+      .input_keys = row->input_keys,
+      .input_seq = row->input_seq,
+      .input_ticks = row->input_ticks
+    };
+    if (shard_handoff_add_ship(handoff, &ship) != 0) result = -1;
+  }
+  for (size_t i = 0; i < msg->n_trash && result == 1; i++) {
+    handoff_trash trash = {msg->trash[i]->x, msg->trash[i]->y, msg->trash[i]->speed, msg->trash[i]->angle};
+    if (shard_handoff_add_trash(handoff, &trash) != 0) result = -1;
+  }
+  for (size_t i = 0; i < msg->n_relayed && result == 1; i++) {
+    if (shard_handoff_add_relayed(handoff, msg->relayed[i].data, (int)msg->relayed[i].len) != 0) result = -1;
+  }
+  shard_handoff__free_unpacked(msg, NULL);
+  return result;
+}
+
+int send_shard_notice(void *fd, ship_id ship, int shard) {
+  ShardNotice msg = SHARD_NOTICE__INIT;
+  msg.ship_id = ship;
+  msg.shard = shard;
+  return send_packed(fd, &msg.base, ZMQ_DONTWAIT);
+}
+
+int receive_shard_notice(void *fd, ship_id *ship, int *shard) {
+  zmq_msg_t frame;
+  if (receive_frame(fd, &frame, ZMQ_DONTWAIT) < 0) {
+    zmq_msg_close(&frame);
+    return zmq_errno() == EAGAIN ? 0 : -1;
+  }
+  decode_arena.used = 0;
+  ShardNotice *msg = shard_notice__unpack(&arena_allocator, zmq_msg_size(&frame), zmq_msg_data(&frame));
+  zmq_msg_close(&frame);
+  if (msg == NULL) {
+    return -1;
+  }
+  *ship = msg->ship_id;
+  *shard = msg->shard;
+  return 1;
+}
+
+int forward_message(void *from, void *to) {
+  zmq_msg_t frame;
+  int more;
+  do {
+    if (receive_frame(from, &frame, 0) < 0) {
+      zmq_msg_close(&frame);
+      return -1;
+    }
+    more = zmq_msg_more(&frame);
+    if (zmq_msg_send(&frame, to, more ? ZMQ_SNDMORE : 0) < 0) {
+      zmq_msg_close(&frame);
+      return -1;
+    }
+  } while (more);
+  return 0;
+}
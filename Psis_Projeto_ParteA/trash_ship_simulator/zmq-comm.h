@@ -1,4 +1,10 @@
+#ifndef ZMQ_COMM_H
+#define ZMQ_COMM_H
+
 #include <zmq.h>
+#include <stdint.h>
+#include "latency-stats.h"
+#include "ship-id.h"
 
 typedef char direction_t;
 
@@ -7,11 +13,227 @@ typedef char direction_t;
 #define LEFT 'l'
 #define RIGHT 'r'
 
+// Direction keys held by a player, sent as a bitmask in input requests
+#define INPUT_UP    0x1
+#define INPUT_DOWN  0x2
+#define INPUT_LEFT  0x4
+#define INPUT_RIGHT 0x8
+#define INPUT_ALL   (INPUT_UP | INPUT_DOWN | INPUT_LEFT | INPUT_RIGHT)
+
+// Kind of request decoded from a client envelope
+typedef enum {
+  MSG_ERROR,    // nothing received (timeout or socket error)
+  MSG_UNKNOWN,  // frame could not be decoded
+  MSG_CONNECT,
+  MSG_MOVE,
+  MSG_STATS,    // latency histogram query
+  MSG_DISCONNECT,
+  MSG_INPUT     // held keys changed
+} message_type_t;
+
+// One decoded client request, fields not carried by its type are left zero
+typedef struct {
+  message_type_t type;
+  ship_id ship;         // all but STATS, SHIP_ID_NONE if missing
+  direction_t direction;
+  uint32_t token;       // session token, all ship requests except CONNECT
+  uint32_t keys;        // INPUT only, INPUT_* bits
+  int resync;           // INPUT only, the client lost world updates
+  uint32_t seq;         // CONNECT, MOVE, INPUT: client numbering of its requests
+  uint64_t sent_ns;     // CONNECT, MOVE, INPUT: client clock when sent, 0 if unknown
+} client_request;
+
+// The seq and sent_ns of a request, echoed back in its reply so the client
+// measures the round trip it really sees, queueing included
+typedef struct {
+  int valid;            // the reply carried an echo
+  uint32_t seq;
+  uint64_t sent_ns;     // latency_now_ns() of the client when it sent the request
+} request_echo;
+
+// What an accepted client needs to know about its session
+typedef struct {
+  uint32_t token;       // proves the ship is ours, sent with every request
+  uint32_t tick_rate;   // server ticks per second, each moves the ship one pixel per held key
+  int32_t universe_width;
+  int32_t universe_height;
+} session_info;
+
+// Kind of an entity in a world update
+typedef enum {
+  ENTITY_PLANET,
+  ENTITY_TRASH,
+  ENTITY_SHIP
+} entity_kind;
+
+// One entity as seen by a client
+typedef struct {
+  uint64_t id;          // unique while the entity exists (see interest-region.h)
+  uint8_t kind;         // entity_kind
+  char name;            // planets, 0 for the rest
+  ship_id ship;         // ships, SHIP_ID_NONE for the rest
+  int32_t x;
+  int32_t y;
+} entity_state;
+
+// What changed in the interest region of one ship since its last update
+typedef struct {
+  uint32_t tick;
+  uint32_t seq;         // per ship, increments by one with every update sent
+  int full;             // entered lists the whole region, drop everything else
+  uint32_t ack_seq;     // last input of the ship the server applied
+  uint32_t ack_ticks;   // ticks the ship moved since then (with those keys held)
+  entity_state *entered;  // came into the region, full state
+  int num_entered;
+  entity_state *moved;    // already known, new position
+  int num_moved;
+  uint64_t *left;         // ids that left the region or no longer exist
+  int num_left;
+  int max_entered;      // receive side: allocated array sizes
+  int max_moved;
+  int max_left;
+} world_update;
+
+// Kind of answer to one request
+typedef enum {
+  REPLY_RESULT,   // send_response
+  REPLY_CONNECT,  // send_connect_response
+  REPLY_STATS     // send_stats_response
+} reply_kind;
+
+// The answer to one request, decided by the game and sent by send_server_reply,
+// so deciding and encoding it can happen on different threads
+typedef struct {
+  reply_kind kind;
+  client_request request;         // echoed back
+  int success;
+  session_info info;              // REPLY_CONNECT, when successful
+  const latency_summary *stats;   // REPLY_STATS rows
+  int num_stats;
+} server_reply;
+
+// A ship handed to the shard whose strip it entered (see shard-map.h)
+typedef struct {
+  ship_id id;
+  int bot;              // flown by the server, no session
+  float x;
+  float y;
+  uint32_t token;       // session token of its client
+  uint32_t cargo;       // trash pieces carried
+  uint32_t input_keys;  // held keys, the input that set them and ticks since
+  uint32_t input_seq;
+  uint32_t input_ticks;
+} handoff_ship;
+
+// Trash handed to the shard whose strip it drifted into
+typedef struct {
+  float x;
+  float y;
+  float speed;
+  float angle;
+} handoff_trash;
+
+// Everything one shard hands another after a tick. The arrays grow as
+// needed and are kept when cleared, release them with shard_handoff_free.
+typedef struct {
+  handoff_ship *ships;
+  int num_ships;
+  int max_ships;
+  handoff_trash *trash;
+  int num_trash;
+  int max_trash;
+  uint8_t *relayed;     // client request frames, back to back
+  int relayed_bytes;
+  int max_relayed_bytes;
+  int *relayed_sizes;   // size of each of them
+  int num_relayed;
+  int max_relayed;
+  // Protobuf rows send_shard_handoff packs the arrays above into, kept
+  // between sends like them
+  void *ship_rows;
+  int max_ship_rows;
+  void *trash_rows;
+  int max_trash_rows;
+  void **row_ptrs;
+  int max_row_ptrs;
+  void *relayed_rows;
+  int max_relayed_rows;
+} shard_handoff;
+
 #define FIFO_NAME "/tmp/fifo_snail"
 void *create_client_channel(char *server_addr);
-void read_message(void *fd, char *message_type, char *c, direction_t *direction);
-void send_response(void *fd, char *message_type, char *message);
-void *create_server_channel();
-void send_connection_message(void *fd, char ch);
-void send_movement_message(void *fd, char ch, direction_t direction);
-void receive_response(void *fd, char *message);
\ No newline at end of file
+void read_message(void *fd, client_request *request);
+// Wait up to timeout_ms for a request, returns 1 if one is ready, 0 if not, -1 on error
+int wait_message(void *fd, int timeout_ms);
+// read_message split in its two stages, so the server can time each one.
+// receive_message takes the whole frame whatever its size and returns that
+// size, or -1 on error; close frame with zmq_msg_close after decoding it
+int receive_message(void *fd, zmq_msg_t *frame);
+void decode_message(const uint8_t *buffer, int size, client_request *request);
+// Replies echo the seq and sent_ns of request
+void send_response(void *fd, const client_request *request, int success);
+// Accepted connections get the session info, info is ignored when refused
+void send_connect_response(void *fd, const client_request *request, int success, const session_info *info);
+void *get_comm_context();
+void *create_server_channel(const char **endpoints, int num_endpoints);
+// create_server_channel as a ROUTER, which may have many requests in flight
+// and answer them in any order: every request comes after its envelope frames
+void *create_server_router(const char **endpoints, int num_endpoints);
+// Requests are stamped with latency_now_ns() when sent
+void send_connection_message(void *fd, ship_id ship, uint32_t seq);
+void send_movement_message(void *fd, ship_id ship, uint32_t token, direction_t direction, uint32_t seq);
+void send_disconnect_message(void *fd, ship_id ship, uint32_t token);
+void send_input_message(void *fd, ship_id ship, uint32_t token, uint32_t keys, uint32_t seq, int resync);
+// echo (may be NULL) gets what the reply echoed of its request
+void receive_response(void *fd, char *message, request_echo *echo);
+// receive_response for the connect reply, also stores the session info
+void receive_connect_response(void *fd, char *message, session_info *info, request_echo *echo);
+void send_stats_response(void *fd, const latency_summary *summaries, int count);
+void send_stats_request(void *fd);
+// Encode and send reply with the matching send_*_response
+void send_server_reply(void *fd, const server_reply *reply);
+// Returns the number of rows stored in summaries, or -1 on error
+int receive_stats(void *fd, latency_summary *summaries, int max_summaries);
+
+// World updates: the server publishes one update per ship, the topic is the
+// ship id in 4 bytes, big endian
+void *create_update_publisher(const char **endpoints, int num_endpoints);
+// update_addr is a host name/IP (port 5556) or a full zmq endpoint
+void *create_update_subscriber(char *update_addr, ship_id ship);
+// Returns the encoded size in bytes, or -1 on error
+int send_world_update(void *fd, ship_id ship, const world_update *update);
+// Read one pending update without blocking. The arrays of update grow as
+// needed, release them with world_update_free.
+// Returns 1 if an update was read, 0 if none is waiting, -1 on error
+int receive_world_update(void *fd, world_update *update);
+void world_update_free(world_update *update);
+// Copy from into to, whose arrays grow as needed like receive_world_update's
+// Returns 0 on success, -1 if an array could not grow
+int world_update_copy(world_update *to, const world_update *from);
+
+// Shards: each binds an inbox other shards push handoffs to, and tells the
+// front-end on the notice endpoint where players' ships are
+void *create_shard_inbox(const char *endpoint);
+void *create_shard_outbox(const char *endpoint);
+// Returns 0 on success, -1 if an array could not grow
+int shard_handoff_add_ship(shard_handoff *handoff, const handoff_ship *ship);
+int shard_handoff_add_trash(shard_handoff *handoff, const handoff_trash *trash);
+int shard_handoff_add_relayed(shard_handoff *handoff, const uint8_t *frame, int size);
+int shard_handoff_is_empty(const shard_handoff *handoff);
+void shard_handoff_clear(shard_handoff *handoff);
+void shard_handoff_free(shard_handoff *handoff);
+// Never blocks. Returns the encoded size in bytes, or -1 on error
+int send_shard_handoff(void *fd, shard_handoff *handoff);
+// Read one pending handoff without blocking, replacing the contents of handoff
+// Returns 1 if one was read, 0 if none is waiting, -1 on error
+int receive_shard_handoff(void *fd, shard_handoff *handoff);
+// shard is the new owner of the ship, -1 once it left the universe
+int send_shard_notice(void *fd, ship_id ship, int shard);
+// Returns 1 if a notice was read, 0 if none is waiting, -1 on error
+int receive_shard_notice(void *fd, ship_id *ship, int *shard);
+
+// Move one whole message, every frame of it, from one socket to another
+// Returns 0 on success, -1 on error
+int forward_message(void *from, void *to);
+
+#endif // ZMQ_COMM_H